@@ -40,6 +40,8 @@ Action::Action()
 :_originalTarget(nullptr)
 ,_target(nullptr)
 ,_tag(Action::INVALID_TAG)
+,_batchKind(-1)
+,_batchIndex(-1)
 {
 }
 
@@ -112,6 +112,11 @@ protected:
     Node    *_target;
     /** The action tag. An identifier of the action */
     int     _tag;
+    /** The batch of ActionManager stepping the action and its index in it, or -1 when it is stepped with step() */
+    int     _batchKind;
+    ssize_t _batchIndex;
+
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
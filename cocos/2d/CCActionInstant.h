@@ -33,6 +33,7 @@ THE SOFTWARE.
 
 #include "CCStdC.h"
 #include "2d/CCAction.h"
+#include "base/CCAutoreleasePool.h"
 
 NS_CC_BEGIN
 
@@ -257,6 +258,8 @@ private:
 class CC_DLL CallFunc : public ActionInstant //<NSCopying>
 {
 public:
+    CC_FRAME_ALLOCATED
+
 	/** creates the action with the callback of type std::function<void()>.
 	 This is the preferred way to create the callback.
      * When this funtion bound in js or lua ,the input param will be changed
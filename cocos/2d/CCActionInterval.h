@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCAnimation.h"
 #include "base/CCProtocols.h"
+#include "base/CCAutoreleasePool.h"
 #include "base/CCVector.h"
 
 NS_CC_BEGIN
@@ -86,6 +87,8 @@ protected:
 
     float _elapsed;
     bool   _firstTick;
+
+    friend class ActionManager;
 };
 
 /** @brief Runs actions sequentially, one after another
@@ -93,6 +96,8 @@ protected:
 class CC_DLL Sequence : public ActionInterval
 {
 public:
+    CC_FRAME_ALLOCATED
+
     /** helper constructor to create an array of sequenceable actions */
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     // WP8 in VS2012 does not support nullptr in variable args lists and variadic templates are also not supported
@@ -261,6 +266,8 @@ private:
 class CC_DLL Spawn : public ActionInterval
 {
 public:
+    CC_FRAME_ALLOCATED
+
     /** helper constructor to create an array of spawned actions 
      * @code
      * When this funtion bound to the js or lua,the input params changed
@@ -400,6 +407,8 @@ protected:
     Vec3 _angle3D;
     Vec3 _startAngle3D;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
 };
@@ -436,6 +445,8 @@ protected:
     Vec2 _startPosition;
     Vec2 _previousPosition;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
 };
@@ -721,6 +732,8 @@ protected:
     float _deltaY;
     float _deltaZ;
 
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
 };
@@ -816,6 +829,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -947,6 +961,8 @@ private:
 class CC_DLL DelayTime : public ActionInterval
 {
 public:
+    CC_FRAME_ALLOCATED
+
     /** creates the action */
     static DelayTime* create(float d);
 
@@ -28,11 +28,17 @@ THE SOFTWARE.
 
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
 #include "base/uthash.h"
 
+#include <cfloat>
+#include <typeinfo>
+
 NS_CC_BEGIN
 //
 // singleton stuff
@@ -45,15 +51,193 @@ typedef struct _hashElement
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
+    // number of the actions stepped in the batches
+    int                 batchedActions;
     UT_hash_handle      hh;
 } tHashElement;
 
+//
+// batches
+//
+namespace {
+
+enum BatchKind
+{
+    BATCH_MOVE,
+    BATCH_ROTATE,
+    BATCH_SCALE,
+    BATCH_FADE,
+    BATCH_KIND_COUNT
+};
+
+typedef float (*BatchEasing)(float time, float param);
+
+enum class BatchEasingParam
+{
+    NONE,
+    RATE,
+    PERIOD
+};
+
+struct BatchEasingInfo
+{
+    const std::type_info *type;
+    BatchEasing function;
+    BatchEasingParam param;
+};
+
+// the ease actions whose easing the batches compute themselves
+const BatchEasingInfo s_batchEasings[] =
+{
+    { &typeid(EaseIn), tweenfunc::easeIn, BatchEasingParam::RATE },
+    { &typeid(EaseOut), tweenfunc::easeOut, BatchEasingParam::RATE },
+    { &typeid(EaseInOut), tweenfunc::easeInOut, BatchEasingParam::RATE },
+    { &typeid(EaseExponentialIn), [](float time, float) { return tweenfunc::expoEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseExponentialOut), [](float time, float) { return tweenfunc::expoEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseExponentialInOut), [](float time, float) { return tweenfunc::expoEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseSineIn), [](float time, float) { return tweenfunc::sineEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseSineOut), [](float time, float) { return tweenfunc::sineEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseSineInOut), [](float time, float) { return tweenfunc::sineEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseElasticIn), tweenfunc::elasticEaseIn, BatchEasingParam::PERIOD },
+    { &typeid(EaseElasticOut), tweenfunc::elasticEaseOut, BatchEasingParam::PERIOD },
+    { &typeid(EaseElasticInOut), tweenfunc::elasticEaseInOut, BatchEasingParam::PERIOD },
+    { &typeid(EaseBounceIn), [](float time, float) { return tweenfunc::bounceEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseBounceOut), [](float time, float) { return tweenfunc::bounceEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseBounceInOut), [](float time, float) { return tweenfunc::bounceEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseBackIn), [](float time, float) { return tweenfunc::backEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseBackOut), [](float time, float) { return tweenfunc::backEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseBackInOut), [](float time, float) { return tweenfunc::backEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuadraticActionIn), [](float time, float) { return tweenfunc::quadraticIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuadraticActionOut), [](float time, float) { return tweenfunc::quadraticOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuadraticActionInOut), [](float time, float) { return tweenfunc::quadraticInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuarticActionIn), [](float time, float) { return tweenfunc::quartEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuarticActionOut), [](float time, float) { return tweenfunc::quartEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuarticActionInOut), [](float time, float) { return tweenfunc::quartEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuinticActionIn), [](float time, float) { return tweenfunc::quintEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuinticActionOut), [](float time, float) { return tweenfunc::quintEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseQuinticActionInOut), [](float time, float) { return tweenfunc::quintEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCircleActionIn), [](float time, float) { return tweenfunc::circEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCircleActionOut), [](float time, float) { return tweenfunc::circEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCircleActionInOut), [](float time, float) { return tweenfunc::circEaseInOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCubicActionIn), [](float time, float) { return tweenfunc::cubicEaseIn(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCubicActionOut), [](float time, float) { return tweenfunc::cubicEaseOut(time); }, BatchEasingParam::NONE },
+    { &typeid(EaseCubicActionInOut), [](float time, float) { return tweenfunc::cubicEaseInOut(time); }, BatchEasingParam::NONE },
+};
+
+} // namespace
+
+/** The running actions of one kind, stored column by column.
+ The start values and deltas have up to 3 channels: x and y of the position, x and y of the rotation skew,
+ x, y and z of the scale, or the opacity.
+ */
+struct ActionManager::ActionBatch
+{
+    explicit ActionBatch(int batchKind) : kind(batchKind) {}
+
+    ssize_t size() const { return (ssize_t)actions.size(); }
+
+    void push(ActionInterval *action, ActionInterval *innerAction, tHashElement *element, BatchEasing easing, float easingParam)
+    {
+        actions.push_back(action);
+        innerActions.push_back(innerAction);
+        targets.push_back(element->target);
+        elements.push_back(element);
+        elapsed.push_back(0);
+        durations.push_back(action->getDuration());
+        firstTicks.push_back(true);
+        easings.push_back(easing);
+        easingParams.push_back(easingParam);
+        for (int c = 0; c < 3; ++c)
+        {
+            starts[c].push_back(0);
+            deltas[c].push_back(0);
+        }
+        for (int c = 0; c < 2; ++c)
+        {
+            previous[c].push_back(0);
+        }
+    }
+
+    // moves the last entry to the index and drops the last one
+    void swapRemove(ssize_t index)
+    {
+        ssize_t last = size() - 1;
+        if (index != last)
+        {
+            actions[index] = actions[last];
+            innerActions[index] = innerActions[last];
+            targets[index] = targets[last];
+            elements[index] = elements[last];
+            elapsed[index] = elapsed[last];
+            durations[index] = durations[last];
+            firstTicks[index] = firstTicks[last];
+            easings[index] = easings[last];
+            easingParams[index] = easingParams[last];
+            for (int c = 0; c < 3; ++c)
+            {
+                starts[c][index] = starts[c][last];
+                deltas[c][index] = deltas[c][last];
+            }
+            for (int c = 0; c < 2; ++c)
+            {
+                previous[c][index] = previous[c][last];
+            }
+        }
+
+        actions.pop_back();
+        innerActions.pop_back();
+        targets.pop_back();
+        elements.pop_back();
+        elapsed.pop_back();
+        durations.pop_back();
+        firstTicks.pop_back();
+        easings.pop_back();
+        easingParams.pop_back();
+        for (int c = 0; c < 3; ++c)
+        {
+            starts[c].pop_back();
+            deltas[c].pop_back();
+        }
+        for (int c = 0; c < 2; ++c)
+        {
+            previous[c].pop_back();
+        }
+    }
+
+    int kind;
+    // the actions added to the manager, nullptr when removed while the batches are stepped
+    std::vector<ActionInterval*> actions;
+    // the same actions, or the actions eased by them
+    std::vector<ActionInterval*> innerActions;
+    std::vector<Node*> targets;
+    std::vector<tHashElement*> elements;
+    std::vector<float> elapsed;
+    std::vector<float> durations;
+    std::vector<unsigned char> firstTicks;
+    // nullptr when the action is linear
+    std::vector<BatchEasing> easings;
+    std::vector<float> easingParams;
+    std::vector<float> starts[3];
+    std::vector<float> deltas[3];
+    // the last position set by each MoveBy, to stack the movements of the other actions
+    std::vector<float> previous[2];
+    // eased times of the current frame, and whether each action was stepped in it
+    std::vector<float> times;
+    std::vector<unsigned char> stepped;
+};
+
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _updatingBatches(false),
+  _batchesHaveRemovedEntries(false),
+  _batchingEnabled(false)
 {
-
+    for (int kind = 0; kind < BATCH_KIND_COUNT; ++kind)
+    {
+        _batches.push_back(new ActionBatch(kind));
+    }
 }
 
 ActionManager::~ActionManager()
@@ -61,6 +245,11 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+
+    for (auto batch : _batches)
+    {
+        delete batch;
+    }
 }
 
 // private
@@ -97,6 +286,11 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    if (action->_batchKind >= 0)
+    {
+        removeBatchedAction(action);
+    }
+
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -189,6 +383,8 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     addBatchedAction(action, element);
 }
 
 // remove
@@ -221,6 +417,15 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        for (int i = 0; element->batchedActions > 0 && i < element->actions->num; ++i)
+        {
+            Action *action = (Action*)element->actions->arr[i];
+            if (action->_batchKind >= 0)
+            {
+                removeBatchedAction(action);
+            }
+        }
+
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -344,14 +549,15 @@ void ActionManager::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // the targets running only batched actions have nothing to step here
+        if (! _currentTarget->paused && _currentTarget->actions->num > _currentTarget->batchedActions)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
                 _currentTarget->actionIndex++)
             {
                 _currentTarget->currentAction = (Action*)_currentTarget->actions->arr[_currentTarget->actionIndex];
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr || _currentTarget->currentAction->_batchKind >= 0)
                 {
                     continue;
                 }
@@ -394,6 +600,319 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    updateBatches(dt);
+}
+
+// batches
+
+bool ActionManager::addBatchedAction(Action *action, tHashElement *element)
+{
+    if (! _batchingEnabled)
+    {
+        return false;
+    }
+
+    // only the exact types are batched, subclasses may override update()
+    ActionInterval *innerAction = nullptr;
+    BatchEasing easing = nullptr;
+    float easingParam = 0;
+    const std::type_info& type = typeid(*action);
+    for (const auto& info : s_batchEasings)
+    {
+        if (*info.type == type)
+        {
+            auto ease = static_cast<ActionEase*>(action);
+            innerAction = ease->getInnerAction();
+            easing = info.function;
+            if (info.param == BatchEasingParam::RATE)
+            {
+                easingParam = static_cast<EaseRateAction*>(action)->getRate();
+            }
+            else if (info.param == BatchEasingParam::PERIOD)
+            {
+                easingParam = static_cast<EaseElastic*>(action)->getPeriod();
+            }
+            break;
+        }
+    }
+    if (innerAction == nullptr)
+    {
+        // checked below, before it is used
+        innerAction = static_cast<ActionInterval*>(action);
+    }
+
+    int kind;
+    const std::type_info& innerType = innerAction != action ? typeid(*innerAction) : type;
+    if (innerType == typeid(MoveBy) || innerType == typeid(MoveTo))
+    {
+        kind = BATCH_MOVE;
+    }
+    else if (innerType == typeid(RotateBy) && ! static_cast<RotateBy*>(innerAction)->_is3D)
+    {
+        kind = BATCH_ROTATE;
+    }
+    else if (innerType == typeid(ScaleTo) || innerType == typeid(ScaleBy))
+    {
+        kind = BATCH_SCALE;
+    }
+    else if (innerType == typeid(FadeTo) || innerType == typeid(FadeIn) || innerType == typeid(FadeOut))
+    {
+        kind = BATCH_FADE;
+    }
+    else
+    {
+        return false;
+    }
+
+    auto interval = static_cast<ActionInterval*>(action);
+    ActionBatch *batch = _batches[kind];
+    ssize_t index = batch->size();
+    batch->push(interval, innerAction, element, easing, easingParam);
+    batch->elapsed[index] = interval->_elapsed;
+    batch->firstTicks[index] = interval->_firstTick;
+
+    switch (kind)
+    {
+        case BATCH_MOVE:
+        {
+            auto move = static_cast<MoveBy*>(innerAction);
+            batch->starts[0][index] = move->_startPosition.x;
+            batch->starts[1][index] = move->_startPosition.y;
+            batch->deltas[0][index] = move->_positionDelta.x;
+            batch->deltas[1][index] = move->_positionDelta.y;
+            batch->previous[0][index] = move->_previousPosition.x;
+            batch->previous[1][index] = move->_previousPosition.y;
+            break;
+        }
+        case BATCH_ROTATE:
+        {
+            auto rotate = static_cast<RotateBy*>(innerAction);
+            batch->starts[0][index] = rotate->_startAngleZ_X;
+            batch->starts[1][index] = rotate->_startAngleZ_Y;
+            batch->deltas[0][index] = rotate->_angleZ_X;
+            batch->deltas[1][index] = rotate->_angleZ_Y;
+            break;
+        }
+        case BATCH_SCALE:
+        {
+            auto scale = static_cast<ScaleTo*>(innerAction);
+            batch->starts[0][index] = scale->_startScaleX;
+            batch->starts[1][index] = scale->_startScaleY;
+            batch->starts[2][index] = scale->_startScaleZ;
+            batch->deltas[0][index] = scale->_deltaX;
+            batch->deltas[1][index] = scale->_deltaY;
+            batch->deltas[2][index] = scale->_deltaZ;
+            break;
+        }
+        case BATCH_FADE:
+        {
+            auto fade = static_cast<FadeTo*>(innerAction);
+            batch->starts[0][index] = fade->_fromOpacity;
+            batch->deltas[0][index] = fade->_toOpacity - fade->_fromOpacity;
+            break;
+        }
+    }
+
+    action->_batchKind = kind;
+    action->_batchIndex = index;
+    element->batchedActions++;
+    return true;
+}
+
+void ActionManager::removeBatchedAction(Action *action)
+{
+    ActionBatch *batch = _batches[action->_batchKind];
+    ssize_t index = action->_batchIndex;
+    CCASSERT(batch->actions[index] == action, "the batched action is not at its index");
+
+    // the stacked start position is the only state which changes while the action runs
+    if (batch->kind == BATCH_MOVE)
+    {
+        auto move = static_cast<MoveBy*>(batch->innerActions[index]);
+        move->_startPosition.set(batch->starts[0][index], batch->starts[1][index]);
+        move->_previousPosition.set(batch->previous[0][index], batch->previous[1][index]);
+    }
+
+    batch->elements[index]->batchedActions--;
+    action->_batchKind = -1;
+    action->_batchIndex = -1;
+
+    if (_updatingBatches)
+    {
+        // the entries can't move while they are stepped
+        batch->actions[index] = nullptr;
+        _batchesHaveRemovedEntries = true;
+    }
+    else
+    {
+        removeBatchEntry(batch, index);
+    }
+}
+
+void ActionManager::removeBatchEntry(ActionBatch *batch, ssize_t index)
+{
+    batch->swapRemove(index);
+    if (index < batch->size() && batch->actions[index] != nullptr)
+    {
+        batch->actions[index]->_batchIndex = index;
+    }
+}
+
+void ActionManager::stepBatch(ActionBatch *batch, float dt)
+{
+    // the actions added by the targets while the batch is stepped wait for the next frame
+    const ssize_t count = batch->size();
+    batch->times.resize(count);
+    batch->stepped.resize(count);
+
+    float *elapsed = batch->elapsed.data();
+    const float *durations = batch->durations.data();
+    float *times = batch->times.data();
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        ActionInterval *action = batch->actions[i];
+        batch->stepped[i] = action != nullptr && ! batch->elements[i]->paused;
+        if (! batch->stepped[i])
+        {
+            continue;
+        }
+
+        // same as ActionInterval::step()
+        if (batch->firstTicks[i])
+        {
+            batch->firstTicks[i] = false;
+            elapsed[i] = 0;
+            action->_firstTick = false;
+        }
+        else
+        {
+            elapsed[i] += dt;
+        }
+        action->_elapsed = elapsed[i];
+
+        float time = MAX(0, MIN(1, elapsed[i] / MAX(durations[i], FLT_EPSILON)));
+        times[i] = batch->easings[i] ? batch->easings[i](time, batch->easingParams[i]) : time;
+    }
+
+    // the setters may be overridden, so the entries and the columns are looked up again after each call.
+    // An overridden setter may also remove the target, which releases it: the targets set several times are retained
+    // until the last setter returned
+    switch (batch->kind)
+    {
+        case BATCH_MOVE:
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                if (! batch->stepped[i] || batch->actions[i] == nullptr)
+                {
+                    continue;
+                }
+                Node *target = batch->targets[i];
+#if CC_ENABLE_STACKABLE_ACTIONS
+                const Vec2& currentPos = target->getPosition();
+                batch->starts[0][i] += currentPos.x - batch->previous[0][i];
+                batch->starts[1][i] += currentPos.y - batch->previous[1][i];
+                Vec2 newPos(batch->starts[0][i] + batch->deltas[0][i] * batch->times[i],
+                            batch->starts[1][i] + batch->deltas[1][i] * batch->times[i]);
+                batch->previous[0][i] = newPos.x;
+                batch->previous[1][i] = newPos.y;
+                target->setPosition(newPos);
+#else
+                target->setPosition(Vec2(batch->starts[0][i] + batch->deltas[0][i] * batch->times[i],
+                                         batch->starts[1][i] + batch->deltas[1][i] * batch->times[i]));
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+            }
+            break;
+        case BATCH_ROTATE:
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                if (! batch->stepped[i] || batch->actions[i] == nullptr)
+                {
+                    continue;
+                }
+                Node *target = batch->targets[i];
+                target->retain();
+                target->setRotationSkewX(batch->starts[0][i] + batch->deltas[0][i] * batch->times[i]);
+                target->setRotationSkewY(batch->starts[1][i] + batch->deltas[1][i] * batch->times[i]);
+                target->release();
+            }
+            break;
+        case BATCH_SCALE:
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                if (! batch->stepped[i] || batch->actions[i] == nullptr)
+                {
+                    continue;
+                }
+                Node *target = batch->targets[i];
+                target->retain();
+                target->setScaleX(batch->starts[0][i] + batch->deltas[0][i] * batch->times[i]);
+                target->setScaleY(batch->starts[1][i] + batch->deltas[1][i] * batch->times[i]);
+                target->setScaleZ(batch->starts[2][i] + batch->deltas[2][i] * batch->times[i]);
+                target->release();
+            }
+            break;
+        case BATCH_FADE:
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                if (! batch->stepped[i] || batch->actions[i] == nullptr)
+                {
+                    continue;
+                }
+                batch->targets[i]->setOpacity((GLubyte)(batch->starts[0][i] + batch->deltas[0][i] * batch->times[i]));
+            }
+            break;
+    }
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Action *action = batch->actions[i];
+        if (batch->stepped[i] && action != nullptr && batch->elapsed[i] >= batch->durations[i])
+        {
+            action->retain();
+            _finishedBatchedActions.push_back(action);
+        }
+    }
+}
+
+void ActionManager::updateBatches(float dt)
+{
+    _updatingBatches = true;
+    for (auto batch : _batches)
+    {
+        stepBatch(batch, dt);
+    }
+    _updatingBatches = false;
+
+    if (_batchesHaveRemovedEntries)
+    {
+        _batchesHaveRemovedEntries = false;
+        for (auto batch : _batches)
+        {
+            // backwards, so the entry moved into a removed one was already checked
+            for (ssize_t i = batch->size() - 1; i >= 0; --i)
+            {
+                if (batch->actions[i] == nullptr)
+                {
+                    removeBatchEntry(batch, i);
+                }
+            }
+        }
+    }
+
+    // same as the end of the actions stepped in update()
+    for (size_t i = 0; i < _finishedBatchedActions.size(); ++i)
+    {
+        Action *action = _finishedBatchedActions[i];
+        // it may have been removed by a target since it finished
+        if (action->_batchKind >= 0)
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
+    _finishedBatchedActions.clear();
 }
 
 NS_CC_END
@@ -122,6 +122,18 @@ public:
      */
     void resumeTargets(const Vector<Node*>& targetsToResume);
 
+    /** Enables or disables the batched stepping of the simple interval actions. Disabled by default.
+     MoveBy, MoveTo, RotateBy, ScaleTo, ScaleBy, FadeTo, FadeIn and FadeOut, run alone or wrapped in one ease action,
+     are stepped together in tight loops over their start values, deltas and elapsed times instead of through Action::step().
+     Any other action, like Sequence, Spawn or Repeat, is stepped through Action::step().
+     It only affects the actions added afterwards.
+     @note The batched actions are stepped after the other actions of all the targets, instead of in the order
+     they were added to their target: an action (eg: a CallFunc) doesn't see, in the same frame, the values set
+     by a batched action added before it to the same target. Only enable it if the actions don't depend on that order.
+     */
+    void setBatchingEnabled(bool enabled) { _batchingEnabled = enabled; }
+    bool isBatchingEnabled() const { return _batchingEnabled; }
+
     void update(float dt);
     
 protected:
@@ -131,10 +143,26 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    struct ActionBatch;
+
+    bool addBatchedAction(Action *action, struct _hashElement *element);
+    void removeBatchedAction(Action *action);
+    void removeBatchEntry(ActionBatch *batch, ssize_t index);
+    void stepBatch(ActionBatch *batch, float dt);
+    void updateBatches(float dt);
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+
+    // one batch per kind of batched action
+    std::vector<ActionBatch*> _batches;
+    // batched actions which finished in the current frame, retained until they are stopped
+    std::vector<Action*> _finishedBatchedActions;
+    bool            _updatingBatches;
+    bool            _batchesHaveRemovedEntries;
+    bool            _batchingEnabled;
 };
 
 // end of actions group
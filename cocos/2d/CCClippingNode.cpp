@@ -218,8 +218,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     //Add group command
         
@@ -287,7 +286,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
 
     renderer->popGroup();
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 Node* ClippingNode::getStencil() const
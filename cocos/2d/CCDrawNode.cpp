@@ -103,7 +103,7 @@ static inline Tex2F __t(const Vec2 &v)
 
 DrawNode::DrawNode()
 : _vao(0)
-, _vbo(0)
+, _vertexOffset(0)
 , _bufferCapacity(0)
 , _bufferCount(0)
 , _buffer(nullptr)
@@ -117,9 +117,6 @@ DrawNode::~DrawNode()
     free(_buffer);
     _buffer = nullptr;
     
-    glDeleteBuffers(1, &_vbo);
-    _vbo = 0;
-    
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_vao);
@@ -168,18 +165,13 @@ bool DrawNode::init()
         GL::bindVAO(_vao);
     }
     
-    glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
+    // room for the vertices to be uploaded twice before the storage is orphaned
+    _vertexStream.init(sizeof(V2F_C4B_T2F) * _bufferCapacity * 2);
     
+    // the pointers are set when drawing, at the offset where the vertices were uploaded
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
-    
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-    
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
@@ -222,8 +214,13 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
 
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
+        // only the vertices in use are uploaded, not the whole capacity
+        size_t size = sizeof(V2F_C4B_T2F) * _bufferCount;
+        if (size > _vertexStream.getCapacity())
+        {
+            _vertexStream.resize(sizeof(V2F_C4B_T2F) * _bufferCapacity * 2);
+        }
+        _vertexOffset = _vertexStream.upload(_buffer, size);
         _dirty = false;
     }
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -233,18 +230,11 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
     else
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        // vertex
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
-
-        // color
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, colors));
-
-        // texcood
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     }
 
+    _vertexStream.bind();
+    setupVertexAttribPointers();
+
     glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -252,6 +242,18 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
     CHECK_GL_ERROR_DEBUG();
 }
 
+void DrawNode::setupVertexAttribPointers()
+{
+    // vertex
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)(_vertexOffset + offsetof(V2F_C4B_T2F, vertices)));
+
+    // color
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V2F_C4B_T2F), (GLvoid *)(_vertexOffset + offsetof(V2F_C4B_T2F, colors)));
+
+    // texcood
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)(_vertexOffset + offsetof(V2F_C4B_T2F, texCoords)));
+}
+
 void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
 {
     unsigned int vertex_count = 2*3;
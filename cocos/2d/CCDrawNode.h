@@ -34,6 +34,7 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCStreamingVertexBuffer.h"
 
 NS_CC_BEGIN
 
@@ -102,8 +103,12 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     void ensureCapacity(int count);
 
+    void setupVertexAttribPointers();
+
     GLuint      _vao;
-    GLuint      _vbo;
+    StreamingVertexBuffer _vertexStream;
+    // where the vertices were written the last time they were uploaded
+    size_t      _vertexOffset;
 
     int         _bufferCapacity;
     GLsizei     _bufferCount;
@@ -126,7 +126,8 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
     else
     {
         s_cacheFontData[fontName].referenceCount = 1;
-        s_cacheFontData[fontName].data = FileUtils::getInstance()->getDataFromFile(fontName);    
+        // FreeType reads the glyphs from the buffer for as long as the face lives, so a mapping only pages in what is rendered
+        s_cacheFontData[fontName].data = FileUtils::getInstance()->getMappedDataFromFile(fontName);
 
         if (s_cacheFontData[fontName].data.isNull())
         {
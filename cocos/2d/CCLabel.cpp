@@ -1093,8 +1093,7 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, bool parentTr
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
     
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
     
 
     if (_textSprite)
@@ -1106,7 +1105,7 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, bool parentTr
         draw(renderer, _modelViewTransform, dirty);
     }
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
     
     setOrderOfArrival(0);
 }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 
 #include <algorithm>
+#include <mutex>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -45,6 +46,8 @@ THE SOFTWARE.
 #include "2d/CCComponentContainer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
+#include "2d/CCTransformSystem.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -71,6 +74,13 @@ bool nodeComparisonLess(Node* n1, Node* n2)
 
 // XXX: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 int Node::s_globalOrderOfArrival = 1;
+std::atomic<unsigned int> Node::s_globalTransformVersion(0);
+unsigned int Node::s_globalHierarchyVersion = 0;
+bool Node::s_subtreeDirtyDeferred = false;
+
+// the nodes changed by the concurrent updates, their ancestors are marked dirty afterwards
+static std::mutex s_deferredSubtreeDirtyMutex;
+static std::vector<Node*> s_deferredSubtreeDirtyNodes;
 
 Node::Node(void)
 : _rotationX(0.0f)
@@ -91,6 +101,7 @@ Node::Node(void)
 , _transformDirty(true)
 , _inverseDirty(true)
 , _transformUpdated(true)
+, _transformVersion(0)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder(0)
@@ -107,6 +118,15 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _siblingOrderDirty(false)
+, _cullingEnabled(false)
+, _concurrentVisitEnabled(false)
+, _subtreeBoundingBoxDirty(true)
+, _subtreeNodeCount(1)
+, _transformSystemIndex(-1)
+, _transformSystemDirty(true)
+, _transformVolatile(false)
+, _subtreeDirtyDeferred(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -161,6 +181,12 @@ Node::~Node()
         child->_parent = nullptr;
     }
 
+    // the TransformSystem may still reference this node
+    if (_transformSystemIndex >= 0)
+    {
+        ++s_globalHierarchyVersion;
+    }
+
     removeAllComponents();
     
     CC_SAFE_DELETE(_componentContainer);
@@ -200,6 +226,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 float Node::getSkewY() const
@@ -214,6 +241,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 
@@ -262,6 +290,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody && !_physicsBody->_rotationResetTag)
@@ -285,6 +314,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -316,6 +346,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 float Node::getRotationSkewY() const
@@ -330,6 +361,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 /// scale getter
@@ -347,6 +379,7 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 /// scaleX getter
@@ -364,6 +397,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 /// scaleX setter
@@ -374,6 +408,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 /// scaleY getter
@@ -390,6 +425,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 /// scaleY getter
@@ -406,6 +442,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 
@@ -423,6 +460,7 @@ void Node::setPosition(const Vec2& position)
     
     _position = position;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody != nullptr && !_physicsBody->_positionResetTag)
@@ -490,6 +528,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 
     _positionZ = positionZ;
 
@@ -516,6 +555,7 @@ void Node::setVisible(bool visible)
     {
         _visible = visible;
         if(_visible) _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeDirty();
     }
 }
 
@@ -545,6 +585,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeDirty();
     }
 }
 
@@ -562,6 +603,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeDirty();
     }
 }
 
@@ -589,6 +631,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setSubtreeDirty();
 	}
 }
 
@@ -671,6 +714,97 @@ Rect Node::getBoundingBox() const
     return RectApplyAffineTransform(rect, getNodeToParentAffineTransform());
 }
 
+static inline bool isEmptyBoundingBox(const Rect& rect)
+{
+    return rect.size.width <= 0 && rect.size.height <= 0;
+}
+
+const Rect& Node::getSubtreeBoundingBox()
+{
+    if (_subtreeBoundingBoxDirty)
+    {
+        // first in the coordinate system of this node: the children boxes are already in it
+        Rect bounds;
+        if (_contentSize.width > 0 || _contentSize.height > 0)
+        {
+            bounds.size = _contentSize;
+        }
+
+        _subtreeNodeCount = 1;
+        for (const auto& child : _children)
+        {
+            if (!child->_visible)
+                continue;
+
+            const Rect& childBounds = child->getSubtreeBoundingBox();
+            _subtreeNodeCount += child->_subtreeNodeCount;
+
+            if (isEmptyBoundingBox(childBounds))
+                continue;
+
+            bounds = isEmptyBoundingBox(bounds) ? childBounds : bounds.unionWithRect(childBounds);
+        }
+
+        _subtreeBoundingBox = isEmptyBoundingBox(bounds) ? Rect::ZERO : RectApplyTransform(bounds, getNodeToParentTransform());
+        _subtreeBoundingBoxDirty = false;
+    }
+
+    return _subtreeBoundingBox;
+}
+
+void Node::setTransformVolatile(bool isVolatile)
+{
+    if (_transformVolatile != isVolatile)
+    {
+        _transformVolatile = isVolatile;
+        // the TransformSystem finds the volatile nodes when it flattens the hierarchy
+        ++s_globalHierarchyVersion;
+    }
+}
+
+void Node::setSubtreeDirty()
+{
+    _transformSystemDirty = true;
+    ++s_globalTransformVersion;
+
+    if (s_subtreeDirtyDeferred)
+    {
+        _subtreeBoundingBoxDirty = true;
+        if (!_subtreeDirtyDeferred)
+        {
+            _subtreeDirtyDeferred = true;
+            std::lock_guard<std::mutex> lock(s_deferredSubtreeDirtyMutex);
+            s_deferredSubtreeDirtyNodes.push_back(this);
+        }
+        return;
+    }
+
+    // walks up to the root: a dirty node can have clean ancestors, since getSubtreeBoundingBox() skips the
+    // invisible children and leaves them dirty
+    for (Node* node = this; node; node = node->_parent)
+    {
+        node->_subtreeBoundingBoxDirty = true;
+    }
+}
+
+void Node::beginDeferredSubtreeDirty()
+{
+    s_subtreeDirtyDeferred = true;
+}
+
+void Node::endDeferredSubtreeDirty()
+{
+    s_subtreeDirtyDeferred = false;
+
+    // the concurrent updates are done, nothing else writes to the list
+    for (auto node : s_deferredSubtreeDirtyNodes)
+    {
+        node->_subtreeDirtyDeferred = false;
+        node->setSubtreeDirty();
+    }
+    s_deferredSubtreeDirtyNodes.clear();
+}
+
 Node * Node::create()
 {
 	Node * ret = new Node();
@@ -877,6 +1011,9 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+    CCASSERT(!s_subtreeDirtyDeferred, "The concurrent updates can't add nor remove children");
+    setSubtreeDirty();
+    ++s_globalHierarchyVersion;
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -909,6 +1046,9 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     child->setParent(nullptr);
 
     _children.erase(childIndex);
+    CCASSERT(!s_subtreeDirtyDeferred, "The concurrent updates can't add nor remove children");
+    setSubtreeDirty();
+    ++s_globalHierarchyVersion;
 }
 
 
@@ -917,7 +1057,11 @@ void Node::insertChild(Node* child, int z)
 {
     _transformUpdated = true;
     _reorderChildDirty = true;
+    child->_siblingOrderDirty = true;
     _children.pushBack(child);
+    CCASSERT(!s_subtreeDirtyDeferred, "The concurrent updates can't add nor remove children");
+    setSubtreeDirty();
+    ++s_globalHierarchyVersion;
     child->_setLocalZOrder(z);
 }
 
@@ -925,6 +1069,7 @@ void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
     _reorderChildDirty = true;
+    child->_siblingOrderDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setLocalZOrder(zOrder);
 }
@@ -932,11 +1077,60 @@ void Node::reorderChild(Node *child, int zOrder)
 void Node::sortAllChildren()
 {
     if( _reorderChildDirty ) {
-        std::sort( std::begin(_children), std::end(_children), nodeComparisonLess );
+        sortNodes(_children);
         _reorderChildDirty = false;
     }
 }
 
+void Node::sortNodes(Vector<Node*>& nodes)
+{
+    // no static scratch buffers: the children of the nodes visited concurrently are sorted by several threads
+    auto data = std::begin(nodes);
+    ssize_t count = nodes.size();
+    std::vector<Node*> reorderedNodes;
+
+    // moves the nodes still in order to the front
+    ssize_t sortedCount = 0;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Node* node = data[i];
+        if (node->_siblingOrderDirty)
+        {
+            node->_siblingOrderDirty = false;
+            reorderedNodes.push_back(node);
+        }
+        else
+        {
+            data[sortedCount++] = node;
+        }
+    }
+    std::copy(reorderedNodes.begin(), reorderedNodes.end(), data + sortedCount);
+
+    if (!std::is_sorted(data, data + sortedCount, nodeComparisonLess))
+    {
+        // the order was changed without reorderChild(), e.g. orderOfArrival was reset by visit() on only some nodes
+        std::sort(data, data + count, nodeComparisonLess);
+        return;
+    }
+
+    // merges from the back, so it can be done in place
+    std::sort(reorderedNodes.begin(), reorderedNodes.end(), nodeComparisonLess);
+    ssize_t i = sortedCount - 1;
+    ssize_t j = (ssize_t)reorderedNodes.size() - 1;
+    ssize_t k = count - 1;
+    while (j >= 0)
+    {
+        if (i >= 0 && nodeComparisonLess(reorderedNodes[j], data[i]))
+        {
+            data[k--] = data[i--];
+        }
+        else
+        {
+            data[k--] = reorderedNodes[j--];
+        }
+    }
+}
+
 void Node::draw()
 {
     auto renderer = Director::getInstance()->getRenderer();
@@ -973,21 +1167,26 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     int i = 0;
 
     if(!_children.empty())
     {
         sortAllChildren();
+
+        // culling is enabled by this node or by one of its ancestors
+        bool parentCulling = renderer->isCullingEnabled();
+        bool culling = parentCulling || _cullingEnabled;
+        renderer->setCullingEnabled(culling);
+
         // draw children zOrder < 0
         for( ; i < _children.size(); i++ )
         {
             auto node = _children.at(i);
 
             if ( node && node->_localZOrder < 0 )
-                node->visit(renderer, _modelViewTransform, dirty);
+                visitChild(renderer, node, culling, dirty);
             else
                 break;
         }
@@ -995,7 +1194,9 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
         this->draw(renderer, _modelViewTransform, dirty);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, dirty);
+            visitChild(renderer, *it, culling, dirty);
+
+        renderer->setCullingEnabled(parentCulling);
     }
     else
     {
@@ -1005,11 +1206,42 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
     // reset for next frame
     _orderOfArrival = 0;
  
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
+}
+
+void Node::visitChild(Renderer* renderer, Node* child, bool culling, bool transformUpdated)
+{
+    if (culling && cullChild(renderer, child, transformUpdated))
+        return;
+
+    if (child->_concurrentVisitEnabled && renderer->visitConcurrently(child, _modelViewTransform, transformUpdated))
+        return;
+
+    child->visit(renderer, _modelViewTransform, transformUpdated);
+}
+
+bool Node::cullChild(Renderer* renderer, Node* child, bool transformUpdated)
+{
+    if (!child->_visible)
+        return false;
+
+    // the box is in the coordinate system of this node
+    const Rect& bounds = child->getSubtreeBoundingBox();
+    if (isEmptyBoundingBox(bounds) || renderer->checkVisibility(_modelViewTransform, bounds))
+        return false;
+
+    // it is not visited, so it has to update its transform the next time it is
+    if (transformUpdated)
+        child->_transformUpdated = true;
+
+    renderer->addCulledNodes(child->_subtreeNodeCount);
+    return true;
 }
 
 Mat4 Node::transform(const Mat4& parentTransform)
 {
+    ++_transformVersion;
+    
     Mat4 ret = this->getNodeToParentTransform();
     ret  = parentTransform * ret;
     return ret;
@@ -1441,6 +1673,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setSubtreeDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1459,6 +1692,7 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setSubtreeDirty();
 }
 
 
@@ -1494,6 +1728,14 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
 
 Mat4 Node::getNodeToWorldTransform() const
 {
+    // up to date world transforms of the running scene are already computed by the transform system
+    TransformSystem* transformSystem = TransformSystem::getCurrent();
+    const Mat4* world = transformSystem ? transformSystem->getNodeToWorldTransform(this) : nullptr;
+    if (world)
+    {
+        return *world;
+    }
+
     Mat4 t = this->getNodeToParentTransform();
 
     for (Node *p = _parent; p != nullptr; p = p->getParent())
@@ -39,6 +39,8 @@
 #include "renderer/ccGLStateCache.h"
 #include "CCGL.h"
 
+#include <atomic>
+
 NS_CC_BEGIN
 
 class GridBase;
@@ -949,6 +951,39 @@ public:
     /** @deprecated Use getBoundingBox instead */
     CC_DEPRECATED_ATTRIBUTE inline virtual Rect boundingBox() const { return getBoundingBox(); }
 
+    /**
+     * Returns an AABB that contains this node and all its visible descendants, in its parent's coordinate system.
+     * It is cached, and only recomputed when a transform, a content size, a child or the visibility changes inside the subtree.
+     * Returns an empty rect if no node of the subtree has a content size.
+     */
+    const Rect& getSubtreeBoundingBox();
+
+    /**
+     * Enables the culling of the descendants of this node.
+     *
+     * When enabled, the descendants whose subtree bounding box (see getSubtreeBoundingBox()) is outside of the screen are
+     * skipped by visit(): they are not drawn and their children are not visited. The bounding boxes are cached relative
+     * to their parents, so moving this node (eg: scrolling a big map) doesn't invalidate them.
+     * Nodes that draw outside of their content size (eg: DrawNode, particles) or that change their transform without
+     * using the setters of Node should not be culled.
+     * The number of culled nodes is shown by the stats (see Director::setDisplayStats()). Disabled by default.
+     */
+    void setCullingEnabled(bool enabled) { _cullingEnabled = enabled; }
+    /** Whether or not the culling of the descendants of this node is enabled */
+    bool isCullingEnabled() const { return _cullingEnabled; }
+
+    /**
+     * Enables the visit of this node, and of its descendants, by a worker thread of the renderer (see Renderer::setVisitThreadCount()).
+     *
+     * The render commands of the subtree are recorded apart, and inserted where they would have been if it had been visited
+     * by its parent on the main thread. The subtree must be independent: its visit() and draw() must not use the deprecated
+     * matrix stack of the Director, make GL calls, nor modify nodes out of it (eg: a Label with pending updates of its content).
+     * Disabled by default.
+     */
+    void setConcurrentVisitEnabled(bool enabled) { _concurrentVisitEnabled = enabled; }
+    /** Whether or not this node can be visited by a worker thread */
+    bool isConcurrentVisitEnabled() const { return _concurrentVisitEnabled; }
+
     virtual void setEventDispatcher(EventDispatcher* dispatcher);
     virtual EventDispatcher* getEventDispatcher() const { return _eventDispatcher; };
 
@@ -1221,6 +1256,13 @@ public:
     virtual Mat4 getNodeToWorldTransform() const;
     virtual AffineTransform getNodeToWorldAffineTransform() const;
 
+    /**
+     * Returns a counter which is incremented whenever visit recomputes the transform of the node,
+     * that is when the node or one of its ancestors was moved, scaled, rotated or resized.
+     * Caches of world space data, like the touch index of EventDispatcher, compare it to find stale entries.
+     */
+    unsigned int getTransformVersion() const { return _transformVersion; }
+
     /** @deprecated Use getNodeToWorldTransform() instead */
     CC_DEPRECATED_ATTRIBUTE inline virtual AffineTransform nodeToWorldTransform() const { return getNodeToWorldAffineTransform(); }
 
@@ -1355,6 +1397,10 @@ protected:
     /// helper that reorder a child
     void insertChild(Node* child, int z);
 
+    /// Sorts nodes by (localZOrder, orderOfArrival). Only the nodes added or reordered since the last sort are sorted,
+    /// and then merged with the others, which are still in order
+    static void sortNodes(Vector<Node*>& nodes);
+
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
 
@@ -1363,6 +1409,28 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
 
+    /// Marks the transform of this node, and the subtree bounding box of this node and of its ancestors, as dirty
+    void setSubtreeDirty();
+
+    /** While the concurrent updates of the Scheduler run, setSubtreeDirty() only marks the node itself: its ancestors
+     are shared with the nodes updated by the other threads. endDeferredSubtreeDirty() marks them afterwards. */
+    static void beginDeferredSubtreeDirty();
+    static void endDeferredSubtreeDirty();
+
+    /** Declares that getNodeToParentTransform() is computed from a source other than the setters of the node,
+     eg: a physics body. The TransformSystem then copies it on every update and never serves the world transforms
+     of the node and its descendants from its cache.
+     @since v3.2
+     */
+    void setTransformVolatile(bool isVolatile);
+    bool isTransformVolatile() const { return _transformVolatile; }
+
+    /// visit() helper: returns true, and counts the culled nodes, if the subtree of the child is outside of the screen
+    bool cullChild(Renderer* renderer, Node* child, bool transformUpdated);
+
+    /// visit() helper: culls the child, or visits it on this thread or on a worker thread of the renderer
+    void visitChild(Renderer* renderer, Node* child, bool culling, bool transformUpdated);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1406,6 +1474,7 @@ protected:
     mutable Mat4 _additionalTransform; ///< transform
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
+    unsigned int _transformVersion; ///< Incremented whenever visit recomputes the ModelView transform
 
     int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
     float _globalZOrder;            ///< Global order used to sort the node
@@ -1438,6 +1507,17 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _siblingOrderDirty;          ///< the node was added or reordered since its parent sorted its children
+    bool _cullingEnabled;             ///< whether the descendants outside of the screen are skipped by visit
+    bool _concurrentVisitEnabled;     ///< whether this node can be visited by a worker thread of the renderer
+    bool _subtreeBoundingBoxDirty;    ///< subtree bounding box dirty flag
+    Rect _subtreeBoundingBox;         ///< AABB of the node and its visible descendants, in the parent's coordinate system
+    int _subtreeNodeCount;            ///< number of visible nodes in the subtree, including this one
+
+    int _transformSystemIndex;        ///< index of the node in the TransformSystem, -1 if it is not part of it
+    bool _transformSystemDirty;       ///< the local transform must be copied again by the TransformSystem
+    bool _transformVolatile;          ///< the local transform is computed outside of the setters, so it can't be cached
+    bool _subtreeDirtyDeferred;       ///< the ancestors must be marked dirty at the end of the concurrent updates
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1461,9 +1541,15 @@ protected:
     bool        _cascadeOpacityEnabled;
 
     static int s_globalOrderOfArrival;
+    static std::atomic<unsigned int> s_globalTransformVersion;  ///< incremented every time the transform of a node changes, also by the concurrent updates
+    static unsigned int s_globalHierarchyVersion;   ///< incremented every time a child is added or removed
+    static bool s_subtreeDirtyDeferred;             ///< whether the concurrent updates of the Scheduler are running
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
+
+    friend class TransformSystem;
+    friend class Scheduler;
     
 #if CC_USE_PHYSICS
     friend class Layer;
@@ -105,8 +105,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, bool paren
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
     
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     Director::Projection beforeProjectionType = Director::Projection::DEFAULT;
     if(_nodeGrid && _nodeGrid->isActive())
@@ -167,7 +166,7 @@ void NodeGrid::visit(Renderer *renderer, const Mat4 &parentTransform, bool paren
 
     renderer->popGroup();
  
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 void NodeGrid::setGrid(GridBase *grid)
@@ -145,12 +145,11 @@ void ParticleBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, b
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     draw(renderer, _modelViewTransform, dirty);
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 // override addChild:
@@ -403,13 +403,12 @@ void RenderTexture::visit(Renderer *renderer, const Mat4 &parentTransform, bool
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     _sprite->visit(renderer, _modelViewTransform, dirty);
     draw(renderer, _modelViewTransform, dirty);
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 
     _orderOfArrival = 0;
 }
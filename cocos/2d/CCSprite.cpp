@@ -590,7 +590,8 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdat
     // Don't do calculate the culling if the transform was not updated
     _insideBounds = transformUpdated ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
-    if(_insideBounds)
+    // a texture uploaded progressively is drawn once all its rows are there
+    if(_insideBounds && _texture->isReady())
     {
         _quadCommand.init(_globalZOrder, _texture->getName(), getGLProgramState(), _blendFunc, &_quad, 1, transform);
         renderer->addCommand(&_quadCommand);
@@ -688,7 +689,7 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortNodes(_children);
 
         if ( _batchNode)
         {
@@ -116,6 +116,14 @@ bool SpriteFrame::initWithTextureFilename(const std::string& filename, const Rec
     return true;
 }
 
+SpriteFrame::SpriteFrame(void)
+: _rotated(false)
+, _texture(nullptr)
+{
+    // the frames are created by the loader threads too
+    setReferenceCountThreadSafe(true);
+}
+
 SpriteFrame::~SpriteFrame(void)
 {
     CCLOGINFO("deallocing SpriteFrame: %p", this);
@@ -75,6 +75,10 @@ public:
      The originalSize is the size in points of the frame before being trimmed.
      */
     static SpriteFrame* createWithTexture(Texture2D* pobTexture, const Rect& rect, bool rotated, const Vec2& offset, const Size& originalSize);
+    /**
+     * @js ctor
+     */
+    SpriteFrame(void);
     /**
      * @js NA
      * @lua NA
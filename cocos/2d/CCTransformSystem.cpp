@@ -0,0 +1,301 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCTransformSystem.h"
+
+#include <algorithm>
+
+#include "2d/CCNode.h"
+#include "base/CCThreadPool.h"
+
+NS_CC_BEGIN
+
+TransformSystem* TransformSystem::s_current = nullptr;
+
+TransformSystem::TransformSystem()
+: _root(nullptr)
+, _flattenedRoot(nullptr)
+, _hierarchyVersion(0)
+, _transformVersion(0)
+, _threadPool(nullptr)
+, _updatedCount(0)
+{
+}
+
+TransformSystem::~TransformSystem()
+{
+    if (s_current == this)
+    {
+        s_current = nullptr;
+    }
+    CC_SAFE_DELETE(_threadPool);
+}
+
+void TransformSystem::setRoot(Node* root)
+{
+    _root = root;
+}
+
+void TransformSystem::setThreadCount(int threadCount)
+{
+    CCASSERT(threadCount >= 0, "Invalid thread count");
+
+    if (threadCount == getThreadCount())
+        return;
+
+    CC_SAFE_DELETE(_threadPool);
+    if (threadCount > 0)
+    {
+        _threadPool = new ThreadPool(threadCount);
+    }
+
+    // the size of the ranges depends on the number of threads
+    buildRanges();
+}
+
+int TransformSystem::getThreadCount() const
+{
+    return _threadPool ? _threadPool->getThreadCount() : 0;
+}
+
+inline void TransformSystem::updateTransform(int index)
+{
+    const int parent = _parents[index];
+    if (_dirty[parent])
+    {
+        _dirty[index] = 1;
+    }
+
+    if (_dirty[index])
+    {
+        Mat4::multiply(_worldTransforms[parent], _localTransforms[index], &_worldTransforms[index]);
+    }
+}
+
+void TransformSystem::update()
+{
+    _updatedCount = 0;
+
+    if (_root == nullptr)
+    {
+        _nodes.clear();
+        _flattenedRoot = nullptr;
+        return;
+    }
+
+    if (_root != _flattenedRoot || _hierarchyVersion != Node::s_globalHierarchyVersion)
+    {
+        flatten();
+    }
+    else if (_transformVersion == Node::s_globalTransformVersion && _volatileNodes.empty())
+    {
+        // nothing changed since the last update
+        return;
+    }
+
+    // nodes are not thread safe, so the local transforms are copied on this thread
+    const int count = static_cast<int>(_nodes.size());
+    for (int i = 0; i < count; ++i)
+    {
+        Node* node = _nodes[i];
+        if (node->_transformSystemDirty)
+        {
+            _localTransforms[i] = node->getNodeToParentTransform();
+            node->_transformSystemDirty = false;
+            _dirty[i] = 1;
+        }
+    }
+
+    // their setters were not necessarily called, so they are copied every time
+    for (const auto index : _volatileNodes)
+    {
+        _localTransforms[index] = _nodes[index]->getNodeToParentTransform();
+        _dirty[index] = 1;
+    }
+
+    // the ancestors of the root are not part of the arrays
+    Node* rootParent = _root->getParent();
+    if (rootParent)
+    {
+        Mat4::multiply(rootParent->getNodeToWorldTransform(), _localTransforms[0], &_worldTransforms[0]);
+        _dirty[0] = 1;
+    }
+    else if (_dirty[0])
+    {
+        _worldTransforms[0] = _localTransforms[0];
+    }
+
+    if (_threadPool && !_ranges.empty())
+    {
+        for (const auto index : _serialNodes)
+        {
+            updateTransform(index);
+        }
+
+        _threadPool->parallelFor(_ranges.size(), 1, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                updateRange(_ranges[i].first, _ranges[i].second);
+            }
+        });
+    }
+    else
+    {
+        updateRange(1, count);
+    }
+
+    _updatedCount = std::count(_dirty.begin(), _dirty.end(), 1);
+    std::fill(_dirty.begin(), _dirty.end(), 0);
+
+    _hierarchyVersion = Node::s_globalHierarchyVersion;
+    _transformVersion = Node::s_globalTransformVersion;
+}
+
+const Mat4* TransformSystem::getNodeToWorldTransform(const Node* node) const
+{
+    if (_hierarchyVersion != Node::s_globalHierarchyVersion || _transformVersion != Node::s_globalTransformVersion)
+        return nullptr;
+
+    const int index = node->_transformSystemIndex;
+    if (index < 0 || index >= static_cast<int>(_nodes.size()) || _nodes[index] != node || _volatile[index])
+        return nullptr;
+
+    return &_worldTransforms[index];
+}
+
+void TransformSystem::flatten()
+{
+    _nodes.clear();
+    _parents.clear();
+
+    // iterative depth-first traversal: deep hierarchies must not overflow the stack
+    std::vector<std::pair<Node*, int>> stack;
+    stack.push_back(std::make_pair(_root, -1));
+    while (!stack.empty())
+    {
+        Node* node = stack.back().first;
+        const int parent = stack.back().second;
+        stack.pop_back();
+
+        const int index = static_cast<int>(_nodes.size());
+        node->_transformSystemIndex = index;
+        _nodes.push_back(node);
+        _parents.push_back(parent);
+
+        const auto& children = node->getChildren();
+        for (auto it = children.crbegin(); it != children.crend(); ++it)
+        {
+            stack.push_back(std::make_pair(*it, index));
+        }
+    }
+
+    const int count = static_cast<int>(_nodes.size());
+
+    // a subtree is contiguous, so it ends where the subtree of its last descendant ends
+    _subtreeEnds.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        _subtreeEnds[i] = i + 1;
+    }
+    for (int i = count - 1; i > 0; --i)
+    {
+        _subtreeEnds[_parents[i]] = std::max(_subtreeEnds[_parents[i]], _subtreeEnds[i]);
+    }
+
+    _localTransforms.resize(count);
+    _worldTransforms.resize(count);
+    _dirty.assign(count, 1);
+
+    _volatile.resize(count);
+    _volatileNodes.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        if (_nodes[i]->_transformVolatile)
+        {
+            _volatileNodes.push_back(i);
+        }
+        _volatile[i] = _nodes[i]->_transformVolatile || (i > 0 && _volatile[_parents[i]]);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        _localTransforms[i] = _nodes[i]->getNodeToParentTransform();
+        _nodes[i]->_transformSystemDirty = false;
+    }
+    _worldTransforms[0] = _localTransforms[0];
+
+    _flattenedRoot = _root;
+
+    buildRanges();
+}
+
+void TransformSystem::buildRanges()
+{
+    _serialNodes.clear();
+    _ranges.clear();
+
+    if (_threadPool == nullptr || _nodes.empty())
+        return;
+
+    // a few ranges per thread balance the work. Subtrees bigger than that are split in the subtrees of their children,
+    // and their root is updated first, on the calling thread
+    const int count = static_cast<int>(_nodes.size());
+    const int target = std::max(count / ((getThreadCount() + 1) * 4), static_cast<int>(MIN_RANGE_SIZE));
+
+    std::vector<int> stack;
+    for (int child = 1; child < count; child = _subtreeEnds[child])
+    {
+        stack.push_back(child);
+    }
+
+    while (!stack.empty())
+    {
+        const int index = stack.back();
+        stack.pop_back();
+
+        if (_subtreeEnds[index] - index <= target)
+        {
+            _ranges.push_back(std::make_pair(index, _subtreeEnds[index]));
+        }
+        else
+        {
+            _serialNodes.push_back(index);
+            for (int child = index + 1; child < _subtreeEnds[index]; child = _subtreeEnds[child])
+            {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void TransformSystem::updateRange(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        updateTransform(i);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,142 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCTRANSFORMSYSTEM_H__
+#define __CCTRANSFORMSYSTEM_H__
+
+#include <vector>
+#include <utility>
+
+#include "base/CCPlatformMacros.h"
+#include "math/CCMath.h"
+
+NS_CC_BEGIN
+
+class Node;
+class ThreadPool;
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** Computes the world transforms of a scene graph in a single flat pass.
+
+ The hierarchy is flattened in depth-first order into contiguous arrays of parent indices, local
+ transforms and world transforms, so the parent of a node is always stored before the node.
+ Only the nodes whose transform changed since the last update, and their descendants, are computed again.
+
+ The local transforms are copied from the nodes on the calling thread. The world transforms of independent
+ subtrees can then be computed by a ThreadPool, since they only read the arrays.
+
+ Nodes whose local transform is computed outside of the setters (see Node::setTransformVolatile) have their
+ local transform copied on every update, and they and their descendants are never served from the cache,
+ since their transform can change between two updates.
+ */
+class CC_DLL TransformSystem
+{
+public:
+    /** Minimum number of nodes in a subtree given to a worker thread */
+    static const int MIN_RANGE_SIZE = 256;
+
+    TransformSystem();
+    ~TransformSystem();
+
+    /** Sets the node whose subtree is updated. The node is not retained. */
+    void setRoot(Node* root);
+    Node* getRoot() const { return _root; }
+
+    /** Number of worker threads computing the world transforms. 0, the default, computes them on the calling thread. */
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    /** Copies the local transforms that changed and computes the world transforms. Must be called on the main thread. */
+    void update();
+
+    /** Returns the world transform computed by the last update, or nullptr if the node is not part of the root,
+     if a transform or the hierarchy changed since the last update, or if the node or one of its ancestors has a volatile transform.
+     */
+    const Mat4* getNodeToWorldTransform(const Node* node) const;
+
+    /** Returns the TransformSystem enabled in the Director, or nullptr if it is disabled */
+    static TransformSystem* getCurrent() { return s_current; }
+    /** Sets the TransformSystem returned by getCurrent(). Called by the Director. */
+    static void setCurrent(TransformSystem* transformSystem) { s_current = transformSystem; }
+
+    /** Number of nodes of the root, including the root */
+    ssize_t getNodeCount() const { return _nodes.size(); }
+
+    /** Number of world transforms computed by the last update */
+    ssize_t getUpdatedCount() const { return _updatedCount; }
+
+protected:
+    /** Rebuilds the arrays from the hierarchy of the root */
+    void flatten();
+
+    /** Splits the nodes in subtrees that can be updated concurrently */
+    void buildRanges();
+
+    /** Computes the world transforms of the nodes [begin, end) in order */
+    void updateRange(int begin, int end);
+
+    inline void updateTransform(int index);
+
+    Node* _root;
+    Node* _flattenedRoot;
+
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<int> _subtreeEnds;
+    std::vector<Mat4> _localTransforms;
+    std::vector<Mat4> _worldTransforms;
+    std::vector<unsigned char> _dirty;
+    /// 1 for the nodes with a volatile transform and their descendants
+    std::vector<unsigned char> _volatile;
+    /// nodes with a volatile transform, copied on every update
+    std::vector<int> _volatileNodes;
+
+    /// nodes updated on the calling thread, before the ranges
+    std::vector<int> _serialNodes;
+    /// independent subtrees, updated by the thread pool
+    std::vector<std::pair<int, int>> _ranges;
+
+    unsigned int _hierarchyVersion;
+    unsigned int _transformVersion;
+
+    ThreadPool* _threadPool;
+    ssize_t _updatedCount;
+
+    static TransformSystem* s_current;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TransformSystem);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTRANSFORMSYSTEM_H__
@@ -67,6 +67,7 @@ cocos2d.cpp \
 2d/CCTMXXMLParser.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTileMapAtlas.cpp \
+2d/CCTransformSystem.cpp \
 2d/CCTransition.cpp \
 2d/CCTransitionPageTurn.cpp \
 2d/CCTransitionProgress.cpp \
@@ -117,6 +118,9 @@ base/CCProfiling.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
+base/CCTaskQueue.cpp \
+base/CCThreadPool.cpp \
+base/CCTimerWheel.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault.cpp \
 base/CCUserDefaultAndroid.cpp \
@@ -139,13 +143,17 @@ renderer/CCGLProgramCache.cpp \
 renderer/CCGLProgramState.cpp \
 renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
+renderer/CCPixelConversion.cpp \
 renderer/CCQuadCommand.cpp \
 renderer/CCMeshCommand.cpp \
 renderer/CCRenderCommand.cpp \
+renderer/CCRenderArena.cpp \
 renderer/CCRenderer.cpp \
+renderer/CCStreamingVertexBuffer.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCTextureTranscoder.cpp \
 renderer/ccGLStateCache.cpp \
 renderer/ccShaders.cpp \
 deprecated/CCArray.cpp \
@@ -24,11 +24,185 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#include <typeinfo>
 
 NS_CC_BEGIN
 
+//--------------------------------------------------------------------
+//
+// RefArena
+//
+//--------------------------------------------------------------------
+
+namespace
+{
+    // every allocation starts with the block holding it, or nullptr when allocated by malloc
+    const size_t HEADER_SIZE = 16;
+    // blocks kept for reuse, the others are freed
+    const size_t MAX_FREE_BLOCKS = 32;
+
+    void* allocateWithMalloc(size_t size)
+    {
+        char* memory = static_cast<char*>(malloc(HEADER_SIZE + size));
+        CCASSERT(memory, "Out of memory");
+        if (memory == nullptr)
+            return nullptr;
+        *reinterpret_cast<void**>(memory) = nullptr;
+        return memory + HEADER_SIZE;
+    }
+}
+
+RefArena* RefArena::s_instance = nullptr;
+
+RefArena* RefArena::getInstance()
+{
+    if (s_instance == nullptr)
+    {
+        s_instance = new RefArena();
+    }
+    return s_instance;
+}
+
+void RefArena::destroyInstance()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+RefArena::RefArena()
+: _threadId(std::this_thread::get_id())
+, _enabled(false)
+, _currentBlock(nullptr)
+, _allocations(0)
+{
+}
+
+RefArena::~RefArena()
+{
+    for (auto block : _freeBlocks)
+    {
+        free(block->data);
+        delete block;
+    }
+
+    for (auto block : _blocks)
+    {
+        // the objects still alive free their block with the last of them, see deallocate()
+        if (block->objects.fetch_add(ORPHANED_BLOCK, std::memory_order_acq_rel) == 0)
+        {
+            free(block->data);
+            delete block;
+        }
+    }
+}
+
+void* RefArena::allocate(size_t size)
+{
+    RefArena* arena = s_instance;
+    if (arena && std::this_thread::get_id() == arena->_threadId && arena->_enabled && size <= MAX_OBJECT_SIZE)
+    {
+        return arena->allocateInBlock(size);
+    }
+    return allocateWithMalloc(size);
+}
+
+void RefArena::deallocate(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    char* memory = static_cast<char*>(ptr) - HEADER_SIZE;
+    Block* block = *reinterpret_cast<Block**>(memory);
+    if (block)
+    {
+        // the memory is reclaimed by collect(), or here for the last object of a block left by the destroyed arena
+        if (block->objects.fetch_sub(1, std::memory_order_acq_rel) == ORPHANED_BLOCK + 1)
+        {
+            free(block->data);
+            delete block;
+        }
+    }
+    else
+    {
+        free(memory);
+    }
+}
+
+void* RefArena::allocateInBlock(size_t size)
+{
+    size = (HEADER_SIZE + size + 15) & ~static_cast<size_t>(15);
+
+    if (_currentBlock == nullptr || _currentBlock->used + size > BLOCK_SIZE)
+    {
+        Block* block = nullptr;
+        if (!_freeBlocks.empty())
+        {
+            block = _freeBlocks.back();
+            _freeBlocks.pop_back();
+        }
+        else
+        {
+            char* data = static_cast<char*>(malloc(BLOCK_SIZE));
+            if (data == nullptr)
+                return allocateWithMalloc(size - HEADER_SIZE);
+            block = new Block();
+            block->data = data;
+            block->objects.store(0, std::memory_order_relaxed);
+        }
+        block->used = 0;
+        _blocks.push_back(block);
+        _currentBlock = block;
+    }
+
+    char* memory = _currentBlock->data + _currentBlock->used;
+    _currentBlock->used += size;
+    _currentBlock->objects.fetch_add(1, std::memory_order_relaxed);
+    *reinterpret_cast<Block**>(memory) = _currentBlock;
+    ++_allocations;
+    return memory + HEADER_SIZE;
+}
+
+void RefArena::collect()
+{
+    CCASSERT(std::this_thread::get_id() == _threadId, "RefArena::collect() must be called in the cocos thread");
+
+    size_t kept = 0;
+    for (size_t i = 0; i < _blocks.size(); ++i)
+    {
+        Block* block = _blocks[i];
+        if (block->objects.load(std::memory_order_acquire) != 0)
+        {
+            _blocks[kept++] = block;
+        }
+        else if (block == _currentBlock)
+        {
+            // keep filling it from the start
+            block->used = 0;
+            _blocks[kept++] = block;
+        }
+        else if (_freeBlocks.size() < MAX_FREE_BLOCKS)
+        {
+            _freeBlocks.push_back(block);
+        }
+        else
+        {
+            free(block->data);
+            delete block;
+        }
+    }
+    _blocks.resize(kept);
+    _allocations = 0;
+}
+
+//--------------------------------------------------------------------
+//
+// AutoreleasePool
+//
+//--------------------------------------------------------------------
+
 AutoreleasePool::AutoreleasePool()
 : _name("")
+, _typeStatisticsEnabled(false)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -39,6 +213,7 @@ AutoreleasePool::AutoreleasePool()
 
 AutoreleasePool::AutoreleasePool(const std::string &name)
 : _name(name)
+, _typeStatisticsEnabled(false)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -65,14 +240,31 @@ void AutoreleasePool::clear()
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = true;
 #endif
+    _statistics.autoreleasedObjects = _managedObjectArray.size();
+    _statistics.destroyedObjects = 0;
+    if (!_statistics.types.empty())
+        _statistics.types.clear();
+
     for (const auto &obj : _managedObjectArray)
     {
+        if (_typeStatisticsEnabled)
+            ++_statistics.types[typeid(*obj).name()];
+        if (obj->getReferenceCount() == 1)
+            ++_statistics.destroyedObjects;
         obj->release();
     }
     _managedObjectArray.clear();
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
 #endif
+
+    // the objects created in the frame are released, their blocks can be reused. Only for the frame pool:
+    // the other pools may be cleared in other threads
+    PoolManager* poolManager = PoolManager::s_singleInstance;
+    if (poolManager && !poolManager->_releasePoolStack.empty() && poolManager->_releasePoolStack.front() == this)
+    {
+        RefArena::getInstance()->collect();
+    }
 }
 
 bool AutoreleasePool::contains(Ref* object) const
@@ -109,6 +301,8 @@ PoolManager* PoolManager::getInstance()
 {
     if (s_singleInstance == nullptr)
     {
+        // the objects are allocated in the arena in the thread creating the pools
+        RefArena::getInstance();
         s_singleInstance = new PoolManager();
         // Add the first auto release pool
         s_singleInstance->_curReleasePool = new AutoreleasePool("cocos2d autorelease pool");
@@ -121,6 +315,8 @@ void PoolManager::destroyInstance()
 {
     delete s_singleInstance;
     s_singleInstance = nullptr;
+
+    RefArena::destroyInstance();
 }
 
 PoolManager::PoolManager()
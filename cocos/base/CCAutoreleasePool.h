@@ -25,9 +25,13 @@ THE SOFTWARE.
 #ifndef __AUTORELEASEPOOL_H__
 #define __AUTORELEASEPOOL_H__
 
+#include <atomic>
+#include <new>
 #include <stack>
+#include <thread>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "base/CCRef.h"
 
 NS_CC_BEGIN
@@ -37,9 +41,108 @@ NS_CC_BEGIN
  * @{
  */
 
+/** Arena of the short-lived Ref objects, like the actions created and discarded in the same frame.
+
+ The objects of the classes declaring CC_FRAME_ALLOCATED, created in the cocos thread, are allocated by bumping a
+ pointer in the current block of the arena instead of by malloc, and destroying them only decrements the count of
+ objects of their block. The blocks whose objects are all destroyed are reused, which is checked when the frame
+ autorelease pool of the PoolManager is cleared: the objects which never escape the frame cost neither a malloc nor a free.
+ The ones which are retained keep their block until they are destroyed.
+ Disabled by default, see setEnabled().
+ */
+class CC_DLL RefArena
+{
+public:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    /** The bigger objects, and the ones created in the other threads, are allocated by malloc */
+    static const size_t MAX_OBJECT_SIZE = 1024;
+
+    /** The arena, created with the PoolManager in the cocos thread */
+    static RefArena* getInstance();
+    /** Frees the arena, called by PoolManager::destroyInstance().
+     The blocks still holding objects are freed when their last object is destroyed.
+     */
+    static void destroyInstance();
+
+    /** Allocates the memory of an object, used by CC_FRAME_ALLOCATED. Can be called from any thread */
+    static void* allocate(size_t size);
+    /** Frees the memory of an object, used by CC_FRAME_ALLOCATED. Can be called from any thread */
+    static void deallocate(void* ptr);
+
+    /** When disabled, the objects are allocated by malloc. Disabled by default.
+     @warning Every object kept after its frame, like a Sequence run by a RepeatForever or an action stored to be run later,
+     keeps its whole block of BLOCK_SIZE bytes allocated. Only enable it if such objects are rare.
+     */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /** Makes the blocks whose objects were all destroyed available again.
+     Called in the cocos thread when the frame pool of the PoolManager is cleared.
+     */
+    void collect();
+
+    /** Number of blocks allocated by the arena */
+    size_t getBlockCount() const { return _blocks.size() + _freeBlocks.size(); }
+    /** Number of blocks which hold objects, or are being filled */
+    size_t getUsedBlockCount() const { return _blocks.size(); }
+    /** Number of objects allocated in the arena since the previous collect() */
+    unsigned int getAllocationCount() const { return _allocations; }
+
+protected:
+    struct Block
+    {
+        std::atomic<int> objects;
+        size_t used;
+        char* data;
+    };
+
+    // added to the count of objects of the blocks left when the arena is destroyed
+    static const int ORPHANED_BLOCK = 1 << 30;
+
+    RefArena();
+    ~RefArena();
+    void* allocateInBlock(size_t size);
+
+    static RefArena* s_instance;
+
+    std::thread::id _threadId;
+    bool _enabled;
+    Block* _currentBlock;
+    std::vector<Block*> _blocks;
+    std::vector<Block*> _freeBlocks;
+    unsigned int _allocations;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(RefArena);
+};
+
+/** Allocates the objects of a class, and of its subclasses, in the RefArena. To put in a public section of the class.
+ For the classes whose objects are often created for a single frame.
+ */
+#define CC_FRAME_ALLOCATED \
+    static void* operator new(std::size_t size) { return cocos2d::RefArena::allocate(size); } \
+    static void* operator new(std::size_t size, const std::nothrow_t&) { return cocos2d::RefArena::allocate(size); } \
+    static void* operator new(std::size_t, void* where) { return where; } \
+    static void operator delete(void* ptr) { cocos2d::RefArena::deallocate(ptr); } \
+    static void operator delete(void* ptr, const std::nothrow_t&) { cocos2d::RefArena::deallocate(ptr); } \
+    static void operator delete(void*, void*) {}
+
 class CC_DLL AutoreleasePool
 {
 public:
+    /** What the last clear() released */
+    struct Statistics
+    {
+        Statistics() : autoreleasedObjects(0), destroyedObjects(0) {}
+
+        /** Number of autorelease() calls, an object autoreleased twice counts twice */
+        size_t autoreleasedObjects;
+        /** Number of objects destroyed because the pool released them */
+        size_t destroyedObjects;
+        /** Number of autoreleased objects per type name, when the type statistics are enabled */
+        std::unordered_map<std::string, size_t> types;
+    };
+
     /**
      * @warn Don't create an auto release pool in heap, create it in stack.
      * @js NA
@@ -101,6 +204,13 @@ public:
      *
      */
     void dump();
+
+    /** Statistics of the last clear() */
+    const Statistics& getStatistics() const { return _statistics; }
+
+    /** Counts the autoreleased objects per type in the statistics. It looks up the type of every object, so it's disabled by default */
+    void setTypeStatisticsEnabled(bool enabled) { _typeStatisticsEnabled = enabled; }
+    bool isTypeStatisticsEnabled() const { return _typeStatisticsEnabled; }
     
 private:
     /**
@@ -114,6 +224,8 @@ private:
      */
     std::vector<Ref*> _managedObjectArray;
     std::string _name;
+    Statistics _statistics;
+    bool _typeStatisticsEnabled;
     
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     /**
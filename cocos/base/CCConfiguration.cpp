@@ -47,6 +47,7 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsMapBufferRange(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -142,6 +143,9 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    _supportsMapBufferRange = checkForGLExtension("map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -247,6 +251,16 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+    // GLES2 only exposes it through GL_EXT_map_buffer_range, which is not available on every platform
+#if defined(GL_MAP_WRITE_BIT)
+    return _supportsMapBufferRange;
+#else
+    return false;
+#endif
+}
+
 //
 // generic getters for properties
 //
@@ -110,6 +110,11 @@ public:
      */
 	bool supportsShareableVAO() const;
 
+    /** Whether or not glMapBufferRange (or GL_EXT_map_buffer_range) can be used to write into a range of a VBO.
+     @since v3.2
+     */
+    bool supportsMapBufferRange() const;
+
     /** returns whether or not an OpenGL is supported */
     bool checkForGLExtension(const std::string &searchName) const;
 
@@ -146,6 +151,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -29,20 +29,32 @@
 
 #include <string>
 
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#define CC_DATA_USE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 NS_CC_BEGIN
 
 const Data Data::Null;
 
 Data::Data() :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapped(false)
 {
     CCLOGINFO("In the empty constructor of Data.");
 }
 
 Data::Data(Data&& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapped(false)
 {
     CCLOGINFO("In the move constructor of Data.");
     move(other);
@@ -50,7 +62,8 @@ _size(0)
 
 Data::Data(const Data& other) :
 _bytes(nullptr),
-_size(0)
+_size(0),
+_mapped(false)
 {
     CCLOGINFO("In the copy constructor of Data.");
     copy(other._bytes, other._size);
@@ -78,11 +91,15 @@ Data& Data::operator= (Data&& other)
 
 void Data::move(Data& other)
 {
+    clear();
+    
     _bytes = other._bytes;
     _size = other._size;
+    _mapped = other._mapped;
     
     other._bytes = nullptr;
     other._size = 0;
+    other._mapped = false;
 }
 
 bool Data::isNull() const
@@ -100,6 +117,11 @@ ssize_t Data::getSize() const
     return _size;
 }
 
+bool Data::isMapped() const
+{
+    return _mapped;
+}
+
 void Data::copy(unsigned char* bytes, const ssize_t size)
 {
     clear();
@@ -116,13 +138,90 @@ void Data::fastSet(unsigned char* bytes, const ssize_t size)
 {
     _bytes = bytes;
     _size = size;
+    _mapped = false;
 }
 
 void Data::clear()
 {
-    free(_bytes);
+    if (_mapped)
+    {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+        UnmapViewOfFile(_bytes);
+#elif defined(CC_DATA_USE_MMAP)
+        munmap(_bytes, _size);
+#endif
+    }
+    else
+    {
+        free(_bytes);
+    }
     _bytes = nullptr;
     _size = 0;
+    _mapped = false;
+}
+
+Data Data::mapFile(const std::string& fullPath)
+{
+    Data ret;
+    if (fullPath.empty())
+    {
+        return ret;
+    }
+    
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    WCHAR wszBuf[MAX_PATH] = {0};
+    if (MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, MAX_PATH) == 0)
+    {
+        return ret;
+    }
+    
+    HANDLE file = CreateFileW(wszBuf, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return ret;
+    }
+    
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.HighPart == 0)
+    {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            void* bytes = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            // the view keeps the mapping object alive
+            CloseHandle(mapping);
+            if (bytes != nullptr)
+            {
+                ret._bytes = static_cast<unsigned char*>(bytes);
+                ret._size = static_cast<ssize_t>(size.LowPart);
+                ret._mapped = true;
+            }
+        }
+    }
+    CloseHandle(file);
+#elif defined(CC_DATA_USE_MMAP)
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return ret;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* bytes = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (bytes != MAP_FAILED)
+        {
+            ret._bytes = static_cast<unsigned char*>(bytes);
+            ret._size = static_cast<ssize_t>(st.st_size);
+            ret._mapped = true;
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+#endif
+    
+    return ret;
 }
 
 NS_CC_END
@@ -38,6 +38,19 @@ class CC_DLL Data
 public:
     static const Data Null;
     
+    /** Maps the file at fullPath into memory instead of reading it.
+     *  Pages are only loaded by the system when they are touched, and they can be
+     *  dropped again under memory pressure since they are backed by the file.
+     *  The mapping is private, so the bytes have to be treated as read only: a write
+     *  never reaches the file, it makes a private copy of the page instead.
+     *  The mapping is released when the Data is cleared or destroyed.
+     *  @param fullPath The absolute path of the file.
+     *  @return The mapped data, or Data::Null if the file can't be mapped on this platform.
+     *  @see FileUtils::getMappedDataFromFile
+     *  @since v3.2
+     */
+    static Data mapFile(const std::string& fullPath);
+    
     Data();
     Data(const Data& other);
     Data(Data&& other);
@@ -80,12 +93,18 @@ public:
     /** Check whether the data is null. */
     bool isNull() const;
     
+    /** Check whether the buffer is a file mapping created by Data::mapFile.
+     *  @since v3.2
+     */
+    bool isMapped() const;
+    
 private:
     void move(Data& other);
     
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    bool _mapped;
 };
 
 NS_CC_END
@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
+#include "2d/CCTransformSystem.h"
 #include "base/CCUserDefault.h"
 #include "base/ccFPSImages.h"
 #include "base/CCScheduler.h"
@@ -113,12 +114,16 @@ bool Director::init(void)
 
     _notificationNode = nullptr;
 
+    _transformSystem = nullptr;
+    _lazyMatrixStackEnabled = CC_ENABLE_LAZY_MATRIX_STACK;
+    _mainThreadId = std::this_thread::get_id();
+
     _scenesStack.reserve(15);
 
     // FPS
     _accumDt = 0.0f;
     _frameRate = 0.0f;
-    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
+    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = _culledNodesLabel = nullptr;
     _totalFrames = _frames = 0;
     _lastUpdate = new struct timeval;
 
@@ -170,6 +175,7 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_culledNodesLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -183,6 +189,7 @@ Director::~Director(void)
     delete _eventProjectionChanged;
 
     delete _renderer;
+    CC_SAFE_DELETE(_transformSystem);
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
     delete _console;
@@ -288,7 +295,14 @@ void Director::drawScene()
     // draw the scene
     if (_runningScene)
     {
+        if (_transformSystem)
+        {
+            _transformSystem->setRoot(_runningScene);
+            _transformSystem->update();
+        }
+
         _runningScene->visit(_renderer, Mat4::IDENTITY, false);
+        _renderer->finishConcurrentVisits();
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
     }
 
@@ -452,6 +466,70 @@ void Director::initMatrixStack()
     _modelViewMatrixStack.push(Mat4::IDENTITY);
     _projectionMatrixStack.push(Mat4::IDENTITY);
     _textureMatrixStack.push(Mat4::IDENTITY);
+
+    _lazyModelViewStack.clear();
+    _modelViewLazyDepths.clear();
+    _modelViewLazyDepths.push_back(0);
+}
+
+void Director::flushLazyModelView()
+{
+    // the matrix pushed by the last pushModelViewMatrix() is not in the stack yet
+    if (_lazyModelViewStack.size() > _modelViewLazyDepths.back())
+    {
+        _modelViewMatrixStack.push(*_lazyModelViewStack.back());
+        _modelViewLazyDepths.push_back(_lazyModelViewStack.size());
+    }
+}
+
+bool Director::isVisitedByWorkerThread() const
+{
+    return _renderer->getVisitThreadCount() > 0 && std::this_thread::get_id() != _mainThreadId;
+}
+
+void Director::pushModelViewMatrix(const Mat4& mat)
+{
+    if (isVisitedByWorkerThread())
+        return;
+
+    if (_lazyMatrixStackEnabled)
+    {
+        _lazyModelViewStack.push_back(&mat);
+    }
+    else
+    {
+        pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, mat);
+    }
+}
+
+void Director::popModelViewMatrix()
+{
+    if (isVisitedByWorkerThread())
+        return;
+
+    if (_lazyMatrixStackEnabled)
+    {
+        CCASSERT(!_lazyModelViewStack.empty(), "popModelViewMatrix() without pushModelViewMatrix()");
+        _lazyModelViewStack.pop_back();
+
+        // discards the copy of the matrix, if it was read
+        while (_modelViewLazyDepths.back() > _lazyModelViewStack.size())
+        {
+            _modelViewMatrixStack.pop();
+            _modelViewLazyDepths.pop_back();
+        }
+    }
+    else
+    {
+        popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+}
+
+void Director::setLazyMatrixStackEnabled(bool enabled)
+{
+    CCASSERT(_lazyModelViewStack.empty(), "The lazy matrix stack can't be changed while visiting a scene");
+    _lazyMatrixStackEnabled = enabled;
 }
 
 void Director::resetMatrixStack()
@@ -464,6 +542,7 @@ void Director::popMatrix(MATRIX_STACK_TYPE type)
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.pop();
+        _modelViewLazyDepths.pop_back();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -483,6 +562,7 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
+        flushLazyModelView();
         _modelViewMatrixStack.top() = Mat4::IDENTITY;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
@@ -503,6 +583,7 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
+        flushLazyModelView();
         _modelViewMatrixStack.top() = mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
@@ -523,6 +604,7 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
+        flushLazyModelView();
         _modelViewMatrixStack.top() *= mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
@@ -543,7 +625,9 @@ void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
+        flushLazyModelView();
         _modelViewMatrixStack.push(_modelViewMatrixStack.top());
+        _modelViewLazyDepths.push_back(_lazyModelViewStack.size());
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -564,6 +648,7 @@ Mat4 Director::getMatrix(MATRIX_STACK_TYPE type)
     Mat4 result;
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
+        flushLazyModelView();
         result = _modelViewMatrixStack.top();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
@@ -950,6 +1035,7 @@ void Director::purgeDirector()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_culledNodesLabel);
 
     // purge bitmap cache
     FontFNT::purgeCachedData();
@@ -1057,11 +1143,12 @@ void Director::showStats()
 {
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned long prevCulled = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _culledNodesLabel)
     {
         char buffer[30];
 
@@ -1089,8 +1176,16 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        auto currentCulled = (unsigned long)_renderer->getCulledNodes();
+        if( currentCulled != prevCulled) {
+            sprintf(buffer, "Culled:%8lu", currentCulled);
+            _culledNodesLabel->setString(buffer);
+            prevCulled = currentCulled;
+        }
+
         Mat4 identity = Mat4::IDENTITY;
 
+        _culledNodesLabel->visit(_renderer, identity, false);
         _drawnVerticesLabel->visit(_renderer, identity, false);
         _drawnBatchesLabel->visit(_renderer, identity, false);
         _FPSLabel->visit(_renderer, identity, false);
@@ -1122,6 +1217,7 @@ void Director::createStatsLabel()
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_culledNodesLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1170,10 +1266,17 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString("00000", texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _culledNodesLabel = LabelAtlas::create();
+    _culledNodesLabel->retain();
+    _culledNodesLabel->setIgnoreContentScaleFactor(true);
+    _culledNodesLabel->initWithString("Culled:       0", texture, 12, 32, '.');
+    _culledNodesLabel->setScale(scaleFactor);
+
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _culledNodesLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -1225,6 +1328,19 @@ void Director::setEventDispatcher(EventDispatcher* dispatcher)
     }
 }
 
+void Director::setTransformSystemEnabled(bool enabled)
+{
+    if (enabled && _transformSystem == nullptr)
+    {
+        _transformSystem = new TransformSystem();
+        TransformSystem::setCurrent(_transformSystem);
+    }
+    else if (!enabled)
+    {
+        CC_SAFE_DELETE(_transformSystem);
+    }
+}
+
 /***************************************************
 * implementation of DisplayLinkDirector
 **************************************************/
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "CCGL.h"
 #include "2d/CCLabelAtlas.h"
 #include <stack>
+#include <thread>
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
@@ -59,6 +60,7 @@ class EventCustom;
 class EventListenerCustom;
 class TextureCache;
 class Renderer;
+class TransformSystem;
 
 #if  (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
 class Console;
@@ -97,9 +99,34 @@ private:
     std::stack<Mat4> _modelViewMatrixStack;
     std::stack<Mat4> _projectionMatrixStack;
     std::stack<Mat4> _textureMatrixStack;
+
+    // lazy modelview stack: addresses of the matrices pushed by pushModelViewMatrix(), and for every
+    // entry of _modelViewMatrixStack, the size of _lazyModelViewStack when it was pushed
+    std::vector<const Mat4*> _lazyModelViewStack;
+    std::vector<size_t> _modelViewLazyDepths;
+    bool _lazyMatrixStackEnabled;
+
+    // the nodes visited by the worker threads of the renderer don't use the matrix stack
+    std::thread::id _mainThreadId;
+
+    void flushLazyModelView();
+    bool isVisitedByWorkerThread() const;
 protected:
     void initMatrixStack();
 public:
+    /** visit() helper: the modelview matrix is `mat` until the matching popModelViewMatrix().
+     When the lazy matrix stack is enabled only the address of `mat` is kept, and it is copied to the modelview stack
+     only if the stack is read or modified before popModelViewMatrix(). So `mat` must not change until then.
+     */
+    void pushModelViewMatrix(const Mat4& mat);
+    void popModelViewMatrix();
+
+    /** Enables or disables the lazy matrix stack. Its default value is CC_ENABLE_LAZY_MATRIX_STACK.
+     It can't be changed while a scene is visited.
+     */
+    void setLazyMatrixStackEnabled(bool enabled);
+    bool isLazyMatrixStackEnabled() const { return _lazyMatrixStackEnabled; }
+
     void pushMatrix(MATRIX_STACK_TYPE type);
     void popMatrix(MATRIX_STACK_TYPE type);
     void loadIdentityMatrix(MATRIX_STACK_TYPE type);
@@ -389,6 +416,17 @@ public:
      */
     Renderer* getRenderer() const { return _renderer; }
 
+    /** Enables or disables the flat transform pass.
+     When enabled, the world transforms of the running scene are computed once per frame, before it is visited,
+     and Node::getNodeToWorldTransform() returns them instead of walking the ancestors of the node.
+     Disabled by default.
+     */
+    void setTransformSystemEnabled(bool enabled);
+    bool isTransformSystemEnabled() const { return _transformSystem != nullptr; }
+
+    /** Returns the TransformSystem, or nullptr if it is disabled */
+    TransformSystem* getTransformSystem() const { return _transformSystem; }
+
     /** Returns the Console 
      @since v3.0
      */
@@ -460,6 +498,7 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_culledNodesLabel;
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -503,6 +542,9 @@ protected:
     /* Renderer for the Director */
     Renderer *_renderer;
 
+    /* Computes the world transforms of the running scene. nullptr when disabled */
+    TransformSystem *_transformSystem;
+
 #if  (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
     /* Console for the director */
     Console *_console;
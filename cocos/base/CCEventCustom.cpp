@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "base/CCEventCustom.h"
+#include "base/CCEventListener.h"
 #include "base/ccMacros.h"
 #include <functional>
 
@@ -31,8 +32,20 @@ NS_CC_BEGIN
 EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
-, _eventName(eventName)
+, _eventID(EventListener::internListenerID(eventName))
 {
 }
 
+EventCustom::EventCustom(int eventID)
+: Event(Type::CUSTOM)
+, _userData(nullptr)
+, _eventID(eventID)
+{
+}
+
+const std::string& EventCustom::getEventName() const
+{
+    return EventListener::getInternedListenerID(_eventID);
+}
+
 NS_CC_END
@@ -27,6 +27,8 @@
 
 #include "base/CCEvent.h"
 
+#include <string>
+
 NS_CC_BEGIN
 
 class EventCustom : public Event
@@ -35,6 +37,9 @@ public:
     /** Constructor */
     EventCustom(const std::string& eventName);
     
+    /** Constructor with an event ID interned by `EventListener::internListenerID` */
+    explicit EventCustom(int eventID);
+    
     /** Sets user data */
     inline void setUserData(void* data) { _userData = data; };
     
@@ -42,10 +47,13 @@ public:
     inline void* getUserData() const { return _userData; };
     
     /** Gets event name */
-    inline const std::string& getEventName() const { return _eventName; };
+    const std::string& getEventName() const;
+    
+    /** Gets the interned ID of the event name */
+    inline int getEventID() const { return _eventID; };
 protected:
     void* _userData;       ///< User data
-    std::string _eventName;
+    int _eventID;          ///< Interned event name
 };
 
 NS_CC_END
@@ -66,28 +66,42 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+static int __getTouchOneByOneListenerID()
 {
-    EventListener::ListenerID ret;
+    static const int listenerID = EventListener::internListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+    return listenerID;
+}
+
+static int __getTouchAllAtOnceListenerID()
+{
+    static const int listenerID = EventListener::internListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+    return listenerID;
+}
+
+static int __getListenerID(Event* event)
+{
+    static const int accelerationID = EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID);
+    static const int keyboardID = EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID);
+    static const int mouseID = EventListener::internListenerID(EventListenerMouse::LISTENER_ID);
+    static const int focusID = EventListener::internListenerID(EventListenerFocus::LISTENER_ID);
+    
+    int ret = -1;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
+            ret = accelerationID;
             break;
         case Event::Type::CUSTOM:
-            {
-                auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
-            }
+            ret = static_cast<EventCustom*>(event)->getEventID();
             break;
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
+            ret = keyboardID;
             break;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
+            ret = mouseID;
             break;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
+            ret = focusID;
             break;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
@@ -192,18 +206,337 @@ void EventDispatcher::EventListenerVector::clear()
     clearFixedListeners();
 }
 
+////////////////////////////////////////////////////////
+//
+// TouchListenerIndex
+//
+////////////////////////////////////////////////////////
+
+/** Uniform grid of the world bounds of the scene graph priority touch listeners which have a content hit test.
+ *  The listeners without the hint are kept aside, so a query returns every listener which may claim a touch,
+ *  sorted by scene graph priority.
+ */
+class EventDispatcher::TouchListenerIndex
+{
+public:
+    TouchListenerIndex();
+    ~TouchListenerIndex();
+    
+    /** Marks the membership and the priority order of the index as stale */
+    inline void setStale() { _stale = true; };
+    
+    /** Releases all the entries */
+    void clear();
+    
+    /** Syncs the index with the sorted scene graph priority listeners if it's stale,
+     *  then recomputes the bounds of the entries whose node transform changed.
+     */
+    void update(const std::vector<EventListener*>& sceneGraphListeners);
+    
+    /** Gets, in priority order, the listeners which may claim a touch at the location */
+    void query(const Vec2& location, std::vector<EventListener*>& listeners);
+    
+private:
+    struct Entry
+    {
+        EventListenerTouchOneByOne* listener;
+        Node* node;
+        ssize_t order;
+        unsigned int transformVersion;
+        unsigned int syncStamp;
+        bool boundsValid;
+        bool large;
+        Rect bounds;
+        int cellX0, cellY0, cellX1, cellY1;
+    };
+    
+    static long long getCellKey(int x, int y);
+    void updateBounds(Entry* entry);
+    void insertIntoCells(Entry* entry);
+    void removeFromCells(Entry* entry);
+    
+    std::unordered_map<EventListener*, Entry> _entries;
+    std::unordered_map<long long, std::vector<Entry*>> _cells;
+    std::vector<Entry*> _largeEntries;
+    std::vector<std::pair<ssize_t, EventListener*>> _unindexedListeners;
+    std::vector<Entry*> _candidates;
+    unsigned int _syncStamp;
+    bool _stale;
+    
+    CC_DISALLOW_COPY_AND_ASSIGN(TouchListenerIndex);
+};
+
+// Side of a grid cell in points
+static const float TOUCH_INDEX_CELL_SIZE = 64.0f;
+// Entries covering more cells are tested for every query instead
+static const int TOUCH_INDEX_MAX_CELLS_PER_ENTRY = 64;
+// Margin added to the bounds, since the index must not reject touches on the border of a node
+static const float TOUCH_INDEX_BOUNDS_MARGIN = 1.0f;
+
+EventDispatcher::TouchListenerIndex::TouchListenerIndex()
+: _syncStamp(0)
+, _stale(true)
+{
+}
+
+EventDispatcher::TouchListenerIndex::~TouchListenerIndex()
+{
+    clear();
+}
+
+void EventDispatcher::TouchListenerIndex::clear()
+{
+    for (auto& e : _entries)
+    {
+        e.second.listener->release();
+    }
+    
+    _entries.clear();
+    _cells.clear();
+    _largeEntries.clear();
+    _unindexedListeners.clear();
+    _stale = true;
+}
+
+long long EventDispatcher::TouchListenerIndex::getCellKey(int x, int y)
+{
+    return (long long)(((unsigned long long)(unsigned int)x << 32) | (unsigned int)y);
+}
+
+void EventDispatcher::TouchListenerIndex::update(const std::vector<EventListener*>& sceneGraphListeners)
+{
+    if (_stale)
+    {
+        _stale = false;
+        ++_syncStamp;
+        _unindexedListeners.clear();
+        
+        for (ssize_t i = 0; i < static_cast<ssize_t>(sceneGraphListeners.size()); ++i)
+        {
+            auto l = static_cast<EventListenerTouchOneByOne*>(sceneGraphListeners[i]);
+            if (!l->_contentHitTest || l->getAssociatedNode() == nullptr)
+            {
+                _unindexedListeners.push_back(std::make_pair(i, l));
+                continue;
+            }
+            
+            auto iter = _entries.find(l);
+            if (iter == _entries.end())
+            {
+                // The entry retains its listener, so the address can't be reused by a new listener while it's indexed.
+                l->retain();
+                Entry& entry = _entries[l];
+                entry.listener = l;
+                entry.node = l->getAssociatedNode();
+                entry.boundsValid = false;
+                entry.large = false;
+                entry.order = i;
+                entry.syncStamp = _syncStamp;
+            }
+            else
+            {
+                Entry& entry = iter->second;
+                if (entry.node != l->getAssociatedNode())
+                {
+                    removeFromCells(&entry);
+                    entry.node = l->getAssociatedNode();
+                    entry.boundsValid = false;
+                }
+                entry.order = i;
+                entry.syncStamp = _syncStamp;
+            }
+        }
+        
+        // Removes the entries of the listeners which are not in the scene graph priority list anymore
+        for (auto iter = _entries.begin(); iter != _entries.end();)
+        {
+            Entry& entry = iter->second;
+            if (entry.syncStamp != _syncStamp)
+            {
+                removeFromCells(&entry);
+                entry.listener->release();
+                iter = _entries.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+    
+    for (auto& e : _entries)
+    {
+        Entry& entry = e.second;
+        if (!entry.listener->_contentHitTest)
+        {
+            // The hint was removed after the listener was indexed
+            _stale = true;
+        }
+        else if (!entry.boundsValid || entry.transformVersion != entry.node->getTransformVersion())
+        {
+            updateBounds(&entry);
+        }
+    }
+    
+    if (_stale)
+    {
+        update(sceneGraphListeners);
+    }
+}
+
+void EventDispatcher::TouchListenerIndex::updateBounds(Entry* entry)
+{
+    Node* node = entry->node;
+    const Size& size = node->getContentSize();
+    Rect bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), node->getNodeToWorldTransform());
+    bounds.origin.x -= TOUCH_INDEX_BOUNDS_MARGIN;
+    bounds.origin.y -= TOUCH_INDEX_BOUNDS_MARGIN;
+    bounds.size.width += TOUCH_INDEX_BOUNDS_MARGIN * 2;
+    bounds.size.height += TOUCH_INDEX_BOUNDS_MARGIN * 2;
+    
+    float cellX0 = floorf(bounds.getMinX() / TOUCH_INDEX_CELL_SIZE);
+    float cellY0 = floorf(bounds.getMinY() / TOUCH_INDEX_CELL_SIZE);
+    float cellX1 = floorf(bounds.getMaxX() / TOUCH_INDEX_CELL_SIZE);
+    float cellY1 = floorf(bounds.getMaxY() / TOUCH_INDEX_CELL_SIZE);
+    // Also catches the bounds which are too far to be converted to cell coordinates
+    bool large = !((cellX1 - cellX0 + 1) * (cellY1 - cellY0 + 1) <= TOUCH_INDEX_MAX_CELLS_PER_ENTRY
+        && fabsf(cellX0) < 1e6f && fabsf(cellY0) < 1e6f);
+    if (large)
+    {
+        cellX0 = cellY0 = cellX1 = cellY1 = 0;
+    }
+    
+    // Only moves the entry between cells if it changed cells
+    bool sameCells = entry->boundsValid && entry->large == large
+        && entry->cellX0 == (int)cellX0 && entry->cellY0 == (int)cellY0 && entry->cellX1 == (int)cellX1 && entry->cellY1 == (int)cellY1;
+    
+    if (!sameCells)
+    {
+        removeFromCells(entry);
+    }
+    
+    entry->bounds = bounds;
+    entry->large = large;
+    entry->cellX0 = (int)cellX0;
+    entry->cellY0 = (int)cellY0;
+    entry->cellX1 = (int)cellX1;
+    entry->cellY1 = (int)cellY1;
+    entry->transformVersion = node->getTransformVersion();
+    
+    if (!sameCells)
+    {
+        insertIntoCells(entry);
+    }
+    entry->boundsValid = true;
+}
+
+void EventDispatcher::TouchListenerIndex::insertIntoCells(Entry* entry)
+{
+    if (entry->large)
+    {
+        _largeEntries.push_back(entry);
+        return;
+    }
+    
+    for (int y = entry->cellY0; y <= entry->cellY1; ++y)
+    {
+        for (int x = entry->cellX0; x <= entry->cellX1; ++x)
+        {
+            _cells[getCellKey(x, y)].push_back(entry);
+        }
+    }
+}
+
+void EventDispatcher::TouchListenerIndex::removeFromCells(Entry* entry)
+{
+    if (!entry->boundsValid)
+        return;
+    
+    entry->boundsValid = false;
+    
+    if (entry->large)
+    {
+        _largeEntries.erase(std::find(_largeEntries.begin(), _largeEntries.end(), entry));
+        return;
+    }
+    
+    for (int y = entry->cellY0; y <= entry->cellY1; ++y)
+    {
+        for (int x = entry->cellX0; x <= entry->cellX1; ++x)
+        {
+            auto iter = _cells.find(getCellKey(x, y));
+            CCASSERT(iter != _cells.end(), "The entry should be in the cell!");
+            
+            auto& cell = iter->second;
+            cell.erase(std::find(cell.begin(), cell.end(), entry));
+            if (cell.empty())
+            {
+                _cells.erase(iter);
+            }
+        }
+    }
+}
+
+void EventDispatcher::TouchListenerIndex::query(const Vec2& location, std::vector<EventListener*>& listeners)
+{
+    _candidates.clear();
+    
+    float cellX = floorf(location.x / TOUCH_INDEX_CELL_SIZE);
+    float cellY = floorf(location.y / TOUCH_INDEX_CELL_SIZE);
+    auto iter = (fabsf(cellX) < 1e6f && fabsf(cellY) < 1e6f) ? _cells.find(getCellKey((int)cellX, (int)cellY)) : _cells.end();
+    if (iter != _cells.end())
+    {
+        for (auto& entry : iter->second)
+        {
+            if (entry->bounds.containsPoint(location))
+                _candidates.push_back(entry);
+        }
+    }
+    
+    for (auto& entry : _largeEntries)
+    {
+        if (entry->bounds.containsPoint(location))
+            _candidates.push_back(entry);
+    }
+    
+    std::sort(_candidates.begin(), _candidates.end(), [](const Entry* e1, const Entry* e2) {
+        return e1->order < e2->order;
+    });
+    
+    // Merges the candidates with the unindexed listeners, which are sorted already
+    listeners.clear();
+    listeners.reserve(_candidates.size() + _unindexedListeners.size());
+    
+    auto candidateIter = _candidates.begin();
+    for (const auto& unindexed : _unindexedListeners)
+    {
+        for (; candidateIter != _candidates.end() && (*candidateIter)->order < unindexed.first; ++candidateIter)
+        {
+            listeners.push_back((*candidateIter)->listener);
+        }
+        listeners.push_back(unindexed.second);
+    }
+    
+    for (; candidateIter != _candidates.end(); ++candidateIter)
+    {
+        listeners.push_back((*candidateIter)->listener);
+    }
+}
+
 
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _touchIndex(nullptr)
+, _touchIndexEnabled(false)
 {
     _toAddedListeners.reserve(50);
     
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_FOREGROUND);
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_BACKGROUND);
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_FOREGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_BACKGROUND));
 }
 
 EventDispatcher::~EventDispatcher()
@@ -212,6 +545,7 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchIndex);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -447,18 +781,17 @@ void EventDispatcher::addEventListener(EventListener* listener)
 
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
-    EventListenerVector* listeners = nullptr;
-    EventListener::ListenerID listenerID = listener->getListenerID();
-    auto itr = _listenerMap.find(listenerID);
-    if (itr == _listenerMap.end())
+    int listenerID = listener->getInternedID();
+    if (listenerID >= static_cast<int>(_listeners.size()))
     {
-        
-        listeners = new EventListenerVector();
-        _listenerMap.insert(std::make_pair(listenerID, listeners));
+        _listeners.resize(listenerID + 1, nullptr);
     }
-    else
+    
+    EventListenerVector* listeners = _listeners[listenerID];
+    if (listeners == nullptr)
     {
-        listeners = itr->second;
+        listeners = new EventListenerVector();
+        _listeners[listenerID] = listeners;
     }
     
     listeners->push_back(listener);
@@ -503,9 +836,8 @@ void EventDispatcher::addEventListenerWithSceneGraphPriority(EventListener* list
 void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
 {
     // Check the listeners map
-    for (const auto & keyValuePair : _listenerMap)
+    for (const EventListenerVector * eventListenerVector : _listeners)
     {
-        const EventListenerVector * eventListenerVector = keyValuePair.second;
         
         if (eventListenerVector)
         {
@@ -621,9 +953,11 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         }
     };
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // A listener is only stored in the vector of its own listener ID.
+    int listenerID = listener->getInternedID();
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = iter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -631,14 +965,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listenerID, DirtyFlag::FIXED_PRIORITY);
             }
         }
         
@@ -654,20 +988,12 @@ void EventDispatcher::removeEventListener(EventListener* listener)
                  "Listener should be in no lists after this is done if we're not currently in dispatch mode.");
 #endif
 
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
-            auto list = iter->second;
-            iter = _listenerMap.erase(iter);
-            CC_SAFE_DELETE(list);
-        }
-        else
+        if (listeners->empty())
         {
-            ++iter;
+            _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
+            _listeners[listenerID] = nullptr;
+            CC_SAFE_DELETE(listeners);
         }
-        
-        if (isFound)
-            break;
     }
 
     if (isFound)
@@ -694,32 +1020,36 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     if (listener == nullptr)
         return;
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end(); ++iter)
+    auto listeners = getListeners(listener->getInternedID());
+    if (listeners == nullptr)
+        return;
+    
+    auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
+    if (fixedPriorityListeners)
     {
-        auto fixedPriorityListeners = iter->second->getFixedPriorityListeners();
-        if (fixedPriorityListeners)
+        auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
+        if (found != fixedPriorityListeners->end())
         {
-            auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
-            if (found != fixedPriorityListeners->end())
+            CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
+            
+            if (listener->getFixedPriority() != fixedPriority)
             {
-                CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
-                
-                if (listener->getFixedPriority() != fixedPriority)
-                {
-                    listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
-                }
-                return;
+                listener->setFixedPriority(fixedPriority);
+                setDirty(listener->getInternedID(), DirtyFlag::FIXED_PRIORITY);
             }
         }
     }
 }
 
 void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+{
+    dispatchEventToListeners(listeners, listeners->getSceneGraphPriorityListeners(), onEvent);
+}
+
+void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, std::vector<EventListener*>* sceneGraphPriorityListeners, const std::function<bool(EventListener*)>& onEvent)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
-    auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
     
     ssize_t i = 0;
     // priority < 0
@@ -797,11 +1127,9 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     sortEventListeners(listenerID);
     
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = iter->second;
-        
         auto onEvent = [&event](EventListener* listener) -> bool{
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
@@ -821,14 +1149,37 @@ void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *op
     dispatchEvent(&ev);
 }
 
+void EventDispatcher::dispatchCustomEvent(int eventID, void *optionalUserData)
+{
+    EventCustom ev(eventID);
+    ev.setUserData(optionalUserData);
+    dispatchEvent(&ev);
+}
+
+int EventDispatcher::getCustomEventID(const std::string& eventName)
+{
+    return EventListener::internListenerID(eventName);
+}
+
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    if (_touchIndexEnabled)
+    {
+        // The priority order, or the membership of the scene graph priority listeners, changed since the index was synced
+        int listenerID = __getTouchOneByOneListenerID();
+        if (listenerID < static_cast<int>(_priorityDirtyFlags.size())
+            && ((int)_priorityDirtyFlags[listenerID] & (int)DirtyFlag::SCENE_GRAPH_PRIORITY))
+        {
+            _touchIndex->setStale();
+        }
+    }
+    
+    sortEventListeners(__getTouchOneByOneListenerID());
+    sortEventListeners(__getTouchAllAtOnceListenerID());
     
-    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneListeners = getListeners(__getTouchOneByOneListenerID());
+    auto allAtOnceListeners = getListeners(__getTouchAllAtOnceListenerID());
     
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -845,6 +1196,24 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     //
     if (oneByOneListeners)
     {
+        // Began touches are only dispatched to the candidates of the touch index under their location
+        auto sceneGraphPriorityListeners = oneByOneListeners->getSceneGraphPriorityListeners();
+        bool useTouchIndex = false;
+        std::vector<EventListener*> touchIndexCandidates;
+        
+        if (_touchIndexEnabled)
+        {
+            if (sceneGraphPriorityListeners == nullptr)
+            {
+                _touchIndex->clear();
+            }
+            else if (event->getEventCode() == EventTouch::EventCode::BEGAN)
+            {
+                _touchIndex->update(*sceneGraphPriorityListeners);
+                useTouchIndex = true;
+            }
+        }
+        
         auto mutableTouchesIter = mutableTouches.begin();
         auto touchesIter = originalTouches.begin();
         
@@ -939,7 +1308,16 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
             };
             
             //
-            dispatchEventToListeners(oneByOneListeners, onTouchEvent);
+            // The index may be disabled by a listener of a previous touch
+            if (useTouchIndex && _touchIndexEnabled)
+            {
+                _touchIndex->query((*touchesIter)->getLocation(), touchIndexCandidates);
+                dispatchEventToListeners(oneByOneListeners, &touchIndexCandidates, onTouchEvent);
+            }
+            else
+            {
+                dispatchEventToListeners(oneByOneListeners, onTouchEvent);
+            }
             if (event->isStopped())
             {
                 return;
@@ -1019,13 +1397,11 @@ void EventDispatcher::updateListeners(Event* event)
 {
     CCASSERT(_inDispatch > 0, "If program goes here, there should be event in dispatch.");
     
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    auto onUpdateListeners = [this](int listenerID)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(listenerID);
+        if (listeners == nullptr)
             return;
-
-        auto listeners = listenersIter->second;
         
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
@@ -1078,8 +1454,8 @@ void EventDispatcher::updateListeners(Event* event)
     
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(__getTouchOneByOneListenerID());
+        onUpdateListeners(__getTouchAllAtOnceListenerID());
     }
     else
     {
@@ -1091,17 +1467,14 @@ void EventDispatcher::updateListeners(Event* event)
     
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    for (size_t listenerID = 0; listenerID < _listeners.size(); ++listenerID)
     {
-        if (iter->second->empty())
+        auto listeners = _listeners[listenerID];
+        if (listeners && listeners->empty())
         {
-            _priorityDirtyFlagMap.erase(iter->first);
-            delete iter->second;
-            iter = _listenerMap.erase(iter);
-        }
-        else
-        {
-            ++iter;
+            _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
+            delete listeners;
+            _listeners[listenerID] = nullptr;
         }
     }
     
@@ -1126,7 +1499,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getInternedID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
@@ -1135,20 +1508,19 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(int listenerID)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
     
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
-    if (dirtyIter != _priorityDirtyFlagMap.end())
+    if (listenerID >= 0 && listenerID < static_cast<int>(_priorityDirtyFlags.size()))
     {
-        dirtyFlag = dirtyIter->second;
+        dirtyFlag = _priorityDirtyFlags[listenerID];
     }
     
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
+        _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
@@ -1164,13 +1536,13 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                _priorityDirtyFlags[listenerID] = DirtyFlag::SCENE_GRAPH_PRIORITY;
             }
         }
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode)
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(int listenerID, Node* rootNode)
 {
     auto listeners = getListeners(listenerID);
     
@@ -1201,7 +1573,7 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(int listenerID)
 {
     auto listeners = getListeners(listenerID);
 
@@ -1238,23 +1610,21 @@ void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::Lis
     
 }
 
-EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventListener::ListenerID& listenerID)
+EventDispatcher::EventListenerVector* EventDispatcher::getListeners(int listenerID)
 {
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    if (listenerID >= 0 && listenerID < static_cast<int>(_listeners.size()))
     {
-        return iter->second;
+        return _listeners[listenerID];
     }
     
     return nullptr;
 }
 
-void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
+void EventDispatcher::removeEventListenersForListenerID(int listenerID)
 {
-    auto listenerItemIter = _listenerMap.find(listenerID);
-    if (listenerItemIter != _listenerMap.end())
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = listenerItemIter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
         
@@ -1289,19 +1659,19 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        _priorityDirtyFlagMap.erase(listenerID);
+        _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
         
         if (!_inDispatch)
         {
             listeners->clear();
             delete listeners;
-            _listenerMap.erase(listenerItemIter);
+            _listeners[listenerID] = nullptr;
         }
     }
     
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getInternedID() == listenerID)
         {
             (*iter)->setRegistered(false);
             (*iter)->release();
@@ -1318,23 +1688,23 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 {
     if (listenerType == EventListener::Type::TOUCH_ONE_BY_ONE)
     {
-        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+        removeEventListenersForListenerID(__getTouchOneByOneListenerID());
     }
     else if (listenerType == EventListener::Type::TOUCH_ALL_AT_ONCE)
     {
-        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+        removeEventListenersForListenerID(__getTouchAllAtOnceListenerID());
     }
     else if (listenerType == EventListener::Type::MOUSE)
     {
-        removeEventListenersForListenerID(EventListenerMouse::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerMouse::LISTENER_ID));
     }
     else if (listenerType == EventListener::Type::ACCELERATION)
     {
-        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID));
     }
     else if (listenerType == EventListener::Type::KEYBOARD)
     {
-        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID));
     }
     else
     {
@@ -1344,34 +1714,31 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 
 void EventDispatcher::removeCustomEventListeners(const std::string& customEventName)
 {
-    removeEventListenersForListenerID(customEventName);
+    removeEventListenersForListenerID(EventListener::internListenerID(customEventName));
 }
 
 void EventDispatcher::removeAllEventListeners()
 {
     bool cleanMap = true;
-    std::vector<EventListener::ListenerID> types(_listenerMap.size());
     
-    for (const auto& e : _listenerMap)
+    for (int listenerID = 0; listenerID < static_cast<int>(_listeners.size()); ++listenerID)
     {
-        if (_internalCustomListenerIDs.find(e.first) != _internalCustomListenerIDs.end())
+        if (_listeners[listenerID] == nullptr)
+            continue;
+        
+        if (_internalCustomListenerIDs.find(listenerID) != _internalCustomListenerIDs.end())
         {
             cleanMap = false;
         }
         else
         {
-            types.push_back(e.first);
+            removeEventListenersForListenerID(listenerID);
         }
     }
-
-    for (const auto& type : types)
-    {
-        removeEventListenersForListenerID(type);
-    }
     
     if (!_inDispatch && cleanMap)
     {
-        _listenerMap.clear();
+        _listeners.clear();
     }
 }
 
@@ -1385,6 +1752,30 @@ bool EventDispatcher::isEnabled() const
     return _isEnabled;
 }
 
+void EventDispatcher::setTouchIndexEnabled(bool enabled)
+{
+    if (enabled == _touchIndexEnabled)
+        return;
+    
+    _touchIndexEnabled = enabled;
+    
+    // The index isn't deleted when it's disabled, since it may be in use by the dispatch which invoked this method.
+    // Clearing it is safe, the candidates of a dispatch are still retained by the listener vectors.
+    if (_touchIndex == nullptr)
+    {
+        _touchIndex = new TouchListenerIndex();
+    }
+    else
+    {
+        _touchIndex->clear();
+    }
+}
+
+bool EventDispatcher::isTouchIndexEnabled() const
+{
+    return _touchIndexEnabled;
+}
+
 void EventDispatcher::setDirtyForNode(Node* node)
 {
     // Mark the node dirty only when there is an eventlistener associated with it. 
@@ -1401,18 +1792,15 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
-void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
+void EventDispatcher::setDirty(int listenerID, DirtyFlag flag)
 {    
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
-    if (iter == _priorityDirtyFlagMap.end())
+    if (listenerID >= static_cast<int>(_priorityDirtyFlags.size()))
     {
-        _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
-    }
-    else
-    {
-        int ret = (int)flag | (int)iter->second;
-        iter->second = (DirtyFlag) ret;
+        _priorityDirtyFlags.resize(listenerID + 1, DirtyFlag::NONE);
     }
+    
+    int ret = (int)flag | (int)_priorityDirtyFlags[listenerID];
+    _priorityDirtyFlags[listenerID] = (DirtyFlag) ret;
 }
 
 NS_CC_END
@@ -122,6 +122,16 @@ public:
     /** Checks whether dispatching events is enabled */
     bool isEnabled() const;
 
+    /** Enables a spatial index of the scene graph priority touch listeners which have a content hit test.
+     *  A began touch then only reaches the indexed listeners whose node bounds contain its location,
+     *  still in priority order. It's disabled by default.
+     *  @see EventListenerTouchOneByOne::setContentHitTest
+     */
+    void setTouchIndexEnabled(bool enabled);
+
+    /** Checks whether the spatial index of touch listeners is enabled */
+    bool isTouchIndexEnabled() const;
+
     /////////////////////////////////////////////
     
     /** Dispatches the event
@@ -133,6 +143,14 @@ public:
     /** Dispatches a Custom Event with a event name an optional user data */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with an event ID returned by `getCustomEventID` and an optional user data.
+     *  It's faster than dispatching by name since the event name isn't copied or hashed.
+     */
+    void dispatchCustomEvent(int eventID, void *optionalUserData = nullptr);
+
+    /** Gets the interned ID of a custom event name. The ID stays valid for the lifetime of the process. */
+    static int getCustomEventID(const std::string& eventName);
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher */
@@ -194,23 +212,23 @@ protected:
      */
     void forceAddEventListener(EventListener* listener);
     
-    /** Gets event the listener list for the event listener type. */
-    EventListenerVector* getListeners(const EventListener::ListenerID& listenerID);
+    /** Gets event the listener list for the interned event listener ID. */
+    EventListenerVector* getListeners(int listenerID);
     
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
     
     /** Removes all listeners with the same event listener ID */
-    void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
+    void removeEventListenersForListenerID(int listenerID);
     
     /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    void sortEventListeners(int listenerID);
     
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(int listenerID, Node* rootNode);
     
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
+    void sortEventListenersOfFixedPriority(int listenerID);
     
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -230,6 +248,12 @@ protected:
     /** Dispatches event to listeners with a specified listener type */
     void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
     
+    /** Dispatches event to the fixed priority listeners of `listeners` and to the specified scene graph priority listeners */
+    void dispatchEventToListeners(EventListenerVector* listeners, std::vector<EventListener*>* sceneGraphPriorityListeners, const std::function<bool(EventListener*)>& onEvent);
+    
+    /** Uniform grid of the world bounds of touch listeners, defined in CCEventDispatcher.cpp */
+    class TouchListenerIndex;
+    
     /// Priority dirty flag
     enum class DirtyFlag
     {
@@ -240,16 +264,16 @@ protected:
     };
     
     /** Sets the dirty flag for a specified listener ID */
-    void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
+    void setDirty(int listenerID, DirtyFlag flag);
     
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
     
-    /** Listeners map */
-    std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
+    /** Listeners indexed by interned listener ID, nullptr if there is no listener for the ID */
+    std::vector<EventListenerVector*> _listeners;
     
-    /** The map of dirty flag */
-    std::unordered_map<EventListener::ListenerID, DirtyFlag> _priorityDirtyFlagMap;
+    /** Dirty flags indexed by interned listener ID */
+    std::vector<DirtyFlag> _priorityDirtyFlags;
     
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
@@ -274,7 +298,13 @@ protected:
     
     int _nodePriorityIndex;
     
-    std::set<std::string> _internalCustomListenerIDs;
+    /** The spatial index of touch listeners, created when it's enabled for the first time */
+    TouchListenerIndex* _touchIndex;
+    
+    /** Whether began touches are dispatched through the spatial index */
+    bool _touchIndexEnabled;
+    
+    std::set<int> _internalCustomListenerIDs;
 };
 
 
@@ -24,9 +24,59 @@
 
 #include "base/CCEventListener.h"
 #include "platform/CCCommon.h"
+#include "base/ccMacros.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
+namespace
+{
+
+// The registry is created on first use, so listener IDs that are static strings of other
+// translation units can be interned safely. Names are stored in a deque to keep the
+// references returned by getInternedListenerID valid while new names are added.
+struct ListenerIDRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<EventListener::ListenerID, int> ids;
+    std::deque<EventListener::ListenerID> names;
+};
+
+ListenerIDRegistry& getListenerIDRegistry()
+{
+    static ListenerIDRegistry registry;
+    return registry;
+}
+
+}
+
+int EventListener::internListenerID(const ListenerID& listenerID)
+{
+    auto& registry = getListenerIDRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    
+    auto iter = registry.ids.find(listenerID);
+    if (iter != registry.ids.end())
+        return iter->second;
+    
+    int internedID = static_cast<int>(registry.names.size());
+    registry.names.push_back(listenerID);
+    registry.ids.insert(std::make_pair(listenerID, internedID));
+    return internedID;
+}
+
+const EventListener::ListenerID& EventListener::getInternedListenerID(int internedID)
+{
+    auto& registry = getListenerIDRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    
+    CCASSERT(internedID >= 0 && internedID < static_cast<int>(registry.names.size()), "Invalid interned listener ID!");
+    return registry.names[internedID];
+}
+
 EventListener::EventListener()
 {}
     
@@ -40,6 +90,7 @@ bool EventListener::init(Type t, const ListenerID& listenerID, const std::functi
     _onEvent = callback;
     _type = t;
     _listenerID = listenerID;
+    _internedID = internListenerID(listenerID);
     _isRegistered = false;
     _paused = true;
     _isEnabled = true;
@@ -60,6 +60,16 @@ public:
 
     typedef std::string ListenerID;
 
+    /** Interns a listener ID, returning a small integer that identifies it for the lifetime of the process.
+     *  EventDispatcher indexes its listener tables with these integers, so dispatching by an interned ID
+     *  avoids hashing and copying the string for every event.
+     *  @note The same string always returns the same integer. It's safe to call this method from any thread.
+     */
+    static int internListenerID(const ListenerID& listenerID);
+
+    /** Gets the listener ID which was interned as the specified integer. */
+    static const ListenerID& getInternedListenerID(int internedID);
+
 protected:
     /** Constructor */
     EventListener();
@@ -118,6 +128,11 @@ protected:
      */
     inline const ListenerID& getListenerID() const { return _listenerID; };
 
+    /** Gets the interned integer of this listener's ID
+     *  @see internListenerID
+     */
+    inline int getInternedID() const { return _internedID; };
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -144,6 +159,7 @@ protected:
 
     Type _type;                             /// Event listener type
     ListenerID _listenerID;                 /// Event listener ID
+    int _internedID;                        /// Interned integer of the event listener ID
     bool _isRegistered;                     /// Whether the listener has been added to dispatcher.
 
     int   _fixedPriority;   // The higher the number, the higher the priority, 0 is for scene graph base priority.
@@ -38,6 +38,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _contentHitTest(false)
 {
 }
 
@@ -66,6 +67,16 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setContentHitTest(bool contentHitTest)
+{
+    _contentHitTest = contentHitTest;
+}
+
+bool EventListenerTouchOneByOne::isContentHitTest() const
+{
+    return _contentHitTest;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new EventListenerTouchOneByOne();
@@ -107,6 +118,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_contentHitTest = _contentHitTest;
     }
     else
     {
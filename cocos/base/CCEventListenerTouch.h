@@ -45,6 +45,13 @@ public:
     void setSwallowTouches(bool needSwallow);
     bool isSwallowTouches();
     
+    /** Declares that onTouchBegan never claims a touch outside the content rect of the associated node.
+     *  When the touch index of EventDispatcher is enabled, scene graph priority listeners with this hint
+     *  are skipped for began touches outside the world bounds of their node.
+     */
+    void setContentHitTest(bool contentHitTest);
+    bool isContentHitTest() const;
+    
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -62,6 +69,7 @@ private:
     
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _contentHitTest;
     
     friend class EventDispatcher;
 };
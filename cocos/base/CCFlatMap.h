@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FLAT_MAP_H__
+#define __CC_FLAT_MAP_H__
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup data_structures
+ * @{
+ */
+
+/** A map keeping its entries sorted by key in a single array.
+ 
+ It has the subset of the std::unordered_map interface used by the engine, so it can replace ValueMap
+ (see CC_USE_FLAT_VALUE_MAP). Compared to a hash map, the entries are in one allocation instead of one
+ per entry, a lookup is a binary search without hashing, and copying it copies one array.
+ Inserting is linear, except when the keys come in order like in the plist files, where it appends.
+ Unlike std::unordered_map, inserting and erasing invalidate the iterators and references to the entries.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+    typedef typename std::vector<value_type>::size_type size_type;
+
+    FlatMap() {}
+    FlatMap(std::initializer_list<value_type> list)
+    {
+        _entries.reserve(list.size());
+        for (const auto& entry : list)
+            insert(entry);
+    }
+
+    iterator begin() { return _entries.begin(); }
+    const_iterator begin() const { return _entries.begin(); }
+    const_iterator cbegin() const { return _entries.cbegin(); }
+    iterator end() { return _entries.end(); }
+    const_iterator end() const { return _entries.end(); }
+    const_iterator cend() const { return _entries.cend(); }
+
+    size_type size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+    void clear() { _entries.clear(); }
+    void reserve(size_type count) { _entries.reserve(count); }
+
+    iterator find(const K& key)
+    {
+        auto iter = lowerBound(key);
+        return (iter != _entries.end() && !_compare(key, iter->first)) ? iter : _entries.end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        return const_cast<FlatMap*>(this)->find(key);
+    }
+
+    size_type count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    V& at(const K& key)
+    {
+        auto iter = find(key);
+        CCASSERT(iter != _entries.end(), "FlatMap::at: key not found");
+        return iter->second;
+    }
+
+    const V& at(const K& key) const
+    {
+        return const_cast<FlatMap*>(this)->at(key);
+    }
+
+    V& operator[](const K& key)
+    {
+        auto iter = lowerBound(key);
+        if (iter == _entries.end() || _compare(key, iter->first))
+            iter = _entries.insert(iter, value_type(key, V()));
+        return iter->second;
+    }
+
+    V& operator[](K&& key)
+    {
+        auto iter = lowerBound(key);
+        if (iter == _entries.end() || _compare(key, iter->first))
+            iter = _entries.insert(iter, value_type(std::move(key), V()));
+        return iter->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        auto iter = lowerBound(entry.first);
+        if (iter != _entries.end() && !_compare(entry.first, iter->first))
+            return std::make_pair(iter, false);
+        return std::make_pair(_entries.insert(iter, entry), true);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& entry)
+    {
+        auto iter = lowerBound(entry.first);
+        if (iter != _entries.end() && !_compare(entry.first, iter->first))
+            return std::make_pair(iter, false);
+        return std::make_pair(_entries.insert(iter, std::move(entry)), true);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    iterator erase(const_iterator position)
+    {
+        // vector::erase(const_iterator) is missing in the older standard libraries
+        return _entries.erase(_entries.begin() + (position - _entries.cbegin()));
+    }
+
+    size_type erase(const K& key)
+    {
+        auto iter = find(key);
+        if (iter == _entries.end())
+            return 0;
+        _entries.erase(iter);
+        return 1;
+    }
+
+    void swap(FlatMap& other) { _entries.swap(other._entries); }
+
+protected:
+    iterator lowerBound(const K& key)
+    {
+        // the keys are often inserted in order, check the last one first
+        if (_entries.empty() || _compare(_entries.back().first, key))
+            return _entries.end();
+        return std::lower_bound(_entries.begin(), _entries.end(), key, [this](const value_type& entry, const K& k) {
+            return _compare(entry.first, k);
+        });
+    }
+
+    std::vector<value_type> _entries;
+    Compare _compare;
+};
+
+// end of data_structures group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_FLAT_MAP_H__
@@ -41,6 +41,7 @@ static void untrackRef(Ref* ref);
 
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
+, _referenceCountThreadSafe(CC_ENABLE_ATOMIC_REFERENCE_COUNT != 0)
 {
 #if CC_ENABLE_SCRIPT_BINDING
     static unsigned int uObjectCount = 0;
@@ -53,6 +54,31 @@ Ref::Ref()
 #endif
 }
 
+Ref::Ref(const Ref& other)
+: _referenceCount(other._referenceCount.load(std::memory_order_relaxed))
+, _referenceCountThreadSafe(other._referenceCountThreadSafe)
+{
+#if CC_ENABLE_SCRIPT_BINDING
+    _luaID = other._luaID;
+    _ID = other._ID;
+#endif
+
+#if CC_USE_MEM_LEAK_DETECTION
+    trackRef(this);
+#endif
+}
+
+Ref& Ref::operator=(const Ref& other)
+{
+    _referenceCount.store(other._referenceCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    _referenceCountThreadSafe = other._referenceCountThreadSafe;
+#if CC_ENABLE_SCRIPT_BINDING
+    _luaID = other._luaID;
+    _ID = other._ID;
+#endif
+    return *this;
+}
+
 Ref::~Ref()
 {
 #if CC_ENABLE_SCRIPT_BINDING
@@ -80,20 +106,39 @@ Ref::~Ref()
 
 void Ref::retain()
 {
-    CCASSERT(_referenceCount > 0, "reference count should greater than 0");
-    ++_referenceCount;
+    CCASSERT(_referenceCount.load(std::memory_order_relaxed) > 0, "reference count should greater than 0");
+    if (_referenceCountThreadSafe)
+    {
+        _referenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        // a plain increment, only the cocos thread touches the count
+        _referenceCount.store(_referenceCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
 }
 
 void Ref::release()
 {
-    CCASSERT(_referenceCount > 0, "reference count should greater than 0");
-    --_referenceCount;
+    CCASSERT(_referenceCount.load(std::memory_order_relaxed) > 0, "reference count should greater than 0");
+    unsigned int referenceCount;
+    if (_referenceCountThreadSafe)
+    {
+        // acquire the writes of the threads which released it before, if it is the last reference
+        referenceCount = _referenceCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    }
+    else
+    {
+        referenceCount = _referenceCount.load(std::memory_order_relaxed) - 1;
+        _referenceCount.store(referenceCount, std::memory_order_relaxed);
+    }
 
-    if (_referenceCount == 0)
+    if (referenceCount == 0)
     {
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
-        auto poolManager = PoolManager::getInstance();
-        if (!poolManager->getCurrentPool()->isClearing() && poolManager->isObjectInPools(this))
+        // the pools belong to the cocos thread, the thread safe objects may be released by another thread
+        auto poolManager = _referenceCountThreadSafe ? nullptr : PoolManager::getInstance();
+        if (poolManager && !poolManager->getCurrentPool()->isClearing() && poolManager->isObjectInPools(this))
         {
             // Trigger an assert if the reference count is 0 but the Ref is still in autorelease pool.
             // This happens when 'autorelease/release' were not used in pairs with 'new/retain'.
@@ -141,7 +186,7 @@ Ref* Ref::autorelease()
 
 unsigned int Ref::getReferenceCount() const
 {
-    return _referenceCount;
+    return _referenceCount.load(std::memory_order_relaxed);
 }
 
 #if CC_USE_MEM_LEAK_DETECTION
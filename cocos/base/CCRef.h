@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "base/CCPlatformMacros.h"
 #include "base/ccConfig.h"
 
+#include <atomic>
+
 #define CC_USE_MEM_LEAK_DETECTION 0
 
 NS_CC_BEGIN
@@ -114,6 +116,22 @@ public:
      */
     unsigned int getReferenceCount() const;
 
+    /**
+     * Makes retain() and release() safe to call from several threads, at the cost of atomic operations.
+     *
+     * To call before the Ref is shared with the other threads, usually in the constructor.
+     * autorelease() must still be called in the cocos thread.
+     * Enabled for every Ref when CC_ENABLE_ATOMIC_REFERENCE_COUNT is 1.
+     * @js NA
+     * @lua NA
+     */
+    void setReferenceCountThreadSafe(bool threadSafe) { _referenceCountThreadSafe = threadSafe; }
+    /**
+     * @js NA
+     * @lua NA
+     */
+    bool isReferenceCountThreadSafe() const { return _referenceCountThreadSafe; }
+
 protected:
     /**
      * Constructor
@@ -123,6 +141,14 @@ protected:
      */
     Ref();
 
+    /**
+     * Copies the members like the implicit copy constructor, which std::atomic doesn't have.
+     * @js NA
+     * @lua NA
+     */
+    Ref(const Ref& other);
+    Ref& operator=(const Ref& other);
+
 public:
     /**
      * @js NA
@@ -132,7 +158,9 @@ public:
 
 protected:
     /// count of references
-    unsigned int _referenceCount;
+    std::atomic<unsigned int> _referenceCount;
+    /// whether _referenceCount is updated atomically
+    bool _referenceCountThreadSafe;
 
     friend class AutoreleasePool;
 
@@ -118,6 +118,24 @@ public:
         CC_REF_PTR_SAFE_RETAIN(_ptr);
     }
     
+    // Conversions from RefPtr<U>, for U derived from T. Moving takes over the reference without retaining.
+    
+    template <typename U>
+    inline RefPtr(RefPtr<U> && other, typename std::enable_if<std::is_convertible<U*, T*>::value>::type* = nullptr)
+    :
+        _ptr(other._ptr)
+    {
+        other._ptr = nullptr;
+    }
+    
+    template <typename U>
+    inline RefPtr(const RefPtr<U> & other, typename std::enable_if<std::is_convertible<U*, T*>::value>::type* = nullptr)
+    :
+        _ptr(other._ptr)
+    {
+        CC_REF_PTR_SAFE_RETAIN(_ptr);
+    }
+    
     inline ~RefPtr()
     {
         CC_REF_PTR_SAFE_RELEASE_NULL(_ptr);
@@ -147,6 +165,24 @@ public:
         return *this;
     }
     
+    template <typename U>
+    inline typename std::enable_if<std::is_convertible<U*, T*>::value, RefPtr<T> &>::type operator = (RefPtr<U> && other)
+    {
+        if (other._ptr != _ptr)
+        {
+            CC_REF_PTR_SAFE_RELEASE(_ptr);
+            _ptr = other._ptr;
+        }
+        else
+        {
+            // both reference the object, drop one of the references
+            CC_REF_PTR_SAFE_RELEASE(other._ptr);
+        }
+        other._ptr = nullptr;
+        
+        return *this;
+    }
+    
     inline RefPtr<T> & operator = (T * other)
     {
         if (other != _ptr)
@@ -279,6 +315,8 @@ public:
     }
     
 private:
+    template <typename U> friend class RefPtr;
+    
     Ref * _ptr;
 };
     
@@ -28,42 +28,23 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include "base/CCThreadPool.h"
+#include "2d/CCNode.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
 // Hash Element used for "selectors with interval"
 typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
+    unsigned int        order;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -79,6 +60,11 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _startTime(0)
+, _pausedElapsed(0)
+, _scheduleOrder(0)
+, _wheelHandle(-1)
+, _wheelState(WheelState::NONE)
 {
 }
 
@@ -145,6 +131,45 @@ void Timer::update(float dt)
     }
 }
 
+void Timer::start(double time)
+{
+    _startTime = time;
+    _elapsed = 0;
+    _timesExecuted = 0;
+}
+
+void Timer::expire(double time)
+{
+    // same as update(), with the elapsed time computed from the start time
+    _elapsed = (float)(time - _startTime);
+
+    if (_runForever && !_useDelay)
+    {
+        trigger();
+        _startTime = time;
+    }
+    else
+    {
+        if (_useDelay)
+        {
+            trigger();
+            _startTime += _delay;
+            _timesExecuted += 1;
+            _useDelay = false;
+        }
+        else
+        {
+            trigger();
+            _startTime = time;
+            _timesExecuted += 1;
+        }
+
+        if (!_runForever && _timesExecuted > _repeat)
+        {    //unschedule timer
+            cancel();
+        }
+    }
+}
 
 // TimerTargetSelector
 
@@ -247,25 +272,35 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
+, _currentUpdateBucket(-1)
+, _updatePool(nullptr)
+, _updatingConcurrently(false)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timersTime(0)
+, _timersTimeBeforeTick(0)
+, _timersScheduleOrder(0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _functionsToPerformBudget(0.005f)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
 }
 
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+
+    for (auto bucket : _updateBuckets)
+    {
+        delete bucket;
+    }
+    CC_SAFE_DELETE(_updatePool);
+
+    for (auto timer : _pendingTimers)
+    {
+        timer->release();
+    }
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
@@ -275,6 +310,149 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::addTimer(tHashTimerEntry *element, Timer* timer)
+{
+    ccArrayAppendObject(element->timers, timer);
+    timer->_scheduleOrder = ((unsigned long long)element->order << 32) | _timersScheduleOrder++;
+
+    if (element->paused)
+    {
+        timer->_wheelState = Timer::WheelState::PAUSED_PENDING;
+    }
+    else
+    {
+        timer->_wheelState = Timer::WheelState::PENDING;
+        timer->retain();
+        _pendingTimers.push_back(timer);
+    }
+}
+
+void Scheduler::rescheduleTimer(Timer* timer)
+{
+    // the interval changed
+    if (timer->_wheelState == Timer::WheelState::WAITING)
+    {
+        _timerWheel.remove(timer->_wheelHandle);
+        timer->_wheelHandle = _timerWheel.insert(timer, timer->getDueTime());
+    }
+}
+
+void Scheduler::detachTimer(Timer* timer)
+{
+    if (timer->_wheelState == Timer::WheelState::WAITING)
+    {
+        _timerWheel.remove(timer->_wheelHandle);
+        timer->_wheelHandle = -1;
+    }
+
+    // the pending and due timers are skipped when their state is not the expected one
+    timer->_wheelState = Timer::WheelState::NONE;
+}
+
+void Scheduler::pauseTimers(tHashTimerEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer* timer = static_cast<Timer*>(element->timers->arr[i]);
+        switch (timer->_wheelState)
+        {
+            case Timer::WheelState::WAITING:
+                _timerWheel.remove(timer->_wheelHandle);
+                timer->_wheelHandle = -1;
+                timer->_pausedElapsed = _timersTime - timer->_startTime;
+                timer->_wheelState = Timer::WheelState::PAUSED;
+                break;
+            case Timer::WheelState::DUE:
+                // not triggered in this tick, so this tick doesn't count
+                timer->_pausedElapsed = _timersTimeBeforeTick - timer->_startTime;
+                timer->_wheelState = Timer::WheelState::PAUSED;
+                break;
+            case Timer::WheelState::PENDING:
+                timer->_wheelState = Timer::WheelState::PAUSED_PENDING;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void Scheduler::resumeTimers(tHashTimerEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer* timer = static_cast<Timer*>(element->timers->arr[i]);
+        switch (timer->_wheelState)
+        {
+            case Timer::WheelState::PAUSED:
+                timer->_startTime = _timersTime - timer->_pausedElapsed;
+                timer->_wheelHandle = _timerWheel.insert(timer, timer->getDueTime());
+                timer->_wheelState = Timer::WheelState::WAITING;
+                break;
+            case Timer::WheelState::PAUSED_PENDING:
+                timer->_wheelState = Timer::WheelState::PENDING;
+                timer->retain();
+                _pendingTimers.push_back(timer);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void Scheduler::updateTimers(float dt)
+{
+    _timersTimeBeforeTick = _timersTime;
+    _timersTime += dt;
+
+    _timerWheel.collectDue(_timersTime, _dueTimers);
+    std::sort(_dueTimers.begin(), _dueTimers.end(), [](const Timer* a, const Timer* b) {
+        return a->_scheduleOrder < b->_scheduleOrder;
+    });
+    for (auto timer : _dueTimers)
+    {
+        timer->retain();
+        timer->_wheelHandle = -1;
+        timer->_wheelState = Timer::WheelState::DUE;
+    }
+
+    // the callbacks may unschedule or pause the timers that are not triggered yet
+    for (size_t i = 0; i < _dueTimers.size(); ++i)
+    {
+        Timer* timer = _dueTimers[i];
+        if (timer->_wheelState == Timer::WheelState::DUE)
+        {
+            timer->expire(_timersTime);
+
+            if (timer->_wheelState == Timer::WheelState::DUE)
+            {
+                timer->_wheelHandle = _timerWheel.insert(timer, timer->getDueTime());
+                timer->_wheelState = Timer::WheelState::WAITING;
+            }
+            else if (timer->_wheelState == Timer::WheelState::PAUSED)
+            {
+                // paused by its own callback, after this tick counted
+                timer->_pausedElapsed = _timersTime - timer->_startTime;
+            }
+        }
+        timer->release();
+    }
+    _dueTimers.clear();
+
+    // the timers scheduled before the end of this tick start now: update() would have set their elapsed time to 0
+    for (size_t i = 0; i < _pendingTimers.size(); ++i)
+    {
+        Timer* timer = _pendingTimers[i];
+        if (timer->_wheelState == Timer::WheelState::PENDING)
+        {
+            timer->start(_timersTime);
+            timer->_wheelHandle = _timerWheel.insert(timer, timer->getDueTime());
+            timer->_wheelState = Timer::WheelState::WAITING;
+        }
+        timer->release();
+    }
+    _pendingTimers.clear();
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, kRepeatForever, 0.0f, paused, key);
@@ -292,6 +470,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     {
         element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
         element->target = target;
+        element->order = _timersScheduleOrder++;
 
         HASH_ADD_PTR(_hashForTimers, target, element);
 
@@ -317,6 +496,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                rescheduleTimer(timer);
                 return;
             }        
         }
@@ -325,7 +505,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -351,30 +531,13 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
+                // a timer being triggered is retained by update()
+                detachTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
 
                 return;
@@ -383,114 +546,217 @@ void Scheduler::unschedule(const std::string &key, void *target)
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::addUpdateEntry(void* target, UpdateFunc func, const ccSchedulerFunc* callback, int priority, bool paused, bool concurrent)
 {
-    tListEntry *listElement = new tListEntry();
+    CCASSERT(!_updatingConcurrently, "Concurrent updates can't schedule updates, use performFunctionInCocosThread()");
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    UpdateEntry* existing = findUpdateEntry(target);
+    if (existing)
+    {
+        // only an update unscheduled during this tick can still be found
+        CCASSERT(existing->markedForDeletion, "");
+        // TODO: check if priority has changed!
 
-    // empty list ?
-    if (! *list)
+        existing->markedForDeletion = false;
+        _updateSlots[existing->slot].bucket->deletedCount--;
+        return;
+    }
+
+    // the buckets are sorted by priority, and then concurrent last. Most of the updates are in the bucket of priority 0
+    auto it = std::lower_bound(_updateBuckets.begin(), _updateBuckets.end(), std::make_pair(priority, concurrent), [](const UpdateBucket* bucket, const std::pair<int, bool>& value) {
+        return bucket->priority < value.first || (bucket->priority == value.first && bucket->concurrent < value.second);
+    });
+
+    UpdateBucket* bucket = nullptr;
+    if (it != _updateBuckets.end() && (*it)->priority == priority && (*it)->concurrent == concurrent)
     {
-        DL_APPEND(*list, listElement);
+        bucket = *it;
     }
     else
     {
-        bool added = false;
+        bucket = new UpdateBucket();
+        bucket->priority = priority;
+        bucket->concurrent = concurrent;
+        bucket->deletedCount = 0;
 
-        for (tListEntry *element = *list; element; element = element->next)
-        {
-            if (priority < element->priority)
-            {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+        ssize_t bucketIndex = it - _updateBuckets.begin();
+        _updateBuckets.insert(it, bucket);
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
-
-                added = true;
-                break;
-            }
-        }
-
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+        // a bucket inserted before the one being updated is not updated in this tick
+        if (_currentUpdateBucket >= 0 && bucketIndex <= _currentUpdateBucket)
         {
-            DL_APPEND(*list, listElement);
+            _currentUpdateBucket++;
         }
     }
 
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    int slot;
+    if (_freeUpdateSlots.empty())
+    {
+        slot = (int)_updateSlots.size();
+        _updateSlots.push_back(UpdateSlot());
+    }
+    else
+    {
+        slot = _freeUpdateSlots.back();
+        _freeUpdateSlots.pop_back();
+    }
+
+    UpdateSlot& updateSlot = _updateSlots[slot];
+    updateSlot.bucket = bucket;
+    updateSlot.index = bucket->entries.size();
+    if (callback)
+    {
+        updateSlot.callback = *callback;
+    }
+
+    UpdateEntry entry;
+    entry.target = target;
+    entry.func = func;
+    entry.slot = slot;
+    entry.paused = paused;
+    entry.markedForDeletion = false;
+    bucket->entries.push_back(entry);
+
+    _updateSlotsByTarget[target] = slot;
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+Scheduler::UpdateEntry* Scheduler::findUpdateEntry(void* target)
 {
-    tListEntry *listElement = new tListEntry();
+    auto it = _updateSlotsByTarget.find(target);
+    if (it == _updateSlotsByTarget.end())
+    {
+        return nullptr;
+    }
+
+    const UpdateSlot& slot = _updateSlots[it->second];
+    return &slot.bucket->entries[slot.index];
+}
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->markedForDeletion = false;
+void Scheduler::removeUpdateEntry(UpdateBucket* bucket, size_t index)
+{
+    UpdateEntry& entry = bucket->entries[index];
+    if (entry.markedForDeletion)
+    {
+        return;
+    }
 
-    DL_APPEND(*list, listElement);
+    entry.markedForDeletion = true;
+    bucket->deletedCount++;
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    // while updating, the entry can still be rescheduled (see addUpdateEntry()). Else it is only kept until the bucket is compacted
+    if (!_updateHashLocked)
+    {
+        _updateSlotsByTarget.erase(entry.target);
+        _updateSlots[entry.slot].callback = nullptr;
+    }
 }
 
-void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::compactUpdateBucket(size_t bucketIndex)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    UpdateBucket* bucket = _updateBuckets[bucketIndex];
+    auto& entries = bucket->entries;
+
+    size_t count = 0;
+    for (size_t i = 0; i < entries.size(); ++i)
     {
-#if COCOS2D_DEBUG >= 1
-        CCASSERT(hashElement->entry->markedForDeletion,"");
-#endif
-        // TODO: check if priority has changed!
+        const UpdateEntry& entry = entries[i];
+        UpdateSlot& slot = _updateSlots[entry.slot];
 
-        hashElement->entry->markedForDeletion = false;
-        return;
+        if (entry.markedForDeletion)
+        {
+            auto it = _updateSlotsByTarget.find(entry.target);
+            if (it != _updateSlotsByTarget.end() && it->second == entry.slot)
+            {
+                _updateSlotsByTarget.erase(it);
+            }
+            slot.bucket = nullptr;
+            slot.callback = nullptr;
+            _freeUpdateSlots.push_back(entry.slot);
+        }
+        else
+        {
+            // keeps the order of the entries
+            slot.index = count;
+            entries[count++] = entry;
+        }
     }
+    entries.resize(count);
+    bucket->deletedCount = 0;
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
+    if (entries.empty())
     {
-        appendIn(&_updates0List, callback, target, paused);
+        _updateBuckets.erase(_updateBuckets.begin() + bucketIndex);
+        delete bucket;
     }
-    else if (priority < 0)
+}
+
+void Scheduler::compactUpdateBuckets()
+{
+    for (ssize_t i = (ssize_t)_updateBuckets.size() - 1; i >= 0; --i)
     {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        if (_updateBuckets[i]->deletedCount > 0)
+        {
+            compactUpdateBucket(i);
+        }
     }
-    else
+}
+
+void Scheduler::updateBucketConcurrently(UpdateBucket* bucket, float dt)
+{
+    // the entries can't change until all the chunks are done
+    _updatingConcurrently = true;
+    // the node targets share their ancestors, which are marked dirty once all the updates are done
+    Node::beginDeferredSubtreeDirty();
+
+    // small chunks, taken by the threads as they finish the previous ones, so the slow updates are spread
+    const size_t grainSize = 32;
+    _updatePool->parallelFor(bucket->entries.size(), grainSize, [this, bucket, dt](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const UpdateEntry& entry = bucket->entries[i];
+            if ((! entry.paused) && (! entry.markedForDeletion))
+            {
+                if (entry.func)
+                {
+                    entry.func(entry.target, dt);
+                }
+                else
+                {
+                    _updateSlots[entry.slot].callback(dt);
+                }
+            }
+        }
+    });
+
+    Node::endDeferredSubtreeDirty();
+    _updatingConcurrently = false;
+}
+
+void Scheduler::setUpdateThreadCount(int count)
+{
+    CCASSERT(count >= 0, "Invalid thread count");
+    CCASSERT(!_updatingConcurrently, "Can't be changed by a concurrent update");
+
+    if (count == getUpdateThreadCount())
+        return;
+
+    CC_SAFE_DELETE(_updatePool);
+    if (count > 0)
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        _updatePool = new ThreadPool(count);
     }
 }
 
+int Scheduler::getUpdateThreadCount() const
+{
+    return _updatePool ? _updatePool->getThreadCount() : 0;
+}
+
+void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused, bool concurrent)
+{
+    addUpdateEntry(target, nullptr, &callback, priority, paused, concurrent);
+}
+
 bool Scheduler::isScheduled(const std::string& key, void *target)
 {
     CCASSERT(!key.empty(), "Argument key must not be empty");
@@ -526,23 +792,6 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     return false;  // should never get here
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        CC_SAFE_DELETE(element->entry);
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
-}
-
 void Scheduler::unscheduleUpdate(void *target)
 {
     if (target == nullptr)
@@ -550,17 +799,19 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
+    CCASSERT(!_updatingConcurrently, "Concurrent updates can't unschedule updates, use performFunctionInCocosThread()");
+
+    auto it = _updateSlotsByTarget.find(target);
+    if (it != _updateSlotsByTarget.end())
     {
-        if (_updateHashLocked)
-        {
-            element->entry->markedForDeletion = true;
-        }
-        else
+        UpdateSlot& slot = _updateSlots[it->second];
+        UpdateBucket* bucket = slot.bucket;
+        removeUpdateEntry(bucket, slot.index);
+
+        // the removed entries are compacted in batches, so removing many of them is linear
+        if (!_updateHashLocked && bucket->deletedCount * 2 > bucket->entries.size())
         {
-            this->removeUpdateFromHash(element->entry);
+            compactUpdateBucket(std::find(_updateBuckets.begin(), _updateBuckets.end(), bucket) - _updateBuckets.begin());
         }
     }
 }
@@ -585,32 +836,20 @@ void Scheduler::unscheduleAllWithMinPriority(int minPriority)
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto bucket : _updateBuckets)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        if (bucket->priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
+            for (size_t i = 0; i < bucket->entries.size(); ++i)
             {
-                unscheduleUpdate(entry->target);
+                removeUpdateEntry(bucket, i);
             }
         }
     }
 
-    if(minPriority <= 0)
+    if (!_updateHashLocked)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        compactUpdateBuckets();
     }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
@@ -631,22 +870,13 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
+            detachTimer(static_cast<Timer*>(element->timers->arr[i]));
         }
         ccArrayRemoveAllObjects(element->timers);
 
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+        removeHashElement(element);
     }
 
     // update selector
@@ -683,18 +913,17 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry* entryUpdate = findUpdateEntry(target);
+    if (entryUpdate)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = false;
+        entryUpdate->paused = false;
     }
 }
 
@@ -705,18 +934,17 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && !element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry* entryUpdate = findUpdateEntry(target);
+    if (entryUpdate)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = true;
+        entryUpdate->paused = true;
     }
 }
 
@@ -733,11 +961,10 @@ bool Scheduler::isTargetPaused(void *target)
     }
     
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    UpdateEntry* entryUpdate = findUpdateEntry(target);
+    if ( entryUpdate )
     {
-		return elementUpdate->entry->paused;
+        return entryUpdate->paused;
     }
     
     return false;  // should never get here
@@ -756,42 +983,30 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (!element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto bucket : _updateBuckets)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        if (bucket->priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
+            for (auto& entry : bucket->entries)
             {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
+                if (!entry.markedForDeletion)
+                {
+                    entry.paused = true;
+                    idsWithSelectors.insert(entry.target);
+                }
             }
         }
     }
 
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
     return idsWithSelectors;
 }
 
@@ -804,11 +1019,17 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
+    _functionsToPerform.post(function);
+}
 
-    _functionsToPerform.push_back(function);
+void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function, const void *owner)
+{
+    _functionsToPerform.post(function, owner);
+}
 
-    _performMutex.unlock();
+void Scheduler::cancelFunctionsToPerform(const void *owner)
+{
+    _functionsToPerform.cancel(owner);
 }
 
 // main loop
@@ -825,105 +1046,43 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // Iterate over all the Updates' selectors, by priority
+    for (_currentUpdateBucket = 0; _currentUpdateBucket < (int)_updateBuckets.size(); ++_currentUpdateBucket)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
+        UpdateBucket* bucket = _updateBuckets[_currentUpdateBucket];
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        if (bucket->concurrent && _updatePool)
         {
-            entry->callback(dt);
+            updateBucketConcurrently(bucket, dt);
+            continue;
         }
-    }
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
-
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
+        // the callbacks may append entries: indexes, no iterators
+        for (size_t i = 0; i < bucket->entries.size(); ++i)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            const UpdateEntry& entry = bucket->entries[i];
+            if ((! entry.paused) && (! entry.markedForDeletion))
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
+                if (entry.func)
                 {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
+                    entry.func(entry.target, dt);
+                }
+                else
+                {
+                    _updateSlots[entry.slot].callback(dt);
                 }
-
-                elt->currentTimer = nullptr;
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
     }
+    _currentUpdateBucket = -1;
 
-    // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-    {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
-    }
-
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
-    {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
-    }
+    // Iterate over all the custom selectors that are due
+    updateTimers(dt);
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
-    }
+    // delete all updates that are marked for deletion
+    compactUpdateBuckets();
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -951,18 +1110,10 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
-        }
-        
+    // the functions added by these functions are called in the next frame
+    if (_functionsToPerform.getQueuedTaskCount() > 0)
+    {
+        _functionsToPerform.run(_functionsToPerformBudget);
     }
 }
 
@@ -977,6 +1128,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     {
         element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
         element->target = target;
+        element->order = _timersScheduleOrder++;
         
         HASH_ADD_PTR(_hashForTimers, target, element);
         
@@ -1002,6 +1154,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                rescheduleTimer(timer);
                 return;
             }
         }
@@ -1010,7 +1163,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1076,30 +1229,13 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
+                // a timer being triggered is retained by update()
+                detachTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
                 
                 return;
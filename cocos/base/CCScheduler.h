@@ -31,9 +31,14 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <vector>
+#include <deque>
+#include <unordered_map>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCTaskQueue.h"
+#include "base/CCTimerWheel.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
@@ -44,6 +49,7 @@ NS_CC_BEGIN
  */
 
 class Scheduler;
+class ThreadPool;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 //
@@ -70,7 +76,26 @@ public:
     void update(float dt);
     
 protected:
-    
+    friend class Scheduler;
+
+    // the Scheduler keeps the timers in a TimerWheel instead of calling update() every frame
+    enum class WheelState
+    {
+        NONE,
+        PENDING,            // it starts at the end of the timers of the next tick, like update() would
+        WAITING,            // it is in the wheel
+        DUE,                // it was collected from the wheel, and it will be triggered in this tick
+        PAUSED,
+        PAUSED_PENDING,
+    };
+
+    /** equivalent of the first update(): the elapsed time is 0 at `time` */
+    void start(double time);
+    /** time at which update() would trigger it */
+    double getDueTime() const { return _startTime + (_useDelay ? _delay : _interval); }
+    /** equivalent of the update() that triggers it, at `time` */
+    void expire(double time);
+
     Scheduler* _scheduler; // weak ref
     float _elapsed;
     bool _runForever;
@@ -79,6 +104,12 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    double _startTime;
+    double _pausedElapsed;
+    unsigned long long _scheduleOrder;  // the due timers are triggered in the order of their targets, and then of their scheduling
+    int _wheelHandle;
+    WheelState _wheelState;
 };
 
 
@@ -145,9 +176,7 @@ private:
 //
 // Scheduler
 //
-struct _listEntry;
 struct _hashSelectorEntry;
-struct _hashUpdateEntry;
 
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
@@ -243,11 +272,34 @@ public:
     template <class T>
     void scheduleUpdate(T *target, int priority, bool paused)
     {
-        this->schedulePerFrame([target](float dt){
-            target->update(dt);
-        }, target, priority, paused);
+        // a plain function pointer: no std::function is allocated nor invoked
+        this->addUpdateEntry(target, &Scheduler::invokeUpdate<T>, nullptr, priority, paused, false);
+    }
+
+    /** Schedules the 'update' selector for a given target with a given priority, like scheduleUpdate(),
+     but it may be called on a worker thread (see setUpdateThreadCount()).
+     The concurrent updates of a priority are called after the other updates of that priority, and they
+     are all finished before the updates of the next priority are called.
+     The 'update' selector must only modify the state of its target: it can't schedule nor unschedule anything,
+     and it must use performFunctionInCocosThread() for everything else. The functions are called at the end of the frame.
+     A Node target can use its own transform, content size and visibility setters: the subtree bounding
+     boxes of the ancestors are marked dirty once all the concurrent updates are done. It can't add, remove nor reorder
+     children, run actions, or move a physics body.
+     @lua NA
+     */
+    template <class T>
+    void scheduleConcurrentUpdate(T *target, int priority, bool paused)
+    {
+        this->addUpdateEntry(target, &Scheduler::invokeUpdate<T>, nullptr, priority, paused, true);
     }
 
+    /** Sets the number of worker threads calling the updates scheduled with scheduleConcurrentUpdate(), along with the cocos2d thread.
+     With 0, the default, they are called on the cocos2d thread.
+     */
+    void setUpdateThreadCount(int count);
+    /** returns the number of worker threads calling the concurrent updates */
+    int getUpdateThreadCount() const;
+
 #if CC_ENABLE_SCRIPT_BINDING
     // schedule for script bindings
     /** The scheduled script callback will be called every 'interval' seconds.
@@ -359,10 +411,29 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and doesn't lock.
+     The functions are called at the end of the frame, in the order they were added, until the budget of the frame is spent
+     (see setFunctionsToPerformBudget()). The ones left are called in the next frames.
      @since v3.0
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
+
+    /** Same as performFunctionInCocosThread(), but the function can be dropped with cancelFunctionsToPerform(owner) */
+    void performFunctionInCocosThread(const std::function<void()> &function, const void *owner);
+
+    /** Drops the functions of an owner which were not called yet. Must be called from the cocos2d thread,
+     once the other threads stopped adding functions for this owner.
+     */
+    void cancelFunctionsToPerform(const void *owner);
+
+    /** Sets the time, in seconds, that the functions of performFunctionInCocosThread() may take in a frame.
+     At least one function is called per frame. 0 calls all of them. The default is 5 milliseconds.
+     */
+    void setFunctionsToPerformBudget(float budget) { _functionsToPerformBudget = budget; }
+    float getFunctionsToPerformBudget() const { return _functionsToPerformBudget; }
+
+    /** The queue of the functions of performFunctionInCocosThread(), with the number of queued and late functions */
+    const TaskQueue& getFunctionsToPerform() const { return _functionsToPerform; }
     
     /////////////////////////////////////
     
@@ -426,15 +497,60 @@ protected:
      @note This method is only for internal use.
      @since v3.0
      */
-    void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
+    void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused, bool concurrent = false);
     
     void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+
+    // timers specific
+
+    void addTimer(struct _hashSelectorEntry *element, Timer* timer);
+    void rescheduleTimer(Timer* timer);
+    /// removes the timer from the wheel, before it is removed from its target
+    void detachTimer(Timer* timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+    void updateTimers(float dt);
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    typedef void (*UpdateFunc)(void* target, float dt);
+
+    template <class T>
+    static void invokeUpdate(void* target, float dt) { static_cast<T*>(target)->update(dt); }
+
+    /** An update scheduled with a priority. The entries of a priority are contiguous, in the order they were scheduled */
+    struct UpdateEntry
+    {
+        void* target;
+        UpdateFunc func;            // if nullptr, the callback of the slot is called
+        int slot;
+        bool paused;
+        bool markedForDeletion;     // it will no longer be called and it will be removed at the end of the tick
+    };
+
+    struct UpdateBucket
+    {
+        int priority;
+        bool concurrent;            // the concurrent bucket of a priority is after the other one
+        std::vector<UpdateEntry> entries;
+        size_t deletedCount;
+    };
+
+    /** Where an entry is. The index of a slot doesn't change while the update is scheduled, and its callback isn't moved */
+    struct UpdateSlot
+    {
+        UpdateBucket* bucket;
+        size_t index;
+        ccSchedulerFunc callback;
+    };
+
+    void addUpdateEntry(void* target, UpdateFunc func, const ccSchedulerFunc* callback, int priority, bool paused, bool concurrent);
+    UpdateEntry* findUpdateEntry(void* target);
+    void removeUpdateEntry(UpdateBucket* bucket, size_t index);
+    /// removes the entries marked for deletion of a bucket, and the bucket if it is empty. Not while the buckets are iterated
+    void compactUpdateBucket(size_t bucketIndex);
+    void compactUpdateBuckets();
+    void updateBucketConcurrently(UpdateBucket* bucket, float dt);
 
 
     float _timeScale;
@@ -442,15 +558,23 @@ protected:
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    std::vector<UpdateBucket*> _updateBuckets;          // sorted by priority
+    std::deque<UpdateSlot> _updateSlots;                // a deque: the callbacks are not moved when a slot is added
+    std::vector<int> _freeUpdateSlots;
+    std::unordered_map<void*, int> _updateSlotsByTarget; // used to fetch quickly the entries for pause,delete,etc
+    int _currentUpdateBucket;                           // index of the bucket being updated, -1 if none
+    ThreadPool* _updatePool;
+    bool _updatingConcurrently;
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+    // the timers are triggered when they are due, only the due ones are touched by a tick
+    TimerWheel _timerWheel;
+    double _timersTime;                 // sum of the scaled dt of the ticks
+    double _timersTimeBeforeTick;
+    unsigned int _timersScheduleOrder;
+    std::vector<Timer*> _dueTimers;     // retained while they are triggered
+    std::vector<Timer*> _pendingTimers; // retained until they start
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
@@ -459,8 +583,8 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    TaskQueue _functionsToPerform;
+    float _functionsToPerformBudget;
 };
 
 // end of global group
@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCTaskQueue.h"
+#include "base/ccMacros.h"
+
+#include <chrono>
+
+NS_CC_BEGIN
+
+TaskQueue::TaskQueue()
+: _head(&_stub)
+, _tail(&_stub)
+, _queuedTasks(0)
+, _lateTasks(0)
+, _runs(0)
+{
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    _stub.owner = nullptr;
+    _stub.postedRun = 0;
+}
+
+TaskQueue::~TaskQueue()
+{
+    while (Entry* entry = next())
+    {
+        delete entry;
+    }
+}
+
+void TaskQueue::post(const std::function<void()>& task, const void* owner)
+{
+    Entry* entry = new Entry();
+    entry->task = task;
+    entry->owner = owner;
+    entry->postedRun = _runs.load(std::memory_order_relaxed);
+
+    _queuedTasks.fetch_add(1, std::memory_order_relaxed);
+    push(entry);
+}
+
+void TaskQueue::push(Entry* entry)
+{
+    entry->next.store(nullptr, std::memory_order_relaxed);
+    Entry* prev = _head.exchange(entry, std::memory_order_acq_rel);
+    // until this store, the entries pushed after this one can't be reached by the consumer
+    prev->next.store(entry, std::memory_order_release);
+}
+
+TaskQueue::Entry* TaskQueue::pop()
+{
+    Entry* tail = _tail;
+    Entry* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_stub)
+    {
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    if (tail != _head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    // the tail is the last entry, the stub takes its place so it can be returned
+    push(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+TaskQueue::Entry* TaskQueue::next()
+{
+    if (!_taken.empty())
+    {
+        Entry* entry = _taken.front();
+        _taken.pop_front();
+        return entry;
+    }
+    return pop();
+}
+
+int TaskQueue::run(float budget)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const unsigned int run = _runs.fetch_add(1, std::memory_order_relaxed) + 1;
+    const auto begin = Clock::now();
+
+    int count = 0;
+    while (Entry* entry = next())
+    {
+        if (entry->postedRun >= run)
+        {
+            // posted by a task of this run
+            _taken.push_front(entry);
+            break;
+        }
+        if (entry->postedRun + 1 < run)
+        {
+            _lateTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+        _queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+
+        entry->task();
+        delete entry;
+        ++count;
+
+        if (budget > 0 && std::chrono::duration<float>(Clock::now() - begin).count() >= budget)
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+void TaskQueue::cancel(const void* owner)
+{
+    CCASSERT(owner != nullptr, "The tasks without owner can't be cancelled");
+
+    while (Entry* entry = pop())
+    {
+        _taken.push_back(entry);
+    }
+
+    for (auto iter = _taken.begin(); iter != _taken.end(); )
+    {
+        if ((*iter)->owner == owner)
+        {
+            delete *iter;
+            iter = _taken.erase(iter);
+            _queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_TASK_QUEUE_H__
+#define __CC_TASK_QUEUE_H__
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** Queue of tasks posted from any thread and run by a single thread, used by the Scheduler to run the functions
+ of performFunctionInCocosThread().
+
+ Posting never locks: the tasks are linked in an intrusive multi-producer single-consumer list.
+ A run can be given a time budget, the tasks left when it is spent wait for the next run in the same order.
+ */
+class CC_DLL TaskQueue
+{
+public:
+    TaskQueue();
+    ~TaskQueue();
+
+    /** Adds a task. Can be called from any thread.
+     @param owner Optional tag of the task, for cancel().
+     */
+    void post(const std::function<void()>& task, const void* owner = nullptr);
+
+    /** Runs the tasks in the order they were posted, until the budget is spent.
+     At least one task is run. The tasks posted while running wait for the next run.
+     Must always be called from the same thread.
+     @param budget Seconds, or 0 to run all the tasks.
+     @return The number of tasks run.
+     */
+    int run(float budget = 0);
+
+    /** Drops the waiting tasks of an owner. Must be called from the thread calling run().
+     The tasks posted by other threads at the same time may be missed, so stop them from posting first.
+     */
+    void cancel(const void* owner);
+
+    /** Number of tasks waiting to run */
+    int getQueuedTaskCount() const { return _queuedTasks.load(std::memory_order_relaxed); }
+    /** Number of tasks which didn't run in the first run after being posted, because its budget was spent */
+    unsigned int getLateTaskCount() const { return _lateTasks.load(std::memory_order_relaxed); }
+
+protected:
+    struct Entry
+    {
+        std::atomic<Entry*> next;
+        std::function<void()> task;
+        const void* owner;
+        // number of runs started when it was posted
+        unsigned int postedRun;
+    };
+
+    void push(Entry* entry);
+    // the oldest entry of the list, or nullptr when it is empty or a producer is in the middle of a push
+    Entry* pop();
+    Entry* next();
+
+    // producers push to the head, the consumer pops from the tail
+    std::atomic<Entry*> _head;
+    Entry* _tail;
+    Entry _stub;
+    // entries already taken from the list by the consumer, older than the ones in the list
+    std::deque<Entry*> _taken;
+
+    std::atomic<int> _queuedTasks;
+    std::atomic<unsigned int> _lateTasks;
+    std::atomic<unsigned int> _runs;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TaskQueue);
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_TASK_QUEUE_H__
@@ -0,0 +1,136 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCThreadPool.h"
+
+#include <atomic>
+#include <algorithm>
+
+NS_CC_BEGIN
+
+ThreadPool::ThreadPool(int threadCount)
+: _stop(false)
+{
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _stop = true;
+    }
+    _tasksCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(const std::function<void()>& task)
+{
+    if (_workers.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _tasks.push(task);
+    }
+    _tasksCondition.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_tasksMutex);
+            _tasksCondition.wait(lock, [this](){ return _stop || !_tasks.empty(); });
+
+            if (_stop && _tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+{
+    if (count == 0)
+        return;
+
+    grainSize = std::max(grainSize, (size_t)1);
+    const size_t chunks = (count + grainSize - 1) / grainSize;
+    const size_t helpers = std::min(_workers.size(), chunks - 1);
+
+    if (helpers == 0)
+    {
+        func(0, count);
+        return;
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    size_t finishedHelpers = 0;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+
+    auto processChunks = [&]() {
+        size_t chunk;
+        while ((chunk = nextChunk.fetch_add(1)) < chunks)
+        {
+            size_t begin = chunk * grainSize;
+            func(begin, std::min(count, begin + grainSize));
+        }
+    };
+
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        enqueue([&]() {
+            processChunks();
+
+            // the locals of parallelFor must outlive every helper, so signal only after the last access
+            std::lock_guard<std::mutex> lock(doneMutex);
+            ++finishedHelpers;
+            doneCondition.notify_one();
+        });
+    }
+
+    processChunks();
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&](){ return finishedHelpers == helpers; });
+}
+
+NS_CC_END
@@ -0,0 +1,87 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_THREAD_POOL_H__
+#define __CC_THREAD_POOL_H__
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** A fixed size pool of worker threads.
+
+ Tasks are executed in FIFO order. `parallelFor` splits a range of work in chunks and
+ processes them on the workers and on the calling thread, returning once every chunk is done.
+ The workers must not touch OpenGL nor any other cocos2d object that is not thread safe.
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** Creates a pool with `threadCount` workers. A pool with 0 workers runs everything on the calling thread. */
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    /** Number of worker threads (not counting the calling thread) */
+    int getThreadCount() const { return static_cast<int>(_workers.size()); }
+
+    /** Queues a task. It will be executed by one of the workers. */
+    void enqueue(const std::function<void()>& task);
+
+    /** Calls `func(begin, end)` for consecutive chunks of at most `grainSize` elements of [0, count).
+     Chunks can run concurrently, so `func` must only touch the range it was given.
+     Blocks until all the chunks were processed.
+     */
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func);
+
+protected:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _tasksMutex;
+    std::condition_variable _tasksCondition;
+    bool _stop;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_THREAD_POOL_H__
@@ -0,0 +1,184 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCTimerWheel.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static const int SLOT_MASK = TimerWheel::SLOTS - 1;
+
+TimerWheel::TimerWheel(double resolution)
+: _resolution(resolution)
+, _currentUnit(0)
+, _size(0)
+{
+    CCASSERT(resolution > 0, "Invalid resolution");
+    std::fill(_heads, _heads + LEVELS * SLOTS, -1);
+}
+
+long long TimerWheel::getUnit(double time) const
+{
+    return (long long)std::floor(time / _resolution);
+}
+
+int TimerWheel::insert(Timer* timer, double dueTime)
+{
+    int handle;
+    if (_freeNodes.empty())
+    {
+        handle = (int)_nodes.size();
+        _nodes.push_back(Node());
+    }
+    else
+    {
+        handle = _freeNodes.back();
+        _freeNodes.pop_back();
+    }
+
+    Node& node = _nodes[handle];
+    node.timer = timer;
+    node.dueTime = dueTime;
+    link(handle);
+
+    ++_size;
+    return handle;
+}
+
+void TimerWheel::remove(int handle)
+{
+    unlink(handle);
+    _nodes[handle].timer = nullptr;
+    _freeNodes.push_back(handle);
+
+    --_size;
+}
+
+void TimerWheel::link(int handle)
+{
+    Node& node = _nodes[handle];
+
+    // the timers already due go in the slot of the current unit
+    long long unit = std::max(getUnit(node.dueTime), _currentUnit);
+    long long delta = unit - _currentUnit;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1LL << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    // beyond the last level: it will be moved down early, and placed again from its due time
+    if (delta >= (1LL << (SLOT_BITS * LEVELS)))
+    {
+        unit = _currentUnit + (1LL << (SLOT_BITS * LEVELS)) - 1;
+    }
+
+    int slot = (int)((unit >> (SLOT_BITS * level)) & SLOT_MASK);
+    int list = level * SLOTS + slot;
+
+    node.list = list;
+    node.prev = -1;
+    node.next = _heads[list];
+    if (node.next >= 0)
+    {
+        _nodes[node.next].prev = handle;
+    }
+    _heads[list] = handle;
+}
+
+void TimerWheel::unlink(int handle)
+{
+    Node& node = _nodes[handle];
+
+    if (node.prev >= 0)
+    {
+        _nodes[node.prev].next = node.next;
+    }
+    else
+    {
+        _heads[node.list] = node.next;
+    }
+
+    if (node.next >= 0)
+    {
+        _nodes[node.next].prev = node.prev;
+    }
+}
+
+void TimerWheel::cascade(int level, int slot)
+{
+    int list = level * SLOTS + slot;
+    int handle = _heads[list];
+    _heads[list] = -1;
+
+    while (handle >= 0)
+    {
+        int next = _nodes[handle].next;
+        link(handle);
+        handle = next;
+    }
+}
+
+void TimerWheel::collectDue(double now, std::vector<Timer*>& due)
+{
+    const long long nowUnit = getUnit(now);
+
+    while (true)
+    {
+        // the first level has a slot per unit: all the timers of the slot are in the current unit
+        int handle = _heads[_currentUnit & SLOT_MASK];
+        while (handle >= 0)
+        {
+            int next = _nodes[handle].next;
+            if (_nodes[handle].dueTime <= now)
+            {
+                due.push_back(_nodes[handle].timer);
+                remove(handle);
+            }
+            handle = next;
+        }
+
+        if (_currentUnit >= nowUnit)
+            break;
+
+        ++_currentUnit;
+
+        // moves down the timers of the upper slots that the current unit reached
+        for (int level = 1; level < LEVELS; ++level)
+        {
+            if ((_currentUnit & ((1LL << (SLOT_BITS * level)) - 1)) != 0)
+                break;
+
+            cascade(level, (int)((_currentUnit >> (SLOT_BITS * level)) & SLOT_MASK));
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_TIMER_WHEEL_H__
+#define __CC_TIMER_WHEEL_H__
+
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+class Timer;
+
+/** Hierarchical timing wheel used by the Scheduler to find the timers that are due.
+
+ The time is divided in units of `resolution` seconds. The first level has a slot per unit for the next 256 units,
+ and every other level has slots 256 times wider. The timers of a slot of an upper level are moved to the lower
+ levels when the time reaches the slot. So a tick only touches the timers that are due, plus the ones moved down,
+ instead of every timer.
+ */
+class CC_DLL TimerWheel
+{
+public:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    explicit TimerWheel(double resolution = 1.0 / 128);
+
+    /** Adds a timer due at `dueTime` seconds. Returns the handle used to remove it */
+    int insert(Timer* timer, double dueTime);
+    /** Removes a timer that was not returned by collectDue() */
+    void remove(int handle);
+
+    /** Removes the timers due at or before `now`, and appends them to `due`.
+     The timers inserted afterwards with a due time before `now` are collected by the next call.
+     */
+    void collectDue(double now, std::vector<Timer*>& due);
+
+    /** Number of timers in the wheel */
+    size_t size() const { return _size; }
+
+protected:
+    struct Node
+    {
+        Timer* timer;
+        double dueTime;
+        int prev;
+        int next;
+        int list;
+    };
+
+    long long getUnit(double time) const;
+    void link(int handle);
+    void unlink(int handle);
+    void cascade(int level, int slot);
+
+    double _resolution;
+    // all the units before this one are processed
+    long long _currentUnit;
+    std::vector<Node> _nodes;
+    std::vector<int> _freeNodes;
+    int _heads[LEVELS * SLOTS];
+    size_t _size;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_TIMER_WHEEL_H__
@@ -23,6 +23,7 @@
 ****************************************************************************/
 
 #include "base/CCValue.h"
+#include <string.h>
 #include <sstream>
 #include <iomanip>
 
@@ -36,59 +37,77 @@ const Value Value::Null;
 
 Value::Value()
 : _type(Type::NONE)
+, _isShortString(false)
 {
     memset(&_field, 0, sizeof(_field));
 }
 
 Value::Value(unsigned char v)
 : _type(Type::BYTE)
+, _isShortString(false)
 {
     _field.byteVal = v;
 }
 
 Value::Value(int v)
 : _type(Type::INTEGER)
+, _isShortString(false)
 {
     _field.intVal = v;
 }
 
 Value::Value(float v)
 : _type(Type::FLOAT)
+, _isShortString(false)
 {
     _field.floatVal = v;
 }
 
 Value::Value(double v)
 : _type(Type::DOUBLE)
+, _isShortString(false)
 {
     _field.doubleVal = v;
 }
 
 Value::Value(bool v)
 : _type(Type::BOOLEAN)
+, _isShortString(false)
 {
     _field.boolVal = v;
 }
 
 Value::Value(const char* v)
 : _type(Type::STRING)
+, _isShortString(true)
 {
-    _field.strVal = new std::string();
     if (v)
     {
-        *_field.strVal = v;
+        setString(v, strlen(v));
+    }
+    else
+    {
+        setString("", 0);
     }
 }
 
 Value::Value(const std::string& v)
 : _type(Type::STRING)
+, _isShortString(true)
 {
-    _field.strVal = new std::string();
-    *_field.strVal = v;
+    setString(v.c_str(), v.length());
+}
+
+Value::Value(std::string&& v)
+: _type(Type::STRING)
+, _isShortString(true)
+{
+    setString(std::move(v));
 }
 
 Value::Value(const ValueVector& v)
 : _type(Type::VECTOR)
+, _isShortString(false)
 {
     _field.vectorVal = new ValueVector();
     *_field.vectorVal = v;
@@ -96,6 +115,7 @@ Value::Value(const ValueVector& v)
 
 Value::Value(ValueVector&& v)
 : _type(Type::VECTOR)
+, _isShortString(false)
 {
     _field.vectorVal = new ValueVector();
     *_field.vectorVal = std::move(v);
@@ -103,6 +123,7 @@ Value::Value(ValueVector&& v)
 
 Value::Value(const ValueMap& v)
 : _type(Type::MAP)
+, _isShortString(false)
 {
     _field.mapVal = new ValueMap();
     *_field.mapVal = v;
@@ -110,6 +131,7 @@ Value::Value(const ValueMap& v)
 
 Value::Value(ValueMap&& v)
 : _type(Type::MAP)
+, _isShortString(false)
 {
     _field.mapVal = new ValueMap();
     *_field.mapVal = std::move(v);
@@ -117,6 +139,7 @@ Value::Value(ValueMap&& v)
 
 Value::Value(const ValueMapIntKey& v)
 : _type(Type::INT_KEY_MAP)
+, _isShortString(false)
 {
     _field.intKeyMapVal = new ValueMapIntKey();
     *_field.intKeyMapVal = v;
@@ -124,6 +147,7 @@ Value::Value(const ValueMapIntKey& v)
 
 Value::Value(ValueMapIntKey&& v)
 : _type(Type::INT_KEY_MAP)
+, _isShortString(false)
 {
     _field.intKeyMapVal = new ValueMapIntKey();
     *_field.intKeyMapVal = std::move(v);
@@ -131,12 +155,14 @@ Value::Value(ValueMapIntKey&& v)
 
 Value::Value(const Value& other)
 : _type(Type::NONE)
+, _isShortString(false)
 {
     *this = other;
 }
 
 Value::Value(Value&& other)
 : _type(Type::NONE)
+, _isShortString(false)
 {
     *this = std::move(other);
 }
@@ -168,11 +194,7 @@ Value& Value::operator= (const Value& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                if (_field.strVal == nullptr)
-                {
-                    _field.strVal = new std::string();
-                }
-                *_field.strVal = *other._field.strVal;
+                setString(other.getStringData(), other.getStringLength());
                 break;
             case Type::VECTOR:
                 if (_field.vectorVal == nullptr)
@@ -207,42 +229,14 @@ Value& Value::operator= (Value&& other)
     if (this != &other)
     {
         clear();
-        switch (other._type)
-        {
-            case Type::BYTE:
-                _field.byteVal = other._field.byteVal;
-                break;
-            case Type::INTEGER:
-                _field.intVal = other._field.intVal;
-                break;
-            case Type::FLOAT:
-                _field.floatVal = other._field.floatVal;
-                break;
-            case Type::DOUBLE:
-                _field.doubleVal = other._field.doubleVal;
-                break;
-            case Type::BOOLEAN:
-                _field.boolVal = other._field.boolVal;
-                break;
-            case Type::STRING:
-                _field.strVal = other._field.strVal;
-                break;
-            case Type::VECTOR:
-                _field.vectorVal = other._field.vectorVal;
-                break;
-            case Type::MAP:
-                _field.mapVal = other._field.mapVal;
-                break;
-            case Type::INT_KEY_MAP:
-                _field.intKeyMapVal = other._field.intKeyMapVal;
-                break;
-            default:
-                break;
-        }
+        // every member of the union is a plain value, or a pointer which changes hands
+        memcpy(&_field, &other._field, sizeof(_field));
         _type = other._type;
+        _isShortString = other._isShortString;
 
         memset(&other._field, 0, sizeof(other._field));
         other._type = Type::NONE;
+        other._isShortString = false;
     }
 
     return *this;
@@ -286,14 +280,28 @@ Value& Value::operator= (bool v)
 Value& Value::operator= (const char* v)
 {
     reset(Type::STRING);
-    *_field.strVal = v ? v : "";
+    if (v)
+    {
+        setString(v, strlen(v));
+    }
+    else
+    {
+        setString("", 0);
+    }
     return *this;
 }
 
 Value& Value::operator= (const std::string& v)
 {
     reset(Type::STRING);
-    *_field.strVal = v;
+    setString(v.c_str(), v.length());
+    return *this;
+}
+
+Value& Value::operator= (std::string&& v)
+{
+    reset(Type::STRING);
+    setString(std::move(v));
     return *this;
 }
 
@@ -356,7 +364,7 @@ unsigned char Value::asByte() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<unsigned char>(atoi(_field.strVal->c_str()));
+        return static_cast<unsigned char>(atoi(getStringData()));
     }
 
     if (_type == Type::FLOAT)
@@ -392,7 +400,7 @@ int Value::asInt() const
 
     if (_type == Type::STRING)
     {
-        return atoi(_field.strVal->c_str());
+        return atoi(getStringData());
     }
 
     if (_type == Type::FLOAT)
@@ -428,7 +436,7 @@ float Value::asFloat() const
 
     if (_type == Type::STRING)
     {
-        return atof(_field.strVal->c_str());
+        return atof(getStringData());
     }
 
     if (_type == Type::INTEGER)
@@ -464,7 +472,7 @@ double Value::asDouble() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<double>(atof(_field.strVal->c_str()));
+        return static_cast<double>(atof(getStringData()));
     }
 
     if (_type == Type::INTEGER)
@@ -500,7 +508,7 @@ bool Value::asBool() const
 
     if (_type == Type::STRING)
     {
-        return (*_field.strVal == "0" || *_field.strVal == "false") ? false : true;
+        return (strcmp(getStringData(), "0") == 0 || strcmp(getStringData(), "false") == 0) ? false : true;
     }
 
     if (_type == Type::INTEGER)
@@ -527,7 +535,7 @@ std::string Value::asString() const
 
     if (_type == Type::STRING)
     {
-        return *_field.strVal;
+        return std::string(getStringData(), getStringLength());
     }
 
     std::stringstream ret;
@@ -707,7 +715,11 @@ void Value::clear()
             _field.boolVal = false;
             break;
         case Type::STRING:
-            CC_SAFE_DELETE(_field.strVal);
+            if (!_isShortString)
+            {
+                CC_SAFE_DELETE(_field.strVal);
+            }
+            _isShortString = false;
             break;
         case Type::VECTOR:
             CC_SAFE_DELETE(_field.vectorVal);
@@ -736,7 +748,10 @@ void Value::reset(Type type)
     switch (type)
     {
         case Type::STRING:
-            _field.strVal = new std::string();
+            // an empty short string
+            _field.shortStrVal.data[0] = '\0';
+            _field.shortStrVal.length = 0;
+            _isShortString = true;
             break;
         case Type::VECTOR:
             _field.vectorVal = new ValueVector();
@@ -754,4 +769,46 @@ void Value::reset(Type type)
     _type = type;
 }
 
+void Value::setString(const char* str, size_t length)
+{
+    if (length <= SHORT_STRING_CAPACITY)
+    {
+        if (!_isShortString)
+        {
+            delete _field.strVal;
+            _isShortString = true;
+        }
+        memcpy(_field.shortStrVal.data, str, length);
+        _field.shortStrVal.data[length] = '\0';
+        _field.shortStrVal.length = static_cast<unsigned char>(length);
+    }
+    else if (_isShortString)
+    {
+        _field.strVal = new std::string(str, length);
+        _isShortString = false;
+    }
+    else
+    {
+        // reuse the allocated string
+        _field.strVal->assign(str, length);
+    }
+}
+
+void Value::setString(std::string&& str)
+{
+    if (str.length() <= SHORT_STRING_CAPACITY)
+    {
+        setString(str.c_str(), str.length());
+    }
+    else if (_isShortString)
+    {
+        _field.strVal = new std::string(std::move(str));
+        _isShortString = false;
+    }
+    else
+    {
+        *_field.strVal = std::move(str);
+    }
+}
+
 NS_CC_END
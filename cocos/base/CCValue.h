@@ -27,27 +27,41 @@
 
 #include "base/CCPlatformMacros.h"
 #include "base/ccMacros.h"
+#include "base/ccConfig.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
+#if CC_USE_FLAT_VALUE_MAP
+#include "base/CCFlatMap.h"
+#endif
 
 NS_CC_BEGIN
 
 class Value;
 
 typedef std::vector<Value> ValueVector;
+#if CC_USE_FLAT_VALUE_MAP
+typedef FlatMap<std::string, Value> ValueMap;
+#else
 typedef std::unordered_map<std::string, Value> ValueMap;
+#endif
 typedef std::unordered_map<int, Value> ValueMapIntKey;
 
 extern const ValueVector ValueVectorNull;
 extern const ValueMap ValueMapNull;
 extern const ValueMapIntKey ValueMapIntKeyNull;
 
+/** A variant holding a number, a string, or a container of Values.
+ The strings up to SHORT_STRING_CAPACITY characters are stored in the Value itself, the longer ones and the containers
+ are allocated, so moving a Value never allocates and the containers keep their address when it is moved.
+ */
 class Value
 {
 public:
     static const Value Null;
 
+    static const size_t SHORT_STRING_CAPACITY = 22;
+
     Value();
     explicit Value(unsigned char v);
     explicit Value(int v);
@@ -56,6 +70,7 @@ public:
     explicit Value(bool v);
     explicit Value(const char* v);
     explicit Value(const std::string& v);
+    explicit Value(std::string&& v);
 
     explicit Value(const ValueVector& v);
     explicit Value(ValueVector&& v);
@@ -81,6 +96,7 @@ public:
     Value& operator= (bool v);
     Value& operator= (const char* v);
     Value& operator= (const std::string& v);
+    Value& operator= (std::string&& v);
 
     Value& operator= (const ValueVector& v);
     Value& operator= (ValueVector&& v);
@@ -131,6 +147,12 @@ private:
     void clear();
     void reset(Type type);
 
+    // the string of a Type::STRING value, short or not
+    void setString(const char* str, size_t length);
+    void setString(std::string&& str);
+    const char* getStringData() const { return _isShortString ? _field.shortStrVal.data : _field.strVal->c_str(); }
+    size_t getStringLength() const { return _isShortString ? _field.shortStrVal.length : _field.strVal->length(); }
+
     union
     {
         unsigned char byteVal;
@@ -140,12 +162,18 @@ private:
         bool boolVal;
 
         std::string* strVal;
+        struct
+        {
+            char data[SHORT_STRING_CAPACITY + 1];
+            unsigned char length;
+        } shortStrVal;
         ValueVector* vectorVal;
         ValueMap* mapVal;
         ValueMapIntKey* intKeyMapVal;
     }_field;
 
     Type _type;
+    bool _isShortString;
 };
 
 NS_CC_END
@@ -251,6 +251,17 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_NODE_DEBUG_VERIFY_EVENT_LISTENERS 0
 #endif
 
+/** @def CC_ENABLE_LAZY_MATRIX_STACK
+ If enabled, Node::visit() doesn't copy the modelview matrix of every node to the Director matrix stack.
+ The matrix is copied only when the stack is used while the node is visited, e.g. by DrawPrimitives or kmGL calls.
+ It can be changed at runtime with Director::setLazyMatrixStackEnabled().
+
+ Enabled by default.
+ */
+#ifndef CC_ENABLE_LAZY_MATRIX_STACK
+#define CC_ENABLE_LAZY_MATRIX_STACK 1
+#endif
+
 /** @def CC_ENABLE_PROFILERS
  If enabled, will activate various profilers within cocos2d. This statistical data will be output to the console
  once per second showing average time (in milliseconds) required to execute the specific routine(s).
@@ -262,6 +273,28 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_ATOMIC_REFERENCE_COUNT
+ If enabled, the reference count of every Ref is updated atomically, so the objects can be retained and released
+ from several threads. Otherwise only the classes calling Ref::setReferenceCountThreadSafe() pay for it,
+ like Texture2D, Image and SpriteFrame which are prepared by the loader threads.
+
+ Disabled by default.
+ */
+#ifndef CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#define CC_ENABLE_ATOMIC_REFERENCE_COUNT 0
+#endif
+
+/** @def CC_USE_FLAT_VALUE_MAP
+ If enabled, ValueMap is a FlatMap, which keeps its entries sorted in one array, instead of a std::unordered_map.
+ The dictionaries read from the plist files then cost one allocation each instead of one per entry,
+ but inserting in a big ValueMap out of order is slower, and it invalidates the references to its entries.
+
+ Disabled by default.
+ */
+#ifndef CC_USE_FLAT_VALUE_MAP
+#define CC_USE_FLAT_VALUE_MAP 0
+#endif
+
 /** Enable Lua engine debug log */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
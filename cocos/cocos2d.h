@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "base/CCRefPtr.h"
 #include "base/CCVector.h"
 #include "base/CCMap.h"
+#include "base/CCFlatMap.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCNS.h"
 #include "base/CCData.h"
@@ -52,6 +53,7 @@ THE SOFTWARE.
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCProfiling.h"
@@ -107,6 +109,7 @@ THE SOFTWARE.
 
 // 2d nodes
 #include "2d/CCNode.h"
+#include "2d/CCTransformSystem.h"
 #include "2d/CCAtlasNode.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCDrawNode.h"
@@ -152,7 +155,9 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/ccShaders.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCPixelConversion.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCTextureTranscoder.h"
 
 // physics
 #include "physics/CCPhysicsBody.h"
@@ -927,7 +927,7 @@ Node * NodeLoader::parsePropTypeCCBFile(Node * pNode, Node * pParent, CCBReader
     // Load sub file
     std::string path = FileUtils::getInstance()->fullPathForFilename(ccbFileName.c_str());
 
-    auto dataPtr = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(path));
+    auto dataPtr = std::make_shared<Data>(FileUtils::getInstance()->getMappedDataFromFile(path));
     
     CCBReader * reader = new CCBReader(pCCBReader);
     reader->autorelease();
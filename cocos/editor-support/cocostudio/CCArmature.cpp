@@ -344,6 +344,7 @@ void Armature::setAnchorPoint(const Vec2& point)
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x - _offsetPoint.x, _contentSize.height * _anchorPoint.y - _offsetPoint.y);
         _realAnchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformDirty = _inverseDirty = true;
+        setSubtreeDirty();
     }
 }
 
@@ -463,8 +464,7 @@ void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, b
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
 
     sortAllChildren();
@@ -473,7 +473,7 @@ void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, b
     // reset for next frame
     _orderOfArrival = 0;
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 Rect Armature::getBoundingBox() const
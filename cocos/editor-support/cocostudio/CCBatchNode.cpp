@@ -119,8 +119,7 @@ void BatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool pare
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     sortAllChildren();
     draw(renderer, _modelViewTransform, dirty);
@@ -128,7 +127,7 @@ void BatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool pare
     // reset for next frame
     _orderOfArrival = 0;
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 void BatchNode::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
@@ -153,6 +153,8 @@ void DataReaderHelper::loadData()
 {
     AsyncStruct *pAsyncStruct = nullptr;
 
+    auto scheduler = Director::getInstance()->getScheduler();
+
     while (true)
     {
         std::queue<AsyncStruct *> *pQueue = _asyncStructQueue;
@@ -193,10 +195,12 @@ void DataReaderHelper::loadData()
             DataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
         }
 
-        // put the image info into the queue
+        // put the image info into the queue, the cocos thread adds its sprite frames
         _dataInfoMutex.lock();
         _dataQueue->push(pDataInfo);
         _dataInfoMutex.unlock();
+
+        scheduler->performFunctionInCocosThread([this](){ addDataAsyncCallBack(0); }, this);
     }
 
     if( _asyncStructQueue != nullptr )
@@ -253,7 +257,12 @@ DataReaderHelper::~DataReaderHelper()
     need_quit = true;
 
 	_sleepCondition.notify_one();
-	if (_loadingThread) _loadingThread->join();
+	if (_loadingThread)
+	{
+		_loadingThread->join();
+		// the queue of the data infos was deleted by the loading thread
+		Director::getInstance()->getScheduler()->cancelFunctionsToPerform(this);
+	}
 
 	CC_SAFE_DELETE(_loadingThread);
 	_dataReaderHelper = nullptr;
@@ -361,11 +370,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
         need_quit = false;
     }
 
-    if (0 == _asyncRefCount)
-    {
-        Director::getInstance()->getScheduler()->schedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this, 0, false);
-    }
-
     ++_asyncRefCount;
     ++_asyncRefTotalCount;
 
@@ -466,7 +470,6 @@ void DataReaderHelper::addDataAsyncCallBack(float dt)
         if (0 == _asyncRefCount)
         {
             _asyncRefTotalCount = 0;
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this);
         }
     }
 }
@@ -761,6 +761,19 @@ public:
      */
     void transformPoint(const Vec3& point, Vec3* dst) const;
 
+    /**
+     * Transforms an array of points by this matrix.
+     *
+     * The results are stored directly into the points. Consecutive points are
+     * `stride` bytes apart, so interleaved vertex data can be transformed in place.
+     * Uses SSE/NEON when available.
+     *
+     * @param points The first point to transform.
+     * @param count The number of points to transform.
+     * @param stride The distance in bytes between two consecutive points.
+     */
+    void transformPoints(Vec3* points, size_t count, size_t stride = sizeof(Vec3)) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -86,6 +86,8 @@ private:
 
     inline static void transformVec4(const float* m, const float* v, float* dst);
 
+    inline static void transformVec3Array(const float* m, float* v, size_t count, size_t stride);
+
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 
     MathUtil();
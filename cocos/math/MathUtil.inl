@@ -18,6 +18,10 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
@@ -102,6 +106,30 @@ inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
 
 inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
 {
+#ifdef __SSE__
+    // Every column of the product is a combination of the columns of m1. All of them are
+    // computed before storing, which supports the case where m1 or m2 is the same array as dst.
+    const __m128 col0 = _mm_loadu_ps(&m1[0]);
+    const __m128 col1 = _mm_loadu_ps(&m1[4]);
+    const __m128 col2 = _mm_loadu_ps(&m1[8]);
+    const __m128 col3 = _mm_loadu_ps(&m1[12]);
+
+    __m128 product[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        const float* c = &m2[i * 4];
+        __m128 r = _mm_mul_ps(col0, _mm_set1_ps(c[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(col1, _mm_set1_ps(c[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(col2, _mm_set1_ps(c[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(col3, _mm_set1_ps(c[3])));
+        product[i] = r;
+    }
+
+    _mm_storeu_ps(&dst[0], product[0]);
+    _mm_storeu_ps(&dst[4], product[1]);
+    _mm_storeu_ps(&dst[8], product[2]);
+    _mm_storeu_ps(&dst[12], product[3]);
+#else
     // Support the case where m1 or m2 is the same array as dst.
     float product[16];
 
@@ -126,6 +154,7 @@ inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* ds
     product[15] = m1[3] * m2[12] + m1[7] * m2[13] + m1[11] * m2[14] + m1[15] * m2[15];
 
     memcpy(dst, product, MATRIX_SIZE);
+#endif
 }
 
 inline void MathUtil::negateMatrix(const float* m, float* dst)
@@ -180,6 +209,42 @@ inline void MathUtil::transformVec4(const float* m, const float* v, float* dst)
     dst[3] = w;
 }
 
+inline void MathUtil::transformVec3Array(const float* m, float* v, size_t count, size_t stride)
+{
+    // Points are transformed in place with w = 1. Only x, y and z are written, so the
+    // vertex attributes interleaved after them (stride bytes apart) are left untouched.
+    char* p = (char*)v;
+#ifdef __SSE__
+    const __m128 col0 = _mm_loadu_ps(&m[0]);
+    const __m128 col1 = _mm_loadu_ps(&m[4]);
+    const __m128 col2 = _mm_loadu_ps(&m[8]);
+    const __m128 col3 = _mm_loadu_ps(&m[12]);
+
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* point = (float*)p;
+        __m128 r = _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(point[0])), col3);
+        r = _mm_add_ps(r, _mm_mul_ps(col1, _mm_set1_ps(point[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(col2, _mm_set1_ps(point[2])));
+
+        _mm_storel_pi((__m64*)point, r);
+        _mm_store_ss(&point[2], _mm_movehl_ps(r, r));
+    }
+#else
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* point = (float*)p;
+        float x = point[0];
+        float y = point[1];
+        float z = point[2];
+
+        point[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        point[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        point[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+#endif
+}
+
 inline void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 {
     float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
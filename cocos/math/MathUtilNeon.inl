@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
@@ -220,6 +222,28 @@ inline void MathUtil::transformVec4(const float* m, const float* v, float* dst)
     );
 }
 
+inline void MathUtil::transformVec3Array(const float* m, float* v, size_t count, size_t stride)
+{
+    // Points are transformed in place with w = 1. Only x, y and z are written, so the
+    // vertex attributes interleaved after them (stride bytes apart) are left untouched.
+    const float32x4_t col0 = vld1q_f32(&m[0]);
+    const float32x4_t col1 = vld1q_f32(&m[4]);
+    const float32x4_t col2 = vld1q_f32(&m[8]);
+    const float32x4_t col3 = vld1q_f32(&m[12]);
+
+    char* p = (char*)v;
+    for (size_t i = 0; i < count; ++i, p += stride)
+    {
+        float* point = (float*)p;
+        float32x4_t r = vmlaq_n_f32(col3, col0, point[0]);
+        r = vmlaq_n_f32(r, col1, point[1]);
+        r = vmlaq_n_f32(r, col2, point[2]);
+
+        vst1_f32(point, vget_low_f32(r));
+        vst1q_lane_f32(&point[2], r, 2);
+    }
+}
+
 inline void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 {
     asm volatile(
@@ -45,7 +45,6 @@ NS_CC_BEGIN
 namespace network {
 
 static std::mutex       s_requestQueueMutex;
-static std::mutex       s_responseQueueMutex;
 
 static std::mutex		s_SleepMutex;
 static std::condition_variable		s_SleepCondition;
@@ -58,7 +57,6 @@ typedef int int32_t;
 static bool s_need_quit = false;
 
 static Vector<HttpRequest*>*  s_requestQueue = nullptr;
-static Vector<HttpResponse*>* s_responseQueue = nullptr;
 
 static HttpClient *s_pHttpClient = nullptr; // pointer to singleton
 
@@ -209,14 +207,15 @@ void HttpClient::networkThread()
         }
 
         
-        // add response packet into queue
-        s_responseQueueMutex.lock();
-        s_responseQueue->pushBack(response);
-        s_responseQueueMutex.unlock();
-        
-        if (nullptr != s_pHttpClient) {
-            scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
+        // pass the response packet to the cocos thread, the client may be destroyed until then
+        scheduler->performFunctionInCocosThread([response](){
+            if (nullptr != s_pHttpClient) {
+                s_pHttpClient->dispatchResponseCallbacks(response);
+            }
+            else {
+                response->release();
+            }
+        });
     }
     
     // cleanup: if worker thread received quit signal, clean up un-completed request queue
@@ -228,8 +227,6 @@ void HttpClient::networkThread()
     if (s_requestQueue != nullptr) {
         delete s_requestQueue;
         s_requestQueue = nullptr;
-        delete s_responseQueue;
-        s_responseQueue = nullptr;
     }
     
 }
@@ -443,7 +440,6 @@ bool HttpClient::lazyInitThreadSemphore()
     } else {
         
         s_requestQueue = new Vector<HttpRequest*>();
-        s_responseQueue = new Vector<HttpResponse*>();
         
         auto t = std::thread(CC_CALLBACK_0(HttpClient::networkThread, this));
         t.detach();
@@ -479,26 +475,10 @@ void HttpClient::send(HttpRequest* request)
     }
 }
 
-// Poll and notify main thread if responses exists in queue
-void HttpClient::dispatchResponseCallbacks()
+// Notify main thread of a response
+void HttpClient::dispatchResponseCallbacks(HttpResponse* response)
 {
     // log("CCHttpClient::dispatchResponseCallbacks is running");
-    //occurs when cocos thread fires but the network thread has already quited
-    if (nullptr == s_responseQueue) {
-        return;
-    }
-    HttpResponse* response = nullptr;
-    
-    s_responseQueueMutex.lock();
-
-    if (!s_responseQueue->empty())
-    {
-        response = s_responseQueue->at(0);
-        s_responseQueue->erase(0);
-    }
-    
-    s_responseQueueMutex.unlock();
-    
     if (response)
     {
         HttpRequest *request = response->getHttpRequest();
@@ -101,8 +101,8 @@ private:
      */
     bool lazyInitThreadSemphore();
     void networkThread();
-    /** Poll function called from main thread to dispatch callbacks when http requests finished **/
-    void dispatchResponseCallbacks();
+    /** Called from main thread to dispatch the callbacks of a finished http request, releases the response **/
+    void dispatchResponseCallbacks(HttpResponse* response);
     
 private:
     int _timeoutForConnect;
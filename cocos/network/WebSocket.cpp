@@ -67,8 +67,8 @@ public:
     // Quits sub-thread (websocket thread).
     void quitSubThread();
     
-    // Schedule callback function
-    virtual void update(float dt);
+    // Handles a message sent by sendMessageToUIThread(), in UI thread.
+    void handleMessageInUIThread(WsMessage *msg);
     
     // Sends message to UI thread. It's needed to be invoked in sub-thread.
     void sendMessageToUIThread(WsMessage *msg);
@@ -84,13 +84,13 @@ protected:
     void wsThreadEntryFunc();
     
 private:
-    std::list<WsMessage*>* _UIWsMessageQueue;
     std::list<WsMessage*>* _subThreadWsMessageQueue;
-    std::mutex   _UIWsMessageQueueMutex;
     std::mutex   _subThreadWsMessageQueueMutex;
     std::thread* _subThreadInstance;
     WebSocket* _ws;
     bool _needQuit;
+    // Set in UI thread, the messages which were not handled yet are dropped when it's false
+    bool _UIMessagesEnabled;
     friend class WebSocket;
 };
 
@@ -118,19 +118,17 @@ WsThreadHelper::WsThreadHelper()
 : _subThreadInstance(nullptr)
 , _ws(nullptr)
 , _needQuit(false)
+, _UIMessagesEnabled(true)
 {
-    _UIWsMessageQueue = new std::list<WsMessage*>();
     _subThreadWsMessageQueue = new std::list<WsMessage*>();
-    
-    Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
 }
 
 WsThreadHelper::~WsThreadHelper()
 {
-    Director::getInstance()->getScheduler()->unscheduleAllForTarget(this);
     joinSubThread();
+    // No more messages can be sent, drops the ones waiting for UI thread
+    Director::getInstance()->getScheduler()->cancelFunctionsToPerform(this);
     CC_SAFE_DELETE(_subThreadInstance);
-    delete _UIWsMessageQueue;
     delete _subThreadWsMessageQueue;
 }
 
@@ -164,8 +162,9 @@ void WsThreadHelper::wsThreadEntryFunc()
 
 void WsThreadHelper::sendMessageToUIThread(WsMessage *msg)
 {
-    std::lock_guard<std::mutex> lk(_UIWsMessageQueueMutex);
-    _UIWsMessageQueue->push_back(msg);
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, msg](){
+        handleMessageInUIThread(msg);
+    }, this);
 }
 
 void WsThreadHelper::sendMessageToSubThread(WsMessage *msg)
@@ -182,26 +181,9 @@ void WsThreadHelper::joinSubThread()
     }
 }
 
-void WsThreadHelper::update(float dt)
+void WsThreadHelper::handleMessageInUIThread(WsMessage *msg)
 {
-    WsMessage *msg = nullptr;
-
-    // Returns quickly if no message
-    _UIWsMessageQueueMutex.lock();
-
-    if (0 == _UIWsMessageQueue->size())
-    {
-        _UIWsMessageQueueMutex.unlock();
-        return;
-    }
-    
-    // Gets message
-    msg = *(_UIWsMessageQueue->begin());
-    _UIWsMessageQueue->pop_front();
-
-    _UIWsMessageQueueMutex.unlock();
-    
-    if (_ws)
+    if (_ws && _UIMessagesEnabled)
     {
         _ws->onUIThreadReceiveMessage(msg);
     }
@@ -364,7 +346,10 @@ void WebSocket::send(const unsigned char* binaryMsg, unsigned int len)
 
 void WebSocket::close()
 {
-    Director::getInstance()->getScheduler()->unscheduleAllForTarget(_wsHelper);
+    if (_wsHelper)
+    {
+        _wsHelper->_UIMessagesEnabled = false;
+    }
     
     if (_readyState == State::CLOSING || _readyState == State::CLOSED)
     {
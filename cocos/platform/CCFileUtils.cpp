@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 
+#include <atomic>
 #include <stack>
 
 #include "base/CCData.h"
@@ -97,7 +98,8 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-		return _rootDict;
+        // the maker is thrown away, don't copy the whole tree
+		return std::move(_rootDict);
     }
 
     ValueVector arrayWithContentsOfFile(const std::string& fileName)
@@ -109,7 +111,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-		return _rootArray;
+		return std::move(_rootArray);
     }
 
     void startElement(void *ctx, const char *name, const char **atts)
@@ -143,8 +145,9 @@ public:
                 // add a new dictionary into the pre dictionary
                 CCASSERT(! _dictStack.empty(), "The state is wrong!");
                 ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-				_curDict = &(*preDict)[_curKey].asValueMap();
+                Value& dict = (*preDict)[_curKey];
+                dict = Value(ValueMap());
+				_curDict = &dict.asValueMap();
             }
 
             // record the dict state
@@ -183,8 +186,9 @@ public:
 
             if (preState == SAX_DICT)
             {
-                (*_curDict)[_curKey] = Value(ValueVector());
-				_curArray = &(*_curDict)[_curKey].asValueVector();
+                Value& array = (*_curDict)[_curKey];
+                array = Value(ValueVector());
+				_curArray = &array.asValueVector();
             }
             else if (preState == SAX_ARRAY)
             {
@@ -253,7 +257,7 @@ public:
             if (SAX_ARRAY == curState)
             {
                 if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
+                    _curArray->push_back(Value(std::move(_curValue)));
                 else if (sName == "integer")
                     _curArray->push_back(Value(atoi(_curValue.c_str())));
                 else
@@ -262,7 +266,7 @@ public:
             else if (SAX_DICT == curState)
             {
                 if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
+                    (*_curDict)[_curKey] = Value(std::move(_curValue));
                 else if (sName == "integer")
                     (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
                 else
@@ -284,12 +288,11 @@ public:
         }
 
         SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,0,len);
 
         switch(_state)
         {
         case SAX_KEY:
-            _curKey = text;
+            _curKey.assign(ch, len);
             break;
         case SAX_INT:
         case SAX_REAL:
@@ -300,7 +303,7 @@ public:
                     CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
                 }
                 
-                _curValue.append(text);
+                _curValue.append(ch, len);
             }
             break;
         default:
@@ -571,6 +574,20 @@ Data FileUtils::getDataFromFile(const std::string& filename)
     return getData(filename, false);
 }
 
+Data FileUtils::getMappedDataFromFile(const std::string& filename)
+{
+    if (isFileMappingEnabled() && !filename.empty())
+    {
+        Data ret = Data::mapFile(fullPathForFilename(filename));
+        if (!ret.isNull())
+        {
+            return ret;
+        }
+    }
+    
+    return getDataFromFile(filename);
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
@@ -925,5 +942,18 @@ bool FileUtils::isPopupNotify()
     return s_popupNotify;
 }
 
+// read by the threads loading the resources
+static std::atomic<bool> s_fileMappingEnabled(false);
+
+void FileUtils::setFileMappingEnabled(bool enabled)
+{
+    s_fileMappingEnabled = enabled;
+}
+
+bool FileUtils::isFileMappingEnabled()
+{
+    return s_fileMappingEnabled;
+}
+
 NS_CC_END
 
@@ -89,6 +89,18 @@ public:
      */
     virtual Data getDataFromFile(const std::string& filename);
     
+    /**
+     *  Creates binary data from a file without copying it, by mapping the file into memory.
+     *  The file is paged in lazily as the bytes are read, so the contents must be treated as read only.
+     *  Falls back to getDataFromFile when file mapping is disabled, which is the default,
+     *  or the file can't be mapped, e.g. for resources packed in the Android apk.
+     *  @note The file must not be rewritten in place while the data is alive, replace it with a rename instead.
+     *  @return A data object.
+     *  @see Data::mapFile
+     *  @since v3.2
+     */
+    virtual Data getMappedDataFromFile(const std::string& filename);
+    
     /**
      *  Gets resource file data
      *
@@ -309,6 +321,17 @@ public:
      */
     virtual void setPopupNotify(bool notify);
     virtual bool isPopupNotify();
+    
+    /**
+     *  Sets/Gets whether getMappedDataFromFile maps files into memory, disabled by default.
+     *  When disabled it reads the files with getDataFromFile.
+     *  @warning The mapping reads the files on the disk as they are, bypassing getDataFromFile: don't enable it
+     *           if getDataFromFile is overridden to decrypt or unpack the resources.
+     *  @note It can be called from any thread.
+     *  @since v3.2
+     */
+    virtual void setFileMappingEnabled(bool enabled);
+    virtual bool isFileMappingEnabled();
 
     /**
      *  Converts the contents of a file to a ValueMap.
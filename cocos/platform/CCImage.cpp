@@ -59,6 +59,7 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "renderer/CCPixelConversion.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "android/CCFileUtilsAndroid.h"
 #endif
@@ -390,7 +391,8 @@ Image::Image()
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(true)
 {
-
+    // the images are decoded by the loader threads
+    setReferenceCountThreadSafe(true);
 }
 
 Image::~Image()
@@ -413,17 +415,11 @@ bool Image::initWithImageFile(const std::string& path)
     int size = 4 * (iSurf->w * iSurf->h);
     ret = initWithRawData((const unsigned char*)iSurf->pixels, size, iSurf->w, iSurf->h, 8, true);
 
-    unsigned int *tmp = (unsigned int *)_data;
-    int nrPixels = iSurf->w * iSurf->h;
-    for(int i = 0; i < nrPixels; i++)
-    {
-        unsigned char *p = _data + i * 4;
-        tmp[i] = CC_RGB_PREMULTIPLY_ALPHA( p[0], p[1], p[2], p[3] );
-    }
+    PixelConversion::premultiplyAlpha(_data, size);
 
     SDL_FreeSurface(iSurf);
 #else
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    Data data = FileUtils::getInstance()->getMappedDataFromFile(_filePath);
 
     if (!data.isNull())
     {
@@ -439,7 +435,7 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    Data data = FileUtils::getInstance()->getMappedDataFromFile(fullpath);
 
     if (!data.isNull())
     {
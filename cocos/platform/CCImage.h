@@ -57,6 +57,7 @@ class CC_DLL Image : public Ref
 {
 public:
     friend class TextureCache;
+    friend class TextureTranscoder;
     /**
      * @js ctor
      */
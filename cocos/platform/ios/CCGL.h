@@ -42,6 +42,13 @@ THE SOFTWARE.
 #include <OpenGLES/ES2/gl.h>
 #include <OpenGLES/ES2/glext.h>
 
+#ifdef GL_MAP_WRITE_BIT_EXT
+#define glMapBufferRange            glMapBufferRangeEXT
+#define GL_MAP_WRITE_BIT            GL_MAP_WRITE_BIT_EXT
+#define GL_MAP_INVALIDATE_RANGE_BIT GL_MAP_INVALIDATE_RANGE_BIT_EXT
+#define GL_MAP_UNSYNCHRONIZED_BIT   GL_MAP_UNSYNCHRONIZED_BIT_EXT
+#endif
+
 #endif // CC_PLATFORM_IOS
 
 #endif // __PLATFORM_IOS_CCGL_H__
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCTexture2D.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
@@ -106,6 +107,42 @@ void UniformValue::apply()
     }
 }
 
+uint32_t UniformValue::hash() const
+{
+    if (_useCallback)
+        return 0;
+
+    size_t valueSize;
+    switch (_uniform->type) {
+        case GL_SAMPLER_2D:
+            valueSize = sizeof(_value.tex);
+            break;
+        case GL_INT:
+            valueSize = sizeof(_value.intValue);
+            break;
+        case GL_FLOAT:
+            valueSize = sizeof(_value.floatValue);
+            break;
+        case GL_FLOAT_VEC2:
+            valueSize = sizeof(_value.v2Value);
+            break;
+        case GL_FLOAT_VEC3:
+            valueSize = sizeof(_value.v3Value);
+            break;
+        case GL_FLOAT_VEC4:
+            valueSize = sizeof(_value.v4Value);
+            break;
+        case GL_FLOAT_MAT4:
+            valueSize = sizeof(_value.matrixValue);
+            break;
+        default:
+            return 0;
+    }
+
+    // the location is the seed, so equal values of different uniforms don't collide
+    return XXH32((const void*)&_value, (int)valueSize, (unsigned int)_uniform->location);
+}
+
 void UniformValue::setCallback(const std::function<void(Uniform*)> &callback)
 {
 	// delete previously set callback
@@ -272,6 +309,8 @@ GLProgramState::GLProgramState()
 : _vertexAttribsFlags(0)
 , _glprogram(nullptr)
 , _textureUnitIndex(1)
+, _uniformsHash(0)
+, _uniformsDirty(true)
 {
 }
 
@@ -297,6 +336,8 @@ bool GLProgramState::init(GLProgram* glprogram)
         _uniforms[uniform.first] = value;
     }
 
+    _uniformsDirty = true;
+
     return true;
 }
 
@@ -305,6 +346,7 @@ void GLProgramState::resetGLProgram()
     CC_SAFE_RELEASE(_glprogram);
     _uniforms.clear();
     _attributes.clear();
+    _uniformsDirty = true;
     // first texture is GL_TEXTURE1
     _textureUnitIndex = 1;
 }
@@ -345,6 +387,32 @@ void GLProgramState::setGLProgram(GLProgram *glprogram)
     }
 }
 
+uint32_t GLProgramState::getUniformsHash()
+{
+    // the acquire pairs with the release below: a thread seeing the flag cleared sees the hash stored before it
+    if (_uniformsDirty.load(std::memory_order_acquire))
+    {
+        // the per uniform hashes are added, so the result doesn't depend on the iteration order of _uniforms.
+        // Nodes sharing the state may be visited by several threads: they all compute the same hash,
+        // since the uniforms are only set on the main thread, outside of the visit
+        uint32_t uniformsHash = 0;
+        for (const auto& uniform : _uniforms)
+        {
+            uint32_t hash = uniform.second.hash();
+            if (hash == 0)
+            {
+                uniformsHash = 0;
+                break;
+            }
+            uniformsHash += hash;
+        }
+        _uniformsHash.store(uniformsHash, std::memory_order_relaxed);
+        _uniformsDirty.store(false, std::memory_order_release);
+        return uniformsHash;
+    }
+    return _uniformsHash.load(std::memory_order_relaxed);
+}
+
 UniformValue* GLProgramState::getUniformValue(const std::string &name)
 {
     const auto itr = _uniforms.find(name);
@@ -394,7 +462,10 @@ void GLProgramState::setUniformCallback(const std::string &uniformName, const st
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setCallback(callback);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -403,7 +474,10 @@ void GLProgramState::setUniformFloat(const std::string &uniformName, float value
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setFloat(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -411,8 +485,11 @@ void GLProgramState::setUniformFloat(const std::string &uniformName, float value
 void GLProgramState::setUniformInt(const std::string &uniformName, int value)
 {
     auto v = getUniformValue(uniformName);
-    if(v)
+    if (v)
+    {
         v->setInt(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -421,7 +498,10 @@ void GLProgramState::setUniformVec2(const std::string &uniformName, const Vec2&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec2(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -430,7 +510,10 @@ void GLProgramState::setUniformVec3(const std::string &uniformName, const Vec3&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec3(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -439,7 +522,10 @@ void GLProgramState::setUniformVec4(const std::string &uniformName, const Vec4&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec4(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -448,7 +534,10 @@ void GLProgramState::setUniformMat4(const std::string &uniformName, const Mat4&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setMat4(value);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -465,7 +554,10 @@ void GLProgramState::setUniformTexture(const std::string &uniformName, GLuint te
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setTexture(textureId, _textureUnitIndex++);
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #ifndef __CCGLPROGRAMSTATE_H__
 #define __CCGLPROGRAMSTATE_H__
 
+#include <atomic>
 #include <unordered_map>
 
 #include "base/ccTypes.h"
@@ -65,6 +66,9 @@ public:
 
     void apply();
 
+    /** returns a hash of the location and value of the uniform. Uniforms set with a callback can't be hashed and return 0 */
+    uint32_t hash() const;
+
 protected:
 	Uniform* _uniform;  // weak ref
     GLProgram* _glprogram; // weak ref
@@ -178,6 +182,13 @@ public:
     void setUniformTexture(const std::string &uniformName, Texture2D *texture);
     void setUniformTexture(const std::string &uniformName, GLuint textureId);
 
+    /** returns a hash of the values of the user defined uniforms.
+     Two states of the same GLProgram with the same hash can be drawn in the same batch.
+     It is only recomputed when a uniform changed. Returns 0 if a uniform uses a callback, since it can't be hashed.
+     It can be called by several threads at once, as long as no uniform is set meanwhile.
+     */
+    uint32_t getUniformsHash();
+
 protected:
     GLProgramState();
     ~GLProgramState();
@@ -192,6 +203,11 @@ protected:
     int _textureUnitIndex;
     uint32_t _vertexAttribsFlags;
     GLProgram *_glprogram;
+
+    // atomic: QuadCommand::init() reads them from the threads visiting the nodes concurrently
+    std::atomic<uint32_t> _uniformsHash;
+    // set by the uniform setters, so the hash is only recomputed when needed
+    std::atomic<bool> _uniformsDirty;
 };
 
 NS_CC_END
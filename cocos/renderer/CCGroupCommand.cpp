@@ -48,6 +48,8 @@ bool GroupCommandManager::init()
 
 int GroupCommandManager::getGroupID()
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     //Reuse old id
     for(auto it = _groupMapping.begin(); it != _groupMapping.end(); ++it)
     {
@@ -68,10 +70,12 @@ int GroupCommandManager::getGroupID()
 
 void GroupCommandManager::releaseGroupID(int groupID)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     _groupMapping[groupID] = false;
 }
 
 GroupCommand::GroupCommand()
+: _orderIndependent(false)
 {
     _type = RenderCommand::Type::GROUP_COMMAND;
     _renderQueueID = Director::getInstance()->getRenderer()->getGroupCommandManager()->getGroupID();
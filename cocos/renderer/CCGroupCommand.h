@@ -27,6 +27,7 @@
 #define _CC_GROUPCOMMAND_H_
 
 #include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "CCRenderCommand.h"
@@ -46,6 +47,8 @@ protected:
     ~GroupCommandManager();
     bool init();
     std::unordered_map<int, bool> _groupMapping;
+    // group commands can be created by the threads visiting nodes
+    std::mutex _mutex;
 };
 
 class GroupCommand : public RenderCommand
@@ -57,9 +60,15 @@ public:
     void init(float depth);
 
     inline int getRenderQueueID() const {return _renderQueueID;}
+
+    /** Sets whether the quads of the group with the same global order can be reordered by material to reduce the draw calls.
+     @see `RenderQueue` */
+    inline void setOrderIndependent(bool orderIndependent) { _orderIndependent = orderIndependent; }
+    inline bool isOrderIndependent() const { return _orderIndependent; }
     
 protected:
     int _renderQueueID;
+    bool _orderIndependent;
 };
 
 NS_CC_END
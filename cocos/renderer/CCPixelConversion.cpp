@@ -0,0 +1,477 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCPixelConversion.h"
+
+#include <algorithm>
+
+#include "base/ccMacros.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CC_PIXEL_CONVERSION_SSE2 1
+#include <emmintrin.h>
+#else
+#define CC_PIXEL_CONVERSION_SSE2 0
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(USE_NEON)
+#define CC_PIXEL_CONVERSION_NEON 1
+#include <arm_neon.h>
+#else
+#define CC_PIXEL_CONVERSION_NEON 0
+#endif
+
+NS_CC_BEGIN
+
+namespace {
+
+#if CC_PIXEL_CONVERSION_NEON
+PixelConversion::Implementation s_implementation = PixelConversion::Implementation::NEON;
+#elif CC_PIXEL_CONVERSION_SSE2
+PixelConversion::Implementation s_implementation = PixelConversion::Implementation::SSE2;
+#else
+PixelConversion::Implementation s_implementation = PixelConversion::Implementation::SCALAR;
+#endif
+
+bool s_ditheringEnabled = false;
+
+// thresholds of the ordered dithering
+const unsigned char BAYER_MATRIX[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+// added to 4 pixels which aren't dithered
+const unsigned char NO_DITHER[16] = { 0 };
+
+inline unsigned char addSaturated(unsigned char value, unsigned char offset)
+{
+    unsigned int sum = value + offset;
+    return sum > 0xFF ? 0xFF : static_cast<unsigned char>(sum);
+}
+
+// the formats, each one converting a pixel, 4 pixels in SSE2 registers, or 16 pixels deinterleaved by NEON.
+// The 16 bits results are stored in little endian, like the scalar loops of Texture2D did
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+struct RGBA4444
+{
+    static const int LOST_BITS_R = 4, LOST_BITS_G = 4, LOST_BITS_B = 4;
+
+    static unsigned short pixel(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+    {
+        return (r & 0xF0) << 8 | (g & 0xF0) << 4 | (b & 0xF0) | (a & 0xF0) >> 4;
+    }
+#if CC_PIXEL_CONVERSION_SSE2
+    static __m128i sse2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF00000)), 16);
+        __m128i a = _mm_srli_epi32(p, 28);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    static void neon(uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, uint8x16x2_t& out)
+    {
+        out.val[0] = vorrq_u8(vandq_u8(b, vdupq_n_u8(0xF0)), vshrq_n_u8(a, 4));
+        out.val[1] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF0)), vshrq_n_u8(g, 4));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+struct RGB565
+{
+    static const int LOST_BITS_R = 3, LOST_BITS_G = 2, LOST_BITS_B = 3;
+
+    static unsigned short pixel(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+    {
+        return (r & 0xF8) << 8 | (g & 0xFC) << 3 | (b & 0xF8) >> 3;
+    }
+#if CC_PIXEL_CONVERSION_SSE2
+    static __m128i sse2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 19);
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    static void neon(uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, uint8x16x2_t& out)
+    {
+        out.val[0] = vorrq_u8(vshlq_n_u8(vandq_u8(g, vdupq_n_u8(0x1C)), 3), vshrq_n_u8(b, 3));
+        out.val[1] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+struct RGB5A1
+{
+    static const int LOST_BITS_R = 3, LOST_BITS_G = 3, LOST_BITS_B = 3;
+
+    static unsigned short pixel(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+    {
+        return (r & 0xF8) << 8 | (g & 0xF8) << 3 | (b & 0xF8) >> 2 | (a & 0x80) >> 7;
+    }
+#if CC_PIXEL_CONVERSION_SSE2
+    static __m128i sse2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 18);
+        __m128i a = _mm_srli_epi32(p, 31);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    static void neon(uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, uint8x16x2_t& out)
+    {
+        uint8x16_t gb = vorrq_u8(vshlq_n_u8(vandq_u8(g, vdupq_n_u8(0x18)), 3), vshrq_n_u8(vandq_u8(b, vdupq_n_u8(0xF8)), 2));
+        out.val[0] = vorrq_u8(gb, vshrq_n_u8(a, 7));
+        out.val[1] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA, I = (R*299 + G*587 + B*114 + 500) / 1000
+// The vectors divide in float: (x + 500.5) * 0.001 is exact enough to truncate to the same integer for x <= 255000
+struct AI88
+{
+    static const int LOST_BITS_R = 0, LOST_BITS_G = 0, LOST_BITS_B = 0;
+
+    static unsigned short pixel(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+    {
+        return static_cast<unsigned short>((r * 299 + g * 587 + b * 114 + 500) / 1000 | a << 8);
+    }
+#if CC_PIXEL_CONVERSION_SSE2
+    static __m128i sse2(__m128i p)
+    {
+        const __m128i mask = _mm_set1_epi32(0x00FF00FF);
+        __m128i rb = _mm_and_si128(p, mask);
+        __m128i ga = _mm_and_si128(_mm_srli_epi32(p, 8), mask);
+        __m128i sum = _mm_add_epi32(_mm_madd_epi16(rb, _mm_set1_epi32(299 | 114 << 16)), _mm_madd_epi16(ga, _mm_set1_epi32(587)));
+        __m128i i = _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(500.5f)), _mm_set1_ps(0.001f)));
+        return _mm_or_si128(i, _mm_slli_epi32(_mm_srli_epi32(p, 24), 8));
+    }
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    static uint16x4_t luminance(uint16x4_t r, uint16x4_t g, uint16x4_t b)
+    {
+        uint32x4_t sum = vmlal_n_u16(vmlal_n_u16(vmull_n_u16(r, 299), g, 587), b, 114);
+        return vmovn_u32(vcvtq_u32_f32(vmulq_n_f32(vaddq_f32(vcvtq_f32_u32(sum), vdupq_n_f32(500.5f)), 0.001f)));
+    }
+    static uint8x8_t luminance(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+    {
+        uint16x8_t r16 = vmovl_u8(r), g16 = vmovl_u8(g), b16 = vmovl_u8(b);
+        uint16x4_t low = luminance(vget_low_u16(r16), vget_low_u16(g16), vget_low_u16(b16));
+        uint16x4_t high = luminance(vget_high_u16(r16), vget_high_u16(g16), vget_high_u16(b16));
+        return vmovn_u16(vcombine_u16(low, high));
+    }
+    static void neon(uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, uint8x16x2_t& out)
+    {
+        out.val[0] = vcombine_u8(luminance(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+                                 luminance(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+        out.val[1] = a;
+    }
+#endif
+};
+
+// converts "pixels" pixels, adding the offsets of dither to the 4 pixels following each other
+template <typename Format>
+void convertScalar(const unsigned char* data, ssize_t pixels, unsigned char* outData, const unsigned char* dither)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixels; ++i, data += 4)
+    {
+        const unsigned char* offsets = dither + (i & 3) * 4;
+        *out16++ = Format::pixel(addSaturated(data[0], offsets[0]), addSaturated(data[1], offsets[1]),
+                                 addSaturated(data[2], offsets[2]), data[3]);
+    }
+}
+
+#if CC_PIXEL_CONVERSION_SSE2
+// keeps the low 16 bits of the 32 bits lanes of low and high
+inline __m128i pack16(__m128i low, __m128i high)
+{
+    // sign extends them, so the signed saturation doesn't change them
+    low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+    high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+    return _mm_packs_epi32(low, high);
+}
+
+template <typename Format>
+void convertSSE2(const unsigned char* data, ssize_t pixels, unsigned char* outData, const unsigned char* dither)
+{
+    const __m128i offsets = _mm_loadu_si128((const __m128i*)dither);
+    ssize_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i low = _mm_adds_epu8(_mm_loadu_si128((const __m128i*)(data + i * 4)), offsets);
+        __m128i high = _mm_adds_epu8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)), offsets);
+        _mm_storeu_si128((__m128i*)(outData + i * 2), pack16(Format::sse2(low), Format::sse2(high)));
+    }
+    convertScalar<Format>(data + i * 4, pixels - i, outData + i * 2, dither);
+}
+#endif
+
+#if CC_PIXEL_CONVERSION_NEON
+template <typename Format>
+void convertNEON(const unsigned char* data, ssize_t pixels, unsigned char* outData, const unsigned char* dither)
+{
+    // the offsets of 16 pixels, by channel
+    unsigned char channels[3][16];
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int x = 0; x < 16; ++x)
+        {
+            channels[c][x] = dither[(x & 3) * 4 + c];
+        }
+    }
+    const uint8x16_t offsetsR = vld1q_u8(channels[0]);
+    const uint8x16_t offsetsG = vld1q_u8(channels[1]);
+    const uint8x16_t offsetsB = vld1q_u8(channels[2]);
+
+    ssize_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        Format::neon(vqaddq_u8(p.val[0], offsetsR), vqaddq_u8(p.val[1], offsetsG), vqaddq_u8(p.val[2], offsetsB), p.val[3], out);
+        vst2q_u8(outData + i * 2, out);
+    }
+    convertScalar<Format>(data + i * 4, pixels - i, outData + i * 2, dither);
+}
+#endif
+
+template <typename Format>
+void convertPixels(const unsigned char* data, ssize_t pixels, unsigned char* outData, const unsigned char* dither)
+{
+    switch (s_implementation)
+    {
+#if CC_PIXEL_CONVERSION_SSE2
+    case PixelConversion::Implementation::SSE2:
+        convertSSE2<Format>(data, pixels, outData, dither);
+        break;
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    case PixelConversion::Implementation::NEON:
+        convertNEON<Format>(data, pixels, outData, dither);
+        break;
+#endif
+    default:
+        convertScalar<Format>(data, pixels, outData, dither);
+        break;
+    }
+}
+
+template <typename Format>
+void convert(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide)
+{
+    ssize_t pixels = dataLen / 4;
+    if (!s_ditheringEnabled || pixelsWide <= 0 || Format::LOST_BITS_G == 0)
+    {
+        convertPixels<Format>(data, pixels, outData, NO_DITHER);
+        return;
+    }
+
+    // the rows start with the first column of the matrix, the offsets of a row repeat every 4 pixels
+    unsigned char dither[16];
+    for (ssize_t row = 0; row * pixelsWide < pixels; ++row)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            unsigned char threshold = BAYER_MATRIX[row & 3][x];
+            dither[x * 4] = (threshold << Format::LOST_BITS_R) >> 4;
+            dither[x * 4 + 1] = (threshold << Format::LOST_BITS_G) >> 4;
+            dither[x * 4 + 2] = (threshold << Format::LOST_BITS_B) >> 4;
+            dither[x * 4 + 3] = 0;
+        }
+        ssize_t first = row * pixelsWide;
+        convertPixels<Format>(data + first * 4, std::min<ssize_t>(pixelsWide, pixels - first), outData + first * 2, dither);
+    }
+}
+
+void premultiplyScalar(unsigned char* data, ssize_t pixels)
+{
+    for (ssize_t i = 0; i < pixels; ++i, data += 4)
+    {
+        unsigned int alpha = data[3] + 1;
+        data[0] = (data[0] * alpha) >> 8;
+        data[1] = (data[1] * alpha) >> 8;
+        data[2] = (data[2] * alpha) >> 8;
+    }
+}
+
+#if CC_PIXEL_CONVERSION_SSE2
+// 2 pixels, one channel in each 16 bits lane
+inline __m128i premultiply(__m128i p)
+{
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i colors = _mm_srli_epi16(_mm_mullo_epi16(p, _mm_add_epi16(alpha, _mm_set1_epi16(1))), 8);
+    return _mm_or_si128(_mm_andnot_si128(alphaLanes, colors), _mm_and_si128(alphaLanes, p));
+}
+
+void premultiplySSE2(unsigned char* data, ssize_t pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    ssize_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i low = premultiply(_mm_unpacklo_epi8(p, zero));
+        __m128i high = premultiply(_mm_unpackhi_epi8(p, zero));
+        _mm_storeu_si128((__m128i*)(data + i * 4), _mm_packus_epi16(low, high));
+    }
+    premultiplyScalar(data + i * 4, pixels - i);
+}
+#endif
+
+#if CC_PIXEL_CONVERSION_NEON
+inline uint8x8_t premultiply(uint8x8_t c, uint8x8_t a)
+{
+    // c * (a + 1) >> 8
+    return vshrn_n_u16(vaddw_u8(vmull_u8(c, a), c), 8);
+}
+
+inline uint8x16_t premultiply(uint8x16_t c, uint8x16_t a)
+{
+    return vcombine_u8(premultiply(vget_low_u8(c), vget_low_u8(a)), premultiply(vget_high_u8(c), vget_high_u8(a)));
+}
+
+void premultiplyNEON(unsigned char* data, ssize_t pixels)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        p.val[0] = premultiply(p.val[0], p.val[3]);
+        p.val[1] = premultiply(p.val[1], p.val[3]);
+        p.val[2] = premultiply(p.val[2], p.val[3]);
+        vst4q_u8(data + i * 4, p);
+    }
+    premultiplyScalar(data + i * 4, pixels - i);
+}
+#endif
+
+} // namespace
+
+bool PixelConversion::isImplementationSupported(Implementation implementation)
+{
+    switch (implementation)
+    {
+    case Implementation::SSE2:
+        return CC_PIXEL_CONVERSION_SSE2 != 0;
+    case Implementation::NEON:
+        return CC_PIXEL_CONVERSION_NEON != 0;
+    default:
+        return true;
+    }
+}
+
+PixelConversion::Implementation PixelConversion::getImplementation()
+{
+    return s_implementation;
+}
+
+void PixelConversion::setImplementation(Implementation implementation)
+{
+    CCASSERT(isImplementationSupported(implementation), "The pixel conversions can't use this implementation in this build");
+    if (isImplementationSupported(implementation))
+    {
+        s_implementation = implementation;
+    }
+}
+
+const char* PixelConversion::getImplementationName(Implementation implementation)
+{
+    switch (implementation)
+    {
+    case Implementation::SSE2:
+        return "SSE2";
+    case Implementation::NEON:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+void PixelConversion::setDitheringEnabled(bool enabled)
+{
+    s_ditheringEnabled = enabled;
+}
+
+bool PixelConversion::isDitheringEnabled()
+{
+    return s_ditheringEnabled;
+}
+
+void PixelConversion::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide)
+{
+    convert<RGBA4444>(data, dataLen, outData, pixelsWide);
+}
+
+void PixelConversion::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide)
+{
+    convert<RGB565>(data, dataLen, outData, pixelsWide);
+}
+
+void PixelConversion::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide)
+{
+    convert<RGB5A1>(data, dataLen, outData, pixelsWide);
+}
+
+void PixelConversion::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convert<AI88>(data, dataLen, outData, 0);
+}
+
+void PixelConversion::premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    ssize_t pixels = dataLen / 4;
+    switch (s_implementation)
+    {
+#if CC_PIXEL_CONVERSION_SSE2
+    case Implementation::SSE2:
+        premultiplySSE2(data, pixels);
+        break;
+#endif
+#if CC_PIXEL_CONVERSION_NEON
+    case Implementation::NEON:
+        premultiplyNEON(data, pixels);
+        break;
+#endif
+    default:
+        premultiplyScalar(data, pixels);
+        break;
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,88 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PIXEL_CONVERSION_H__
+#define __CC_PIXEL_CONVERSION_H__
+
+#include "base/CCPlatformMacros.h"
+#include <stdint.h> // for ssize_t on android
+#include <string>   // for ssize_t on linux
+#include "CCStdC.h" // for ssize_t on window
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Converts RGBA8888 pixels to the formats uploaded by Texture2D, with SSE2 or NEON when the build supports it.
+
+ The default implementation is fixed at compile time: NEON on ARM builds with NEON, SSE2 on x86 builds with SSE2,
+ the scalar loops otherwise. setImplementation() overrides it at runtime. All of them produce the same pixels.
+ @since v3.2
+ */
+class CC_DLL PixelConversion
+{
+public:
+    enum class Implementation
+    {
+        SCALAR,
+        SSE2,
+        NEON,
+    };
+
+    /** whether this build can run an implementation */
+    static bool isImplementationSupported(Implementation implementation);
+    /** the implementation used by the conversions */
+    static Implementation getImplementation();
+    /** forces an implementation, to compare them. It must be supported */
+    static void setImplementation(Implementation implementation);
+    static const char* getImplementationName(Implementation implementation);
+
+    /** Ordered dithering (4x4 Bayer matrix) of the color channels when converting to RGBA4444, RGB565 and RGB5A1,
+     which hides the banding of the gradients. Only used when the width of the image is given. Disabled by default.
+     */
+    static void setDitheringEnabled(bool enabled);
+    static bool isDitheringEnabled();
+
+    /** The conversions of dataLen bytes of RGBA8888 pixels, rows of pixelsWide pixels. pixelsWide is only used by dithering, 0 disables it */
+    static void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide = 0);
+    static void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide = 0);
+    static void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData, int pixelsWide = 0);
+    static void convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+    /** Multiplies the color channels of dataLen bytes of RGBA8888 pixels by their alpha, like CC_RGB_PREMULTIPLY_ALPHA */
+    static void premultiplyAlpha(unsigned char* data, ssize_t dataLen);
+
+private:
+    PixelConversion();
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CC_PIXEL_CONVERSION_H__
@@ -38,6 +38,7 @@ QuadCommand::QuadCommand()
 ,_textureID(0)
 ,_glProgramState(nullptr)
 ,_blendType(BlendFunc::DISABLE)
+,_uniformsHash(0)
 ,_quads(nullptr)
 ,_quadsCount(0)
 {
@@ -56,11 +57,15 @@ void QuadCommand::init(float globalOrder, GLuint textureID, GLProgramState* glPr
 
     _mv = mv;
 
-    if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState) {
+    // getUniformsHash() is cached by the GLProgramState, it is only recomputed when a uniform changes
+    uint32_t uniformsHash = glProgramState->getUniformCount() > 0 ? glProgramState->getUniformsHash() : 0;
+
+    if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState || _uniformsHash != uniformsHash) {
 
         _textureID = textureID;
         _blendType = blendType;
         _glProgramState = glProgramState;
+        _uniformsHash = uniformsHash;
 
         generateMaterialID();
     }
@@ -73,14 +78,15 @@ QuadCommand::~QuadCommand()
 void QuadCommand::generateMaterialID()
 {
 
-    if(_glProgramState->getUniformCount() > 0)
+    // uniforms that can't be hashed (eg: callbacks) can't be batched
+    if(_glProgramState->getUniformCount() > 0 && _uniformsHash == 0)
     {
         _materialID = QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
     }
     else
     {
         int glProgram = (int)_glProgramState->getGLProgram()->getProgram();
-        int intArray[4] = { glProgram, (int)_textureID, (int)_blendType.src, (int)_blendType.dst};
+        int intArray[5] = { glProgram, (int)_textureID, (int)_blendType.src, (int)_blendType.dst, (int)_uniformsHash};
 
         _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
     }
@@ -64,6 +64,8 @@ protected:
     GLuint _textureID;
     GLProgramState* _glProgramState;
     BlendFunc _blendType;
+    // hash of the uniforms used to generate the material ID
+    uint32_t _uniformsHash;
     V3F_C4B_T2F_Quad* _quads;
     ssize_t _quadsCount;
     Mat4 _mv;
@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCRenderArena.h"
+
+#include <stdlib.h>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// the header of a block takes a multiple of the alignment, so the data after it is aligned too
+static const size_t BLOCK_HEADER_SIZE = (sizeof(void*) + sizeof(size_t) + RenderArena::ALIGNMENT - 1) & ~(RenderArena::ALIGNMENT - 1);
+
+RenderArena::RenderArena(size_t blockSize)
+: _blocks(nullptr)
+, _offset(0)
+, _blockSize(blockSize)
+, _usedBytes(0)
+, _capacity(0)
+, _heapAllocations(0)
+, _destructors(nullptr)
+{
+    CCASSERT(blockSize > 0, "Invalid block size");
+}
+
+RenderArena::~RenderArena()
+{
+    // no reset(): it would merge the blocks into a new one only to free it
+    runDestructors();
+    freeBlocks();
+}
+
+void* RenderArena::allocate(size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    if (_blocks == nullptr || _offset + size > _blocks->size)
+    {
+        allocateBlock(size > _blockSize ? size : _blockSize);
+    }
+
+    void* ptr = reinterpret_cast<char*>(_blocks) + BLOCK_HEADER_SIZE + _offset;
+    _offset += size;
+    _usedBytes += size;
+    return ptr;
+}
+
+void RenderArena::reset()
+{
+    runDestructors();
+
+    if (_blocks && _blocks->next)
+    {
+        // the frame didn't fit in one block: use one with room for all of them from now on
+        size_t total = 0;
+        for (Block* block = _blocks; block; block = block->next)
+        {
+            total += block->size;
+        }
+        freeBlocks();
+        _blockSize = total;
+        allocateBlock(_blockSize);
+    }
+
+    _offset = 0;
+    _usedBytes = 0;
+}
+
+void RenderArena::runDestructors()
+{
+    // destroyed in the reverse order of creation
+    while (_destructors)
+    {
+        Destructor* next = _destructors->next;
+        _destructors->destroy(_destructors->object);
+        _destructors = next;
+    }
+}
+
+void RenderArena::allocateBlock(size_t size)
+{
+    Block* block = static_cast<Block*>(malloc(BLOCK_HEADER_SIZE + size));
+    CCASSERT(block, "RenderArena: out of memory");
+
+    block->next = _blocks;
+    block->size = size;
+    _blocks = block;
+    _offset = 0;
+    _capacity += size;
+    ++_heapAllocations;
+}
+
+void RenderArena::freeBlocks()
+{
+    while (_blocks)
+    {
+        Block* next = _blocks->next;
+        free(_blocks);
+        _blocks = next;
+    }
+    _capacity = 0;
+}
+
+NS_CC_END
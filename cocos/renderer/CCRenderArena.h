@@ -0,0 +1,225 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_RENDER_ARENA_H__
+#define __CC_RENDER_ARENA_H__
+
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <utility>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** A linear allocator for objects that only live during one frame.
+
+ Allocating is a pointer bump in the current block. Nothing is freed until `reset()`, which destroys the objects
+ created with `create()` and makes the whole memory available again. When a frame needed more than one block,
+ `reset()` replaces them with a single block big enough for all of them, so once the size of a frame is known
+ the arena doesn't allocate memory from the heap anymore.
+
+ The Renderer owns one, which is reset in `Renderer::clean()` after the frame was drawn (see `Renderer::getFrameArena()`).
+ */
+class CC_DLL RenderArena
+{
+public:
+    /** every allocation is aligned to this number of bytes */
+    static const size_t ALIGNMENT = 16;
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit RenderArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~RenderArena();
+
+    /** Returns `size` bytes of memory, valid until the next `reset()` */
+    void* allocate(size_t size);
+
+    /** Allocates an array of `count` T, uninitialized. Valid until the next `reset()` */
+    template <class T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count));
+    }
+
+    /** Creates a T in the arena. It is destroyed by the next `reset()` */
+    template <class T, class... Args>
+    T* create(Args&&... args)
+    {
+        auto destructor = static_cast<Destructor*>(allocate(sizeof(Destructor)));
+        T* object = new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+
+        destructor->object = object;
+        destructor->destroy = &destroyObject<T>;
+        destructor->next = _destructors;
+        _destructors = destructor;
+
+        return object;
+    }
+
+    /** Destroys the objects created in the arena and releases all the memory allocated since the last reset */
+    void reset();
+
+    /** returns the number of bytes allocated since the last reset */
+    size_t getUsedBytes() const { return _usedBytes; }
+    /** returns the total size of the blocks owned by the arena */
+    size_t getCapacity() const { return _capacity; }
+    /** returns the number of blocks allocated in the heap since the arena was created */
+    unsigned int getHeapAllocations() const { return _heapAllocations; }
+
+protected:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void* object;
+        void (*destroy)(void*);
+        Destructor* next;
+    };
+
+    template <class T>
+    static void destroyObject(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+
+    void allocateBlock(size_t size);
+    void freeBlocks();
+    void runDestructors();
+
+    // the block being used is the first one
+    Block* _blocks;
+    size_t _offset;
+    size_t _blockSize;
+    size_t _usedBytes;
+    size_t _capacity;
+    unsigned int _heapAllocations;
+    Destructor* _destructors;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(RenderArena);
+};
+
+/** An array whose storage is allocated from a `RenderArena`, for the data of one frame.
+
+ T must be trivially copyable: the elements are moved with memcpy and never destroyed.
+ When it grows, the new storage comes from the arena passed to `push_back()` or `insert()`, and the old one is
+ left in its arena until the next reset. So `clear()` must be called before the arenas that were used are reset.
+ `clear()` remembers the size of the frame, and the storage of the next frame starts with room for it.
+ */
+template <class T>
+class RenderArenaArray
+{
+public:
+    static const size_t MIN_CAPACITY = 16;
+
+    RenderArenaArray()
+    : _data(nullptr)
+    , _size(0)
+    , _capacity(0)
+    , _lastSize(0)
+    {
+    }
+
+    void push_back(const T& value, RenderArena* arena)
+    {
+        if (_size == _capacity)
+        {
+            grow(_size + 1, arena);
+        }
+        _data[_size++] = value;
+    }
+
+    /** Inserts the elements in [first, last) before the element at `index` */
+    void insert(size_t index, const T* first, const T* last, RenderArena* arena)
+    {
+        size_t count = last - first;
+        if (count == 0)
+            return;
+
+        if (_size + count > _capacity)
+        {
+            grow(_size + count, arena);
+        }
+        memmove(_data + index + count, _data + index, sizeof(T) * (_size - index));
+        memcpy(_data + index, first, sizeof(T) * count);
+        _size += count;
+    }
+
+    /** Forgets the elements and the storage. The next frame allocates room for as many elements as this one had */
+    void clear()
+    {
+        // clearing an array that is already clear keeps the size of the last frame
+        if (_data)
+            _lastSize = _size;
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+    inline size_t size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+
+    inline T* begin() { return _data; }
+    inline T* end() { return _data + _size; }
+    inline const T* begin() const { return _data; }
+    inline const T* end() const { return _data + _size; }
+
+    inline T& operator[](size_t index) { return _data[index]; }
+    inline const T& operator[](size_t index) const { return _data[index]; }
+
+protected:
+    void grow(size_t minCapacity, RenderArena* arena)
+    {
+        size_t capacity = _capacity * 2;
+        if (capacity < _lastSize)
+            capacity = _lastSize;
+        if (capacity < MIN_CAPACITY)
+            capacity = MIN_CAPACITY;
+        if (capacity < minCapacity)
+            capacity = minCapacity;
+
+        T* data = arena->allocateArray<T>(capacity);
+        if (_size > 0)
+        {
+            memcpy(data, _data, sizeof(T) * _size);
+        }
+        _data = data;
+        _capacity = capacity;
+    }
+
+    T* _data;
+    size_t _size;
+    size_t _capacity;
+    size_t _lastSize;
+};
+
+NS_CC_END
+
+#endif // __CC_RENDER_ARENA_H__
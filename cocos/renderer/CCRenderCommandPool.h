@@ -26,75 +26,108 @@
 #ifndef __CC_RENDERCOMMANDPOOL_H__
 #define __CC_RENDERCOMMANDPOOL_H__
 
-#include <set>
-#include <list>
+#include <new>
+#include <stdlib.h>
 
 #include "base/CCPlatformMacros.h"
 
 NS_CC_BEGIN
 
+/** Pool of commands of type T.
+
+ The commands are allocated in blocks of COMMANDS_ALLOCATE_BLOCK_SIZE. The free list is intrusive: a free slot
+ stores the pointer to the next free slot, so generating and pushing back a command is O(1) and never allocates
+ memory once the pool has enough blocks. A command is constructed by `generateCommand()` and destroyed by
+ `pushBackCommand()`.
+ */
 template <class T>
 class RenderCommandPool
 {
 public:
+    static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
+
     RenderCommandPool()
+    : _blocks(nullptr)
+    , _freeSlots(nullptr)
+    , _heapAllocations(0)
+    , _usedCommands(0)
     {
     }
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
+//        if( 0 != _usedCommands)
 //        {
 //            CCLOG("All RenderCommand should not be used when Pool is released!");
 //        }
-        _freePool.clear();
-        for (typename std::list<T*>::iterator iter = _allocatedPoolBlocks.begin(); iter != _allocatedPoolBlocks.end(); ++iter)
+        while (_blocks)
         {
-            delete[] *iter;
-            *iter = nullptr;
+            Block* next = _blocks->next;
+            free(_blocks);
+            _blocks = next;
         }
-        _allocatedPoolBlocks.clear();
+        _freeSlots = nullptr;
     }
 
     T* generateCommand()
     {
-        T* result = nullptr;
-        if(_freePool.empty())
+        if(_freeSlots == nullptr)
         {
             AllocateCommands();
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
-        return result;
+        Slot* slot = _freeSlots;
+        _freeSlots = slot->next;
+        ++_usedCommands;
+        return new (slot->storage) T();
     }
     
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
-        _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
+        ptr->~T();
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        slot->next = _freeSlots;
+        _freeSlots = slot;
+        --_usedCommands;
     }
+
+    /** number of blocks allocated in the heap since the pool was created */
+    unsigned int getHeapAllocations() const { return _heapAllocations; }
+    /** number of commands generated and not pushed back yet */
+    int getUsedCommands() const { return _usedCommands; }
+
 private:
+    union Slot
+    {
+        Slot* next;
+        // aligned storage for a T
+        double align[(sizeof(T) + sizeof(double) - 1) / sizeof(double)];
+        unsigned char storage[sizeof(T)];
+    };
+
+    struct Block
+    {
+        Block* next;
+        Slot slots[COMMANDS_ALLOCATE_BLOCK_SIZE];
+    };
+
     void AllocateCommands()
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands = new T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        Block* block = static_cast<Block*>(malloc(sizeof(Block)));
+        block->next = _blocks;
+        _blocks = block;
+        ++_heapAllocations;
+
+        // link the slots in order, so the commands of a block are handed out consecutively
+        for(int index = COMMANDS_ALLOCATE_BLOCK_SIZE - 1; index >= 0; --index)
         {
-            _freePool.push_back(commands+index);
+            block->slots[index].next = _freeSlots;
+            _freeSlots = &block->slots[index];
         }
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    Block* _blocks;
+    Slot* _freeSlots;
+    unsigned int _heapAllocations;
+    int _usedCommands;
 };
 
 NS_CC_END
@@ -38,26 +38,123 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCThreadPool.h"
+#include "2d/CCNode.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+static float getCommandGlobalOrder(RenderCommand* command)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    return command->getGlobalOrder();
+}
+
+static uint32_t getQuadCommandMaterialID(RenderCommand* command)
+{
+    return static_cast<QuadCommand*>(command)->getMaterialID();
+}
+
+// number of batches needed to draw [first, last) quad commands, in order
+static ssize_t countQuadBatches(RenderCommand* const* first, RenderCommand* const* last)
+{
+    ssize_t batches = 0;
+    uint32_t lastMaterialID = QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
+    for (auto it = first; it != last; ++it)
+    {
+        auto materialID = static_cast<QuadCommand*>(*it)->getMaterialID();
+        if (materialID != lastMaterialID || materialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
+            batches++;
+        lastMaterialID = materialID;
+    }
+    return batches;
+}
+
+// push_back that counts the times the vector had to grow
+template <class T>
+static inline void pushBackCountingAllocations(std::vector<T>& vector, const T& value, unsigned int& allocations)
+{
+    if (vector.size() == vector.capacity())
+        allocations++;
+    vector.push_back(value);
+}
+
+// Stable sort by a key of the commands that takes its temporary memory from the arena, while std::stable_sort
+// allocates it from the heap every time it is called.
+template <typename Key>
+static void stableSortCommands(RenderCommand** first, RenderCommand** last,
+                               Key (*getKey)(RenderCommand*), RenderArena* scratch)
+{
+    if (scratch == nullptr)
+    {
+        std::stable_sort(first, last, [getKey](RenderCommand* a, RenderCommand* b) {
+            return getKey(a) < getKey(b);
+        });
+        return;
+    }
+
+    struct SortKey
+    {
+        Key key;
+        uint32_t index;
+        RenderCommand* command;
+    };
+
+    size_t count = last - first;
+    auto keys = scratch->allocateArray<SortKey>(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i].key = getKey(first[i]);
+        keys[i].index = static_cast<uint32_t>(i);
+        keys[i].command = first[i];
+    }
+
+    // the index breaks the ties, so std::sort is stable here
+    std::sort(keys, keys + count, [](const SortKey& a, const SortKey& b) {
+        return a.key < b.key || (a.key == b.key && a.index < b.index);
+    });
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        first[i] = keys[i].command;
+    }
 }
 
 // queue
 
-void RenderQueue::push_back(RenderCommand* command)
+RenderQueue::RenderQueue()
+: _orderIndependent(false)
+, _savedBatches(0)
+{
+}
+
+void RenderQueue::push_back(RenderCommand* command, RenderArena* arena)
 {
     float z = command->getGlobalOrder();
     if(z < 0)
-        _queueNegZ.push_back(command);
+        _queueNegZ.push_back(command, arena);
     else if(z > 0)
-        _queuePosZ.push_back(command);
+        _queuePosZ.push_back(command, arena);
     else
-        _queue0.push_back(command);
+        _queue0.push_back(command, arena);
+}
+
+RenderQueue::InsertionPoint RenderQueue::getInsertionPoint() const
+{
+    InsertionPoint point;
+    point.negZ = _queueNegZ.size();
+    point.zero = _queue0.size();
+    point.posZ = _queuePosZ.size();
+    return point;
+}
+
+void RenderQueue::insert(const InsertionPoint& point, const RenderQueue& queue, RenderArena* arena)
+{
+    CCASSERT(point.negZ <= _queueNegZ.size() && point.zero <= _queue0.size() && point.posZ <= _queuePosZ.size(), "Invalid insertion point");
+
+    // sort() is stable (see stableSortCommands()), so the commands keep their order relative to the commands pushed before and after them
+    _queueNegZ.insert(point.negZ, queue._queueNegZ.begin(), queue._queueNegZ.end(), arena);
+    _queue0.insert(point.zero, queue._queue0.begin(), queue._queue0.end(), arena);
+    _queuePosZ.insert(point.posZ, queue._queuePosZ.begin(), queue._queuePosZ.end(), arena);
 }
 
 ssize_t RenderQueue::size() const
@@ -65,11 +162,52 @@ ssize_t RenderQueue::size() const
     return _queueNegZ.size() + _queue0.size() + _queuePosZ.size();
 }
 
-void RenderQueue::sort()
+void RenderQueue::sort(RenderArena* scratch)
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
-    std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
+    stableSortCommands(_queueNegZ.begin(), _queueNegZ.end(), getCommandGlobalOrder, scratch);
+    stableSortCommands(_queuePosZ.begin(), _queuePosZ.end(), getCommandGlobalOrder, scratch);
+
+    _savedBatches = 0;
+    if (_orderIndependent)
+    {
+        sortByMaterial(_queueNegZ, scratch);
+        sortByMaterial(_queue0, scratch);
+        sortByMaterial(_queuePosZ, scratch);
+    }
+}
+
+void RenderQueue::sortByMaterial(RenderArenaArray<RenderCommand*>& commands, RenderArena* scratch)
+{
+    // Only runs of consecutive quads with the same global order are reordered.
+    // Any other command is a barrier, since it is drawn with its own GL state.
+    auto runBegin = commands.begin();
+    while (runBegin != commands.end())
+    {
+        if ((*runBegin)->getType() != RenderCommand::Type::QUAD_COMMAND)
+        {
+            ++runBegin;
+            continue;
+        }
+
+        auto runEnd = runBegin + 1;
+        while (runEnd != commands.end()
+               && (*runEnd)->getType() == RenderCommand::Type::QUAD_COMMAND
+               && (*runEnd)->getGlobalOrder() == (*runBegin)->getGlobalOrder())
+        {
+            ++runEnd;
+        }
+
+        if (runEnd - runBegin > 1)
+        {
+            ssize_t batchesBefore = countQuadBatches(runBegin, runEnd);
+            // stable, so quads that share a material keep their relative order
+            stableSortCommands(runBegin, runEnd, getQuadCommandMaterialID, scratch);
+            _savedBatches += batchesBefore - countQuadBatches(runBegin, runEnd);
+        }
+
+        runBegin = runEnd;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -108,9 +246,23 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 //
 Renderer::Renderer()
 :_lastMaterialID(0)
+,_quadTransformPool(nullptr)
+,_heapAllocations(0)
+,_quadVAO(0)
+,_indicesVBO(0)
+,_quadBatchSize(VBO_SIZE)
 ,_numQuads(0)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_savedBatches(0)
+,_culledNodes(0)
+,_visitCulledNodes(0)
+,_cullingEnabled(false)
 ,_isRendering(false)
+,_owner(nullptr)
+,_visitPool(nullptr)
+,_pendingConcurrentVisits(0)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -121,15 +273,65 @@ Renderer::Renderer()
     
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
+    _currentRenderQueue = &_renderGroups[DEFAULT_RENDER_QUEUE];
     _batchedQuadCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    _batchedQuadOffsets.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+
+    _quads.resize(_quadBatchSize);
+    _indices.resize(_quadBatchSize * 6);
+}
+
+Renderer::Renderer(Renderer* owner)
+:_lastMaterialID(0)
+,_quadTransformPool(nullptr)
+,_heapAllocations(0)
+,_quadVAO(0)
+,_indicesVBO(0)
+,_quadBatchSize(VBO_SIZE)
+,_numQuads(0)
+,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_savedBatches(0)
+,_culledNodes(0)
+,_visitCulledNodes(0)
+,_cullingEnabled(false)
+,_isRendering(false)
+,_groupCommandManager(owner->_groupCommandManager)
+,_owner(owner)
+,_visitPool(nullptr)
+,_pendingConcurrentVisits(0)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+,_cacheTextureListener(nullptr)
+#endif
+{
+    // it only records commands: no GL objects nor quad buffers
+    _groupCommandManager->retain();
+
+    _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
+
+    RenderQueue defaultRenderQueue;
+    _renderGroups.push_back(defaultRenderQueue);
+    _currentRenderQueue = &_renderGroups[DEFAULT_RENDER_QUEUE];
 }
 
 Renderer::~Renderer()
 {
+    finishConcurrentVisits();
+    for (auto recorder : _visitRecorders)
+    {
+        delete recorder;
+    }
+    CC_SAFE_DELETE(_visitPool);
+
     _renderGroups.clear();
     _groupCommandManager->release();
+    CC_SAFE_DELETE(_quadTransformPool);
+
+    if (_owner)
+        return;
     
-    glDeleteBuffers(2, _buffersVBO);
+    glDeleteBuffers(1, &_indicesVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -161,7 +363,7 @@ void Renderer::initGLView()
 
 void Renderer::setupIndices()
 {
-    for( int i=0; i < VBO_SIZE; i++)
+    for( int i=0; i < _quadBatchSize; i++)
     {
         _indices[i*6+0] = (GLushort) (i*4+0);
         _indices[i*6+1] = (GLushort) (i*4+1);
@@ -189,25 +391,17 @@ void Renderer::setupVBOAndVAO()
     glGenVertexArrays(1, &_quadVAO);
     GL::bindVAO(_quadVAO);
 
-    glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(1, &_indicesVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
+    _quadVertexStream.init(sizeof(_quads[0]) * _quadBatchSize * VERTEX_STREAM_BATCHES);
 
-    // vertices
+    // the pointers are set before each draw, since the quads are streamed at a different offset every time
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _quadBatchSize * 6, _indices.data(), GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
@@ -219,7 +413,10 @@ void Renderer::setupVBOAndVAO()
 
 void Renderer::setupVBO()
 {
-    glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(1, &_indicesVBO);
+
+    _quadVertexStream.init(sizeof(_quads[0]) * _quadBatchSize * VERTEX_STREAM_BATCHES);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     mapBuffers();
 }
@@ -229,50 +426,198 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _quadBatchSize * 6, _indices.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setupQuadVertexAttribPointers(size_t offset)
+{
+#define kQuadSize sizeof(_quads[0].bl)
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
+void Renderer::setQuadBatchSize(int quadBatchSize)
+{
+    CCASSERT(!_isRendering, "Cannot change the batch size while rendering");
+    CCASSERT(quadBatchSize > 0 && quadBatchSize <= MAX_QUAD_BATCH_SIZE, "Invalid batch size");
+
+    if (quadBatchSize == _quadBatchSize)
+        return;
+
+    _quadBatchSize = quadBatchSize;
+    _quads.resize(_quadBatchSize);
+    _indices.resize(_quadBatchSize * 6);
+    setupIndices();
+
+    if (_glViewAssigned)
+    {
+        mapBuffers();
+        _quadVertexStream.resize(sizeof(_quads[0]) * _quadBatchSize * VERTEX_STREAM_BATCHES);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueue =_commandGroupStack.top();
-    addCommand(command, renderQueue);
+    pushCommand(command, *_currentRenderQueue);
 }
 
 void Renderer::addCommand(RenderCommand* command, int renderQueue)
 {
-    CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
+    pushCommand(command, getRenderQueue(renderQueue));
+}
+
+void Renderer::pushCommand(RenderCommand* command, RenderQueue& renderQueue)
+{
+    CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
-    _renderGroups[renderQueue].push_back(command);
+    // recorders push to their own frame arena, so the worker threads don't share it
+    renderQueue.push_back(command, &_frameArena);
+
+    if (RenderCommand::Type::GROUP_COMMAND == command->getType())
+    {
+        auto groupCommand = static_cast<GroupCommand*>(command);
+        getRenderQueue(groupCommand->getRenderQueueID()).setOrderIndependent(groupCommand->isOrderIndependent());
+    }
+}
+
+void Renderer::setRenderQueueOrderIndependent(int renderQueueID, bool orderIndependent)
+{
+    getRenderQueue(renderQueueID).setOrderIndependent(orderIndependent);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.push(renderQueueID);
+    _currentRenderQueue = &getRenderQueue(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.pop();
+    _currentRenderQueue = &getRenderQueue(_commandGroupStack.top());
 }
 
 int Renderer::createRenderQueue()
 {
-    RenderQueue newRenderQueue;
-    _renderGroups.push_back(newRenderQueue);
+    CCASSERT(_owner == nullptr, "The render queues are created by the main renderer");
+
+    std::lock_guard<std::mutex> lock(_renderGroupsMutex);
+    _renderGroups.push_back(RenderQueue());
+    _heapAllocations++;
     return (int)_renderGroups.size() - 1;
 }
 
+RenderQueue& Renderer::getRenderQueue(int renderQueueID)
+{
+    // the default queue of a recorder is its own, the queues of the groups are the ones of the main renderer
+    if (_owner && renderQueueID != DEFAULT_RENDER_QUEUE)
+    {
+        return _owner->getRenderQueue(renderQueueID);
+    }
+
+    std::lock_guard<std::mutex> lock(_renderGroupsMutex);
+    CCASSERT(renderQueueID >= 0 && renderQueueID < static_cast<int>(_renderGroups.size()), "Invalid render queue");
+    return _renderGroups[renderQueueID];
+}
+
+void Renderer::setVisitThreadCount(int count)
+{
+    CCASSERT(_owner == nullptr, "Recorders can't visit concurrently");
+    CCASSERT(count >= 0, "Invalid thread count");
+
+    if (count == getVisitThreadCount())
+        return;
+
+    finishConcurrentVisits();
+
+    CC_SAFE_DELETE(_visitPool);
+    if (count > 0)
+    {
+        _visitPool = new ThreadPool(count);
+    }
+}
+
+int Renderer::getVisitThreadCount() const
+{
+    return _visitPool ? _visitPool->getThreadCount() : 0;
+}
+
+bool Renderer::visitConcurrently(Node* node, const Mat4& parentTransform, bool parentTransformUpdated)
+{
+    // subtrees nested in a subtree visited by a worker are visited by the same worker
+    if (_visitPool == nullptr || _owner != nullptr)
+        return false;
+
+    if (_concurrentVisits.size() == _visitRecorders.size())
+    {
+        _visitRecorders.push_back(new Renderer(this));
+    }
+
+    Renderer* recorder = _visitRecorders[_concurrentVisits.size()];
+    recorder->_cullingEnabled = _cullingEnabled;
+
+    ConcurrentVisit visit;
+    visit.recorder = recorder;
+    visit.renderQueue = _currentRenderQueue;
+    visit.insertionPoint = _currentRenderQueue->getInsertionPoint();
+    _concurrentVisits.push_back(visit);
+
+    {
+        std::lock_guard<std::mutex> lock(_concurrentVisitsMutex);
+        _pendingConcurrentVisits++;
+    }
+
+    Mat4 transform = parentTransform;
+    _visitPool->enqueue([this, recorder, node, transform, parentTransformUpdated]() {
+        node->visit(recorder, transform, parentTransformUpdated);
+
+        std::lock_guard<std::mutex> lock(_concurrentVisitsMutex);
+        _pendingConcurrentVisits--;
+        _concurrentVisitsCondition.notify_all();
+    });
+
+    return true;
+}
+
+void Renderer::finishConcurrentVisits()
+{
+    if (_concurrentVisits.empty())
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(_concurrentVisitsMutex);
+        _concurrentVisitsCondition.wait(lock, [this]() { return _pendingConcurrentVisits == 0; });
+    }
+
+    // from the last one, so the insertion points of the previous ones are still valid
+    for (auto it = _concurrentVisits.rbegin(); it != _concurrentVisits.rend(); ++it)
+    {
+        Renderer* recorder = it->recorder;
+        it->renderQueue->insert(it->insertionPoint, recorder->_renderGroups[DEFAULT_RENDER_QUEUE], &_frameArena);
+        _visitCulledNodes += recorder->_visitCulledNodes;
+
+        // the frame arena of the recorder is kept until clean(): the commands may have been allocated from it
+        recorder->_renderGroups[DEFAULT_RENDER_QUEUE].clear();
+        recorder->_visitCulledNodes = 0;
+    }
+
+    _concurrentVisits.clear();
+}
+
 void Renderer::visitRenderQueue(const RenderQueue& queue)
 {
     ssize_t size = queue.size();
@@ -285,18 +630,17 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         {
             auto cmd = static_cast<QuadCommand*>(command);
             //Batch quads
-            if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
+            if(_numQuads + cmd->getQuadCount() > _quadBatchSize)
             {
-                CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
+                CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() <= _quadBatchSize, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
                 
                 //Draw batched quads if VBO is full
                 drawBatchedQuads();
             }
             
-            _batchedQuadCommands.push_back(cmd);
-            
-            memcpy(_quads + _numQuads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
-            convertToWorldCoordinates(_quads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
+            // quads are copied and transformed in one pass when the batch is drawn
+            pushBackCountingAllocations(_batchedQuadCommands, cmd, _heapAllocations);
+            pushBackCountingAllocations(_batchedQuadOffsets, _numQuads, _heapAllocations);
             
             _numQuads += cmd->getQuadCount();
 
@@ -337,29 +681,39 @@ void Renderer::render()
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    CCASSERT(_owner == nullptr, "Recorders can't render");
+
+    // the nodes visited by worker threads must be in the render queues before they are sorted
+    finishConcurrentVisits();
+
     //TODO setup camera or MVP
     _isRendering = true;
     
     if (_glViewAssigned)
     {
         // cleanup
-        _drawnBatches = _drawnVertices = 0;
+        _drawnBatches = _drawnVertices = _savedBatches = 0;
+        _culledNodes = _visitCulledNodes;
 
         //Process render commands
         //1. Sort render commands based on ID
         for (auto &renderqueue : _renderGroups)
         {
-            renderqueue.sort();
+            renderqueue.sort(&_frameArena);
+            _savedBatches += renderqueue.getSavedBatches();
         }
         visitRenderQueue(_renderGroups[0]);
         flush();
     }
     clean();
+    _visitCulledNodes = 0;
     _isRendering = false;
 }
 
 void Renderer::clean()
 {
+    finishConcurrentVisits();
+
     // Clear render group
     for (size_t j = 0 ; j < _renderGroups.size(); j++)
     {
@@ -371,11 +725,31 @@ void Renderer::clean()
         _renderGroups[j].clear();
     }
 
+    // after clearing the queues: the recorders may have grown the queues of the groups in their frame arenas
+    for (auto recorder : _visitRecorders)
+    {
+        recorder->clean();
+    }
+
     // Clear batch quad commands
     _batchedQuadCommands.clear();
+    _batchedQuadOffsets.clear();
     _numQuads = 0;
 
     _lastMaterialID = 0;
+
+    // the commands and data of the frame, and the storage of the queues, are not used anymore
+    _frameArena.reset();
+}
+
+unsigned int Renderer::getHeapAllocations() const
+{
+    unsigned int allocations = _heapAllocations + _frameArena.getHeapAllocations();
+    for (const auto recorder : _visitRecorders)
+    {
+        allocations += recorder->getHeapAllocations();
+    }
+    return allocations;
 }
 
 void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView)
@@ -383,23 +757,55 @@ void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quanti
 //    kmMat4 matrixP, mvp;
 //    kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
 //    kmMat4Multiply(&mvp, &matrixP, &modelView);
-    for(ssize_t i=0; i<quantity; ++i)
+    // the 4 vertices of a quad are contiguous, so all the quads can be transformed as one strided array
+    modelView.transformPoints(&quads->bl.vertices, quantity * 4, sizeof(V3F_C4B_T2F));
+}
+
+void Renderer::fillQuads()
+{
+    auto fillRange = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto cmd = _batchedQuadCommands[i];
+            auto quads = _quads.data() + _batchedQuadOffsets[i];
+            memcpy(quads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
+            convertToWorldCoordinates(quads, cmd->getQuadCount(), cmd->getModelView());
+        }
+    };
+
+    if (_quadTransformPool && _numQuads >= QUAD_TRANSFORM_PARALLEL_THRESHOLD)
     {
-        V3F_C4B_T2F_Quad *q = &quads[i];
-        Vec3 *vec1 = (Vec3*)&q->bl.vertices;
-        modelView.transformPoint(vec1);
+        // every command writes to its own range of _quads, so they can be processed concurrently
+        size_t commands = _batchedQuadCommands.size();
+        size_t grainSize = commands / (_quadTransformPool->getThreadCount() * 4) + 1;
+        _quadTransformPool->parallelFor(commands, grainSize, fillRange);
+    }
+    else
+    {
+        fillRange(0, _batchedQuadCommands.size());
+    }
+}
 
-        Vec3 *vec2 = (Vec3*)&q->br.vertices;
-        modelView.transformPoint(vec2);
+void Renderer::setQuadTransformThreadCount(int count)
+{
+    CCASSERT(!_isRendering, "Cannot change the worker threads while rendering");
+    CCASSERT(count >= 0, "Invalid thread count");
 
-        Vec3 *vec3 = (Vec3*)&q->tr.vertices;
-        modelView.transformPoint(vec3);
+    if (count == getQuadTransformThreadCount())
+        return;
 
-        Vec3 *vec4 = (Vec3*)&q->tl.vertices;
-        modelView.transformPoint(vec4);
+    CC_SAFE_DELETE(_quadTransformPool);
+    if (count > 0)
+    {
+        _quadTransformPool = new ThreadPool(count);
     }
 }
 
+int Renderer::getQuadTransformThreadCount() const
+{
+    return _quadTransformPool ? _quadTransformPool->getThreadCount() : 0;
+}
+
 void Renderer::drawBatchedQuads()
 {
     //TODO we can improve the draw performance by insert material switching command before hand.
@@ -413,49 +819,25 @@ void Renderer::drawBatchedQuads()
         return;
     }
 
-    if (Configuration::getInstance()->supportsShareableVAO())
-    {
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
+    fillQuads();
 
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * (_numQuads), nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _quads, sizeof(_quads[0])* (_numQuads));
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    //Append the quads to the ring buffer, the data of the previous batches is not overwritten
+    size_t offset = _quadVertexStream.upload(_quads.data(), sizeof(_quads[0]) * _numQuads);
 
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
         //Bind VAO
         GL::bindVAO(_quadVAO);
     }
     else
     {
-#define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _numQuads , _quads, GL_DYNAMIC_DRAW);
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
     }
 
+    setupQuadVertexAttribPointers(offset);
+
     //Start drawing verties in batch
     for(const auto& cmd : _batchedQuadCommands)
     {
@@ -496,11 +878,12 @@ void Renderer::drawBatchedQuads()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     _batchedQuadCommands.clear();
+    _batchedQuadOffsets.clear();
     _numQuads = 0;
 }
 
@@ -542,4 +925,31 @@ bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
     return ret;
 }
 
+bool Renderer::checkVisibility(const Mat4 &transform, const Rect &rect)
+{
+    // half size of the screen
+    Size screen_half = Director::getInstance()->getWinSize();
+    screen_half.width /= 2;
+    screen_half.height /= 2;
+
+    float hSizeX = rect.size.width/2;
+    float hSizeY = rect.size.height/2;
+
+    Vec4 v4world, v4local;
+    v4local.set(rect.origin.x + hSizeX, rect.origin.y + hSizeY, 0, 1);
+    transform.transformVector(v4local, &v4world);
+
+    // center of screen is (0,0)
+    v4world.x -= screen_half.width;
+    v4world.y -= screen_half.height;
+
+    // convert the half size of the rect to world coordinates
+    float wshw = std::max(fabsf(hSizeX * transform.m[0] + hSizeY * transform.m[4]), fabsf(hSizeX * transform.m[0] - hSizeY * transform.m[4]));
+    float wshh = std::max(fabsf(hSizeX * transform.m[1] + hSizeY * transform.m[5]), fabsf(hSizeX * transform.m[1] - hSizeY * transform.m[5]));
+
+    float tmpx = (fabsf(v4world.x)-wshw);
+    float tmpy = (fabsf(v4world.y)-wshh);
+    return (tmpx < screen_half.width && tmpy < screen_half.height);
+}
+
 NS_CC_END
@@ -27,36 +27,77 @@
 #define __CC_RENDERER_H_
 
 #include <vector>
+#include <deque>
 #include <stack>
+#include <mutex>
+#include <condition_variable>
 
 #include "base/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCStreamingVertexBuffer.h"
+#include "renderer/CCRenderArena.h"
 #include "CCGL.h"
 
 NS_CC_BEGIN
 
 class EventListenerCustom;
 class QuadCommand;
+class ThreadPool;
+class Node;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+
+ If the queue is "order independent", consecutive `QuadCommand` objects with the same
+ global order are also grouped by material ID, so they can be drawn in fewer batches.
+ Only use it when the quads of the queue don't overlap, or when their drawing order doesn't matter (eg: opaque quads).
 */
 class RenderQueue {
 
 public:
-    void push_back(RenderCommand* command);
+    RenderQueue();
+    /** Adds a command. The storage of the queue grows in `arena`, so it must not be reset before the queue is cleared */
+    void push_back(RenderCommand* command, RenderArena* arena);
     ssize_t size() const;
-    void sort();
+    /** Sorts the commands by global order, the commands with the same global order keep the order they were pushed in.
+     `scratch`, when not null, is used for the temporary memory of the sorts */
+    void sort(RenderArena* scratch = nullptr);
     RenderCommand* operator[](ssize_t index) const;
     void clear();
 
+    /** Sets whether the quads with the same global order can be reordered by material */
+    inline void setOrderIndependent(bool orderIndependent) { _orderIndependent = orderIndependent; }
+    inline bool isOrderIndependent() const { return _orderIndependent; }
+
+    /** returns how many batches were saved by the last sort() grouping the quads by material */
+    inline ssize_t getSavedBatches() const { return _savedBatches; }
+
+    /** Position in the queue, see insert() */
+    struct InsertionPoint
+    {
+        size_t negZ;
+        size_t zero;
+        size_t posZ;
+    };
+    /** returns the position where the next pushed command will be */
+    InsertionPoint getInsertionPoint() const;
+    /** Inserts the commands of `queue` at `point`, as if they had been pushed when getInsertionPoint() returned it.
+     The storage of the queue grows in `arena` */
+    void insert(const InsertionPoint& point, const RenderQueue& queue, RenderArena* arena);
+
 protected:
-    std::vector<RenderCommand*> _queueNegZ;
-    std::vector<RenderCommand*> _queue0;
-    std::vector<RenderCommand*> _queuePosZ;
+    void sortByMaterial(RenderArenaArray<RenderCommand*>& commands, RenderArena* scratch);
+
+    // the commands of one frame: their storage is in the frame arenas of the renderers that pushed them
+    RenderArenaArray<RenderCommand*> _queueNegZ;
+    RenderArenaArray<RenderCommand*> _queue0;
+    RenderArenaArray<RenderCommand*> _queuePosZ;
+
+    bool _orderIndependent;
+    ssize_t _savedBatches;
 };
 
 struct RenderStackElement
@@ -74,8 +115,15 @@ Whenever possible prefer to use `QuadCommand` objects since the renderer will au
 class Renderer
 {
 public:
+    /** default number of quads of a batch */
     static const int VBO_SIZE = 65536 / 6;
+    /** max number of quads of a batch: the indices are 16 bits */
+    static const int MAX_QUAD_BATCH_SIZE = 65536 / 4;
+    /** number of full batches that fit in the vertex ring buffer before it is orphaned */
+    static const int VERTEX_STREAM_BATCHES = 3;
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
+    /** batches with less quads than this are always transformed on the render thread */
+    static const int QUAD_TRANSFORM_PARALLEL_THRESHOLD = 2048;
 
     Renderer();
     ~Renderer();
@@ -112,13 +160,79 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of batches saved in the last frame by grouping the quads of order independent queues by material */
+    ssize_t getSavedBatches() const { return _savedBatches; }
+
+    /** Sets whether the `QuadCommand`s of a render queue that have the same global order can be grouped by material.
+     The flag of a queue that belongs to a `GroupCommand` is overwritten with `GroupCommand::isOrderIndependent()` each time the group is added.
+     */
+    void setRenderQueueOrderIndependent(int renderQueueID, bool orderIndependent);
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /** Sets the number of worker threads used to transform the batched quads into world coordinates.
+     0 (the default) transforms them on the render thread.
+     */
+    void setQuadTransformThreadCount(int count);
+    /** returns the number of worker threads used to transform the batched quads */
+    int getQuadTransformThreadCount() const;
+
+    /** Sets the max number of quads drawn in one batch. Defaults to `VBO_SIZE`, can't be greater than `MAX_QUAD_BATCH_SIZE` */
+    void setQuadBatchSize(int quadBatchSize);
+    /** returns the max number of quads drawn in one batch */
+    int getQuadBatchSize() const { return _quadBatchSize; }
+
+    /** Returns the arena for the render commands and data that only live during the current frame.
+     The render queues are stored in it too. It is reset after the frame is drawn.
+     */
+    RenderArena* getFrameArena() { return &_frameArena; }
+
+    /** returns the number of heap allocations done by the renderer to store the commands of the frames, since it was created */
+    unsigned int getHeapAllocations() const;
+
+    /** returns the ring buffer where the batched quads are streamed. Its stats count the GL calls used to upload them */
+    const StreamingVertexBuffer& getQuadVertexStream() const { return _quadVertexStream; }
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
+    /** returns whether or not a rectangle, in the coordinate system of `transform`, is visible or not */
+    bool checkVisibility(const Mat4& transform, const Rect& rect);
+
+    /** Used by `Node::visit()`: whether culling is enabled for the node being visited (see `Node::setCullingEnabled()`) */
+    void setCullingEnabled(bool enabled) { _cullingEnabled = enabled; }
+    bool isCullingEnabled() const { return _cullingEnabled; }
+    /** Used by `Node::visit()` to count the nodes that were skipped because they were outside of the screen */
+    void addCulledNodes(ssize_t number) { _visitCulledNodes += number; }
+    /** returns the number of nodes culled in the last frame */
+    ssize_t getCulledNodes() const { return _culledNodes; }
+
+    /** Sets the number of worker threads visiting the nodes whose concurrent visit is enabled (see `Node::setConcurrentVisitEnabled()`).
+     The commands of each one of those subtrees are recorded in their own render queue, and inserted where they would have been
+     if the subtree had been visited on the main thread, so the frame doesn't depend on the scheduling of the threads.
+     0 (the default) visits all the nodes on the main thread.
+     */
+    void setVisitThreadCount(int count);
+    /** returns the number of worker threads visiting nodes */
+    int getVisitThreadCount() const;
+
+    /** Used by `Node::visit()`: visits `node` on a worker thread. Returns false if the node must be visited on the calling thread */
+    bool visitConcurrently(Node* node, const Mat4& parentTransform, bool parentTransformUpdated);
+
+    /** Waits for the nodes being visited by worker threads and inserts their commands in the render queues.
+     Called by the Director once the scene is visited, and by render() and clean().
+     */
+    void finishConcurrentVisits();
 
 protected:
+    /** Creates a renderer that records the commands of a subtree visited by a worker thread in its default render queue.
+     The render queues of the groups are the ones of `owner`.
+     */
+    explicit Renderer(Renderer* owner);
+
+    /** returns a render queue. Render queues can be created by other threads while nodes are visited concurrently */
+    RenderQueue& getRenderQueue(int renderQueueID);
+
+    void pushCommand(RenderCommand* command, RenderQueue& renderQueue);
 
     void setupIndices();
     //Setup VBO or VAO based on OpenGL extensions
@@ -126,6 +240,8 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    //Points the vertex attribs to the quads streamed at offset
+    void setupQuadVertexAttribPointers(size_t offset);
 
     void drawBatchedQuads();
 
@@ -136,19 +252,35 @@ protected:
 
     void convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView);
 
+    //Copies the quads of the batched commands into _quads and transforms them to world coordinates
+    void fillQuads();
+
     std::stack<int> _commandGroupStack;
     
-    std::vector<RenderQueue> _renderGroups;
+    // a deque, so the queues are not moved when a queue is created by another thread
+    std::deque<RenderQueue> _renderGroups;
+    std::mutex _renderGroupsMutex;
+    RenderQueue* _currentRenderQueue;
 
     uint32_t _lastMaterialID;
 
     std::vector<QuadCommand*> _batchedQuadCommands;
+    //offset in _quads of each one of the _batchedQuadCommands
+    std::vector<int> _batchedQuadOffsets;
+
+    ThreadPool* _quadTransformPool;
 
-    V3F_C4B_T2F_Quad _quads[VBO_SIZE];
-    GLushort _indices[6 * VBO_SIZE];
+    RenderArena _frameArena;
+    //growths of the storage owned by the renderer, besides the blocks of the frame arena
+    unsigned int _heapAllocations;
+
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<GLushort> _indices;
     GLuint _quadVAO;
-    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    GLuint _indicesVBO;
+    StreamingVertexBuffer _quadVertexStream;
 
+    int _quadBatchSize;
     int _numQuads;
     
     bool _glViewAssigned;
@@ -156,10 +288,32 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _savedBatches;
+    ssize_t _culledNodes;
+    //nodes culled by the visit of the frame being built
+    ssize_t _visitCulledNodes;
+    bool _cullingEnabled;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     GroupCommandManager* _groupCommandManager;
+
+    // concurrent visits
+    struct ConcurrentVisit
+    {
+        Renderer* recorder;
+        RenderQueue* renderQueue;
+        RenderQueue::InsertionPoint insertionPoint;
+    };
+
+    //the renderer that owns this one, when it records the commands of a worker thread
+    Renderer* _owner;
+    ThreadPool* _visitPool;
+    std::vector<Renderer*> _visitRecorders;
+    std::vector<ConcurrentVisit> _concurrentVisits;
+    int _pendingConcurrentVisits;
+    std::mutex _concurrentVisitsMutex;
+    std::condition_variable _concurrentVisitsCondition;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
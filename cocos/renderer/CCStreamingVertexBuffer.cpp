@@ -0,0 +1,203 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCStreamingVertexBuffer.h"
+
+#include <string.h>
+
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+static StreamingVertexBuffer::Stats s_globalStats = { 0, 0, 0, 0, 0 };
+
+StreamingVertexBuffer::StreamingVertexBuffer()
+: _name(0)
+, _capacity(0)
+, _writeOffset(0)
+, _mapBufferRangeEnabled(false)
+{
+    resetStats();
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+    releaseBuffer();
+}
+
+bool StreamingVertexBuffer::init(size_t capacity)
+{
+    CCASSERT(capacity > 0, "Invalid capacity");
+
+    _mapBufferRangeEnabled = Configuration::getInstance()->supportsMapBufferRange();
+
+    // the old name is not deleted: after a context loss it is no longer valid
+    _name = createBuffer();
+    _capacity = capacity;
+    _writeOffset = 0;
+
+    bindBuffer(_name);
+    allocateStorage(_capacity);
+
+    return _name != 0;
+}
+
+void StreamingVertexBuffer::resize(size_t capacity)
+{
+    CCASSERT(_name, "StreamingVertexBuffer is not initialized");
+    CCASSERT(capacity > 0, "Invalid capacity");
+
+    _capacity = capacity;
+    _writeOffset = 0;
+
+    bindBuffer(_name);
+    allocateStorage(_capacity);
+}
+
+size_t StreamingVertexBuffer::upload(const void* data, size_t size)
+{
+    CCASSERT(size <= _capacity, "StreamingVertexBuffer is not big enough for the data");
+
+    bindBuffer(_name);
+
+    size_t offset = (_writeOffset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (offset + size > _capacity)
+    {
+        // orphan: the GPU keeps the old storage until it is done with it
+        allocateStorage(_capacity);
+        offset = 0;
+        _stats.wraps++;
+        s_globalStats.wraps++;
+    }
+
+    writeStorage(offset, data, size);
+    _writeOffset = offset + size;
+
+    _stats.uploadedBytes += size;
+    s_globalStats.uploadedBytes += size;
+
+    return offset;
+}
+
+void StreamingVertexBuffer::bind()
+{
+    bindBuffer(_name);
+}
+
+void StreamingVertexBuffer::setMapBufferRangeEnabled(bool enabled)
+{
+    CCASSERT(!enabled || Configuration::getInstance()->supportsMapBufferRange(), "glMapBufferRange is not supported");
+    _mapBufferRangeEnabled = enabled;
+}
+
+void StreamingVertexBuffer::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+const StreamingVertexBuffer::Stats& StreamingVertexBuffer::getGlobalStats()
+{
+    return s_globalStats;
+}
+
+void StreamingVertexBuffer::resetGlobalStats()
+{
+    memset(&s_globalStats, 0, sizeof(s_globalStats));
+}
+
+void StreamingVertexBuffer::releaseBuffer()
+{
+    if (_name)
+    {
+        deleteBuffer(_name);
+        _name = 0;
+    }
+}
+
+void StreamingVertexBuffer::countBufferData()
+{
+    _stats.bufferDataCalls++;
+    s_globalStats.bufferDataCalls++;
+}
+
+void StreamingVertexBuffer::countBufferSubData()
+{
+    _stats.bufferSubDataCalls++;
+    s_globalStats.bufferSubDataCalls++;
+}
+
+void StreamingVertexBuffer::countMapBufferRange()
+{
+    _stats.mapBufferRangeCalls++;
+    s_globalStats.mapBufferRangeCalls++;
+}
+
+// GL entry points
+
+GLuint StreamingVertexBuffer::createBuffer()
+{
+    GLuint name = 0;
+    glGenBuffers(1, &name);
+    return name;
+}
+
+void StreamingVertexBuffer::deleteBuffer(GLuint name)
+{
+    glDeleteBuffers(1, &name);
+}
+
+void StreamingVertexBuffer::bindBuffer(GLuint name)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, name);
+}
+
+void StreamingVertexBuffer::allocateStorage(size_t size)
+{
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    countBufferData();
+}
+
+void StreamingVertexBuffer::writeStorage(size_t offset, const void* data, size_t size)
+{
+#if defined(GL_MAP_WRITE_BIT)
+    if (_mapBufferRangeEnabled)
+    {
+        // the range was never written since the last orphan, so there is nothing to wait for
+        void* buf = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        countMapBufferRange();
+        if (buf)
+        {
+            memcpy(buf, data, size);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            return;
+        }
+    }
+#endif
+
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    countBufferSubData();
+}
+
+NS_CC_END
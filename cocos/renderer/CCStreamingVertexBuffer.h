@@ -0,0 +1,134 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_STREAMING_VERTEX_BUFFER_H__
+#define __CC_STREAMING_VERTEX_BUFFER_H__
+
+#include <stddef.h>
+
+#include "base/CCPlatformMacros.h"
+#include "CCGL.h"
+
+NS_CC_BEGIN
+
+/** A vertex buffer used as a ring, for vertices that are rewritten every time they are drawn.
+
+ Each `upload()` appends the data after the previous one, so ranges that the GPU may still be reading
+ are never overwritten and no synchronization is needed. When the ring is full its storage is orphaned
+ (the driver gives us a new one while the GPU finishes with the old one) and writing starts again at
+ offset 0. Size it to hold a few frames of data so that happens only once every few frames.
+
+ The data is written with glMapBufferRange (unsynchronized) when available, and with glBufferSubData
+ otherwise (eg: GLES2 without GL_EXT_map_buffer_range).
+
+ All the GL calls go through protected virtual methods, so a subclass can replace them with a mock
+ and the number of calls (see `getStats()`) can be measured without a GL context.
+ */
+class CC_DLL StreamingVertexBuffer
+{
+public:
+    /** GL calls issued by the buffers */
+    struct Stats
+    {
+        /** glBufferData calls: allocations and orphans */
+        unsigned int bufferDataCalls;
+        /** glBufferSubData calls */
+        unsigned int bufferSubDataCalls;
+        /** glMapBufferRange calls */
+        unsigned int mapBufferRangeCalls;
+        /** number of times the ring was full and the storage was orphaned */
+        unsigned int wraps;
+        /** bytes written */
+        size_t uploadedBytes;
+    };
+
+    /** offsets returned by upload() are aligned to this number of bytes */
+    static const size_t ALIGNMENT = 16;
+
+    StreamingVertexBuffer();
+    virtual ~StreamingVertexBuffer();
+
+    /** Creates the GL buffer, with `capacity` bytes of storage.
+     Call it again to recreate the buffer after the GL context was lost.
+     */
+    bool init(size_t capacity);
+
+    /** Changes the size of the ring. The offsets returned before are no longer valid. */
+    void resize(size_t capacity);
+
+    /** Writes `size` bytes into the ring and returns the offset in bytes where they were written.
+     If they don't fit, the storage is orphaned first, so the offsets returned before are no longer valid.
+     The buffer is left bound to GL_ARRAY_BUFFER.
+     */
+    size_t upload(const void* data, size_t size);
+
+    /** Binds the buffer to GL_ARRAY_BUFFER */
+    void bind();
+
+    /** returns the GL name of the buffer */
+    GLuint getName() const { return _name; }
+    /** returns the size of the ring in bytes */
+    size_t getCapacity() const { return _capacity; }
+
+    /** Whether glMapBufferRange is used to write the data. By default it is used when `Configuration` reports support for it. */
+    void setMapBufferRangeEnabled(bool enabled);
+    bool isMapBufferRangeEnabled() const { return _mapBufferRangeEnabled; }
+
+    /** returns the GL calls issued by this buffer since it was created or since resetStats() */
+    const Stats& getStats() const { return _stats; }
+    void resetStats();
+
+    /** returns the GL calls issued by all the buffers since the last resetGlobalStats() */
+    static const Stats& getGlobalStats();
+    static void resetGlobalStats();
+
+protected:
+    // GL entry points. A subclass overriding deleteBuffer() must call releaseBuffer() in its own destructor:
+    // the base destructor can only reach the base implementation, which calls glDeleteBuffers.
+    virtual GLuint createBuffer();
+    virtual void deleteBuffer(GLuint name);
+    virtual void bindBuffer(GLuint name);
+    virtual void allocateStorage(size_t size);
+    virtual void writeStorage(size_t offset, const void* data, size_t size);
+
+    /** deletes the buffer with deleteBuffer() and forgets its name */
+    void releaseBuffer();
+
+    void countBufferData();
+    void countBufferSubData();
+    void countMapBufferRange();
+
+    GLuint _name;
+    size_t _capacity;
+    size_t _writeOffset;
+    bool _mapBufferRangeEnabled;
+    Stats _stats;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StreamingVertexBuffer);
+};
+
+NS_CC_END
+
+#endif // __CC_STREAMING_VERTEX_BUFFER_H__
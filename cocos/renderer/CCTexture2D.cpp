@@ -33,6 +33,9 @@ THE SOFTWARE.
 
 #include "renderer/CCTexture2D.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "CCGL.h"
 #include "platform/CCImage.h"
 #include "base/ccUtils.h"
@@ -45,6 +48,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCPixelConversion.h"
 
 #include "deprecated/CCString.h"
 
@@ -312,18 +316,6 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
     }
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
-void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
-}
-
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
 void Texture2D::convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
@@ -362,16 +354,6 @@ void Texture2D::convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen,
 }
 
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
-void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
-{
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = data[i + 3];
-    }
-}
-
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
@@ -385,19 +367,6 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
     }
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
-void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
-}
-
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
@@ -411,18 +380,6 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
     }
 }
 
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
-void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
-}
 // conventer function end
 //////////////////////////////////////////////////////////////////////////
 
@@ -437,7 +394,13 @@ Texture2D::Texture2D()
 , _hasMipmaps(false)
 , _shaderProgram(nullptr)
 , _antialiasEnabled(true)
+, _uploadData(nullptr)
+, _uploadImage(nullptr)
+, _uploadedRows(0)
+, _mipmapsDeferred(false)
 {
+    // the textures are shared with the loader threads
+    setReferenceCountThreadSafe(true);
 }
 
 Texture2D::~Texture2D()
@@ -448,6 +411,7 @@ Texture2D::~Texture2D()
 
     CCLOGINFO("deallocing Texture2D: %p - id=%u", this, _name);
     CC_SAFE_RELEASE(_shaderProgram);
+    releaseUploadData();
 
     if(_name)
     {
@@ -552,6 +516,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
         GL::deleteTexture(_name);
       _name = 0;
     }
+    releaseUploadData();
 
     //the pixelFormat must be a certain value 
     CCASSERT(pixelFormat != PixelFormat::NONE && pixelFormat != PixelFormat::AUTO, "the \"pixelFormat\" param must be a certain value!");
@@ -584,24 +549,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     //Set the row align only when mipmapsNum == 1 and the data is uncompressed
     if (mipmapsNum == 1 && !info.compressed)
     {
-        unsigned int bytesPerRow = pixelsWide * info.bpp / 8;
-
-        if(bytesPerRow % 8 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
-        }
-        else if(bytesPerRow % 4 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        }
-        else if(bytesPerRow % 2 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-        }
-        else
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        }
+        setUnpackAlignment(pixelsWide * info.bpp / 8);
     }else
     {
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -688,6 +636,26 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     return true;
 }
 
+void Texture2D::setUnpackAlignment(unsigned int bytesPerRow)
+{
+    if(bytesPerRow % 8 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+    }
+    else if(bytesPerRow % 4 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    else if(bytesPerRow % 2 == 0)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    }
+    else
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+}
+
 bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int width,int height)
 {
     if (_name)
@@ -774,7 +742,7 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
         unsigned char* outTempData = nullptr;
         ssize_t outTempDataLen = 0;
 
-        pixelFormat = convertDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, &outTempData, &outTempDataLen);
+        pixelFormat = convertDataToFormat(tempData, tempDataLen, renderFormat, pixelFormat, &outTempData, &outTempDataLen, imageWidth);
 
         initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
 
@@ -804,6 +772,110 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
     }
 }
 
+bool Texture2D::initWithImageProgressively(Image *image, PixelFormat format)
+{
+    if (image == nullptr || image->getNumberOfMipmaps() > 1 || image->isCompressed())
+    {
+        return initWithImage(image, format);
+    }
+
+    int imageWidth = image->getWidth();
+    int imageHeight = image->getHeight();
+
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (imageWidth > maxTextureSize || imageHeight > maxTextureSize)
+    {
+        CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", imageWidth, imageHeight, maxTextureSize, maxTextureSize);
+        return false;
+    }
+
+    unsigned char* tempData = image->getData();
+    PixelFormat pixelFormat = (format != PixelFormat::NONE) ? format : g_defaultAlphaPixelFormat;
+    unsigned char* outTempData = nullptr;
+    ssize_t outTempDataLen = 0;
+
+    pixelFormat = convertDataToFormat(tempData, image->getDataLen(), image->getRenderFormat(), pixelFormat, &outTempData, &outTempDataLen, imageWidth);
+
+    // allocates the texture without its pixels
+    if (!initWithData(nullptr, outTempDataLen, pixelFormat, imageWidth, imageHeight, Size((float)imageWidth, (float)imageHeight)))
+    {
+        if (outTempData != nullptr && outTempData != tempData)
+        {
+            free(outTempData);
+        }
+        return false;
+    }
+
+    _uploadData = outTempData;
+    _uploadedRows = 0;
+    if (outTempData == tempData)
+    {
+        // the pixels of the image are used as they are, keep it until they are uploaded
+        _uploadImage = image;
+        _uploadImage->retain();
+    }
+
+    // set the premultiplied tag
+    if (!image->hasPremultipliedAlpha())
+    {
+        _hasPremultipliedAlpha = (image->getFileType() == Image::Format::PVR) ? _PVRHaveAlphaPremultiplied : false;
+    }
+    else
+    {
+        _hasPremultipliedAlpha = image->isPremultipliedAlpha();
+    }
+    return true;
+}
+
+int Texture2D::uploadProgressively(float seconds)
+{
+    if (_uploadData == nullptr)
+        return 0;
+
+    // strips of about 128 KB
+    const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
+    unsigned int bytesPerRow = _pixelsWide * info.bpp / 8;
+    int rowsPerStrip = std::max(1, static_cast<int>(128 * 1024 / std::max(1u, bytesPerRow)));
+
+    GL::bindTexture2D(_name);
+    setUnpackAlignment(bytesPerRow);
+
+    auto begin = std::chrono::steady_clock::now();
+    int strips = 0;
+    do
+    {
+        int rows = std::min(rowsPerStrip, _pixelsHigh - _uploadedRows);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _uploadedRows, _pixelsWide, rows, info.format, info.type, _uploadData + (size_t)_uploadedRows * bytesPerRow);
+        _uploadedRows += rows;
+        ++strips;
+    } while (_uploadedRows < _pixelsHigh && std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count() < seconds);
+
+    if (_uploadedRows >= _pixelsHigh)
+    {
+        releaseUploadData();
+        if (_mipmapsDeferred)
+        {
+            _mipmapsDeferred = false;
+            generateMipmap();
+        }
+    }
+    return strips;
+}
+
+void Texture2D::releaseUploadData()
+{
+    if (_uploadImage)
+    {
+        CC_SAFE_RELEASE_NULL(_uploadImage);
+    }
+    else if (_uploadData)
+    {
+        free(_uploadData);
+    }
+    _uploadData = nullptr;
+    _uploadedRows = 0;
+}
+
 Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen)
 {
     switch (format)
@@ -956,7 +1028,7 @@ Texture2D::PixelFormat Texture2D::convertRGB888ToFormat(const unsigned char* dat
     return format;
 }
 
-Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen)
+Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen, int pixelsWide)
 {
 
     switch (format)
@@ -969,7 +1041,7 @@ Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* d
     case PixelFormat::RGB565:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGB565(data, dataLen, *outData);
+        PixelConversion::convertRGBA8888ToRGB565(data, dataLen, *outData, pixelsWide);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/4;
@@ -984,17 +1056,17 @@ Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* d
     case PixelFormat::AI88:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToAI88(data, dataLen, *outData);
+        PixelConversion::convertRGBA8888ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGBA4444(data, dataLen, *outData);
+        PixelConversion::convertRGBA8888ToRGBA4444(data, dataLen, *outData, pixelsWide);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen/2;
         *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
-        convertRGBA8888ToRGB5A1(data, dataLen, *outData);
+        PixelConversion::convertRGBA8888ToRGB5A1(data, dataLen, *outData, pixelsWide);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -1028,7 +1100,7 @@ rgb(2) -> 1235678
 rgba(1) -> 12345678
 
 */
-Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen)
+Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen, int pixelsWide)
 {
     switch (originFormat)
     {
@@ -1039,9 +1111,12 @@ Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data,
     case PixelFormat::RGB888:
         return convertRGB888ToFormat(data, dataLen, format, outData, outDataLen);
     case PixelFormat::RGBA8888:
-        return convertRGBA8888ToFormat(data, dataLen, format, outData, outDataLen);
+        return convertRGBA8888ToFormat(data, dataLen, format, outData, outDataLen, pixelsWide);
     default:
-        CCLOG("unsupport convert for format %d to format %d", originFormat, format);
+        if (format != originFormat)
+        {
+            CCLOG("unsupport convert for format %d to format %d", originFormat, format);
+        }
         *outData = (unsigned char*)data;
         *outDataLen = dataLen;
         return originFormat;
@@ -1128,7 +1203,7 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     }
 
     Size  imageSize = Size((float)imageWidth, (float)imageHeight);
-    pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
+    pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen, imageWidth);
 
     ret = initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
 
@@ -1227,6 +1302,12 @@ void Texture2D::PVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
 void Texture2D::generateMipmap()
 {
     CCASSERT(_pixelsWide == ccNextPOT(_pixelsWide) && _pixelsHigh == ccNextPOT(_pixelsHigh), "Mipmap texture only works in POT textures");
+    if (!isReady())
+    {
+        // generated by uploadProgressively() once the pixels are there
+        _mipmapsDeferred = true;
+        return;
+    }
     GL::bindTexture2D( _name );
     glGenerateMipmap(GL_TEXTURE_2D);
     _hasMipmaps = true;
@@ -240,6 +240,27 @@ public:
     **/
     bool initWithImage(Image * image, PixelFormat format);
 
+    /**
+    Initializes a texture like initWithImage(), except that its pixels are uploaded by the next calls to uploadProgressively(),
+    so a big image doesn't stall a frame. The texture isn't ready until then.
+    The compressed images and the ones with mipmaps are uploaded at once.
+    @since v3.2
+    */
+    bool initWithImageProgressively(Image * image, PixelFormat format = PixelFormat::NONE);
+
+    /**
+    Uploads strips of rows of the image given to initWithImageProgressively() for "seconds" at most, one strip at least.
+    The mipmaps requested meanwhile are generated once the last row is uploaded.
+    Returns the number of strips uploaded.
+    @since v3.2
+    */
+    int uploadProgressively(float seconds);
+
+    /** Whether all the pixels of the texture are uploaded. Sprite doesn't draw a texture which isn't ready.
+    @since v3.2
+    */
+    bool isReady() const { return _uploadData == nullptr; }
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size */
     bool initWithString(const char *text,  const std::string &fontName, float fontSize, const Size& dimensions = Size(0, 0), TextHAlignment hAlignment = TextHAlignment::CENTER, TextVAlignment vAlignment = TextVAlignment::TOP);
     /** Initializes a texture from a string using a text definition*/
@@ -346,19 +367,21 @@ public:
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
     
 private:
+    friend class TextureTranscoder;
 
     /**convert functions*/
 
     /**
     Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
     It will return the converted format to you. if the outData != data, you must delete it manually.
+    pixelsWide is the width of the image, to dither the RGBA8888 images converted to 16 bits (see PixelConversion), 0 if unknown.
     */
-    static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
+    static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen, int pixelsWide = 0);
 
     static PixelFormat convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertAI88ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertRGB888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
-    static PixelFormat convertRGBA8888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
+    static PixelFormat convertRGBA8888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen, int pixelsWide);
 
     //I8 to XXX
     static void convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
@@ -387,12 +410,12 @@ private:
 
     //RGBA8888 to XXX
     static void convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
-    static void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
     static void convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
     static void convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
-    static void convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
-    static void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
-    static void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+    /** frees the pixels which weren't uploaded by uploadProgressively() */
+    void releaseUploadData();
+    void setUnpackAlignment(unsigned int bytesPerRow);
 
 protected:
     /** pixel format of the texture */
@@ -427,6 +450,13 @@ protected:
     static const PixelFormatInfoMap _pixelFormatInfoTables;
 
     bool _antialiasEnabled;
+
+    /** the pixels to upload by uploadProgressively(), nullptr when the texture is ready */
+    unsigned char* _uploadData;
+    /** the image owning _uploadData, or nullptr if the texture allocated it */
+    Image* _uploadImage;
+    int _uploadedRows;
+    bool _mipmapsDeferred;
 };
 
 
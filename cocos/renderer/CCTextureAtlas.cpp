@@ -53,7 +53,12 @@ NS_CC_BEGIN
 
 TextureAtlas::TextureAtlas()
     :_indices(nullptr)
+    ,_VAOname(0)
+    ,_indicesVBO(0)
     ,_dirty(false)
+    ,_uploadedStart(0)
+    ,_uploadedCount(0)
+    ,_uploadedOffset(0)
     ,_texture(nullptr)
     ,_quads(nullptr)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -68,7 +73,7 @@ TextureAtlas::~TextureAtlas()
     CC_SAFE_FREE(_quads);
     CC_SAFE_FREE(_indices);
 
-    glDeleteBuffers(2, _buffersVBO);
+    glDeleteBuffers(1, &_indicesVBO);
 
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -254,31 +259,28 @@ void TextureAtlas::setupIndices()
 
 //TextureAtlas - VAO / VBO specific
 
+size_t TextureAtlas::getVertexStreamCapacity() const
+{
+    // room for all the quads to be uploaded twice before the storage is orphaned
+    return sizeof(V3F_C4B_T2F_Quad) * MAX(_capacity, 1) * 2;
+}
+
 void TextureAtlas::setupVBOandVAO()
 {
     glGenVertexArrays(1, &_VAOname);
     GL::bindVAO(_VAOname);
 
-#define kQuadSize sizeof(_quads[0].bl)
-
-    glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(1, &_indicesVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, _quads, GL_DYNAMIC_DRAW);
+    _vertexStream.init(getVertexStreamCapacity());
+    _uploadedCount = 0;
 
-    // vertices
+    // the pointers are set when drawing, at the offset where the quads were uploaded
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _capacity * 6, _indices, GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
@@ -291,7 +293,11 @@ void TextureAtlas::setupVBOandVAO()
 
 void TextureAtlas::setupVBO()
 {
-    glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(1, &_indicesVBO);
+
+    _vertexStream.init(getVertexStreamCapacity());
+    _uploadedCount = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     mapBuffers();
 }
@@ -301,17 +307,34 @@ void TextureAtlas::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
 	GL::bindVAO(0);
     
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // the quads are uploaded when they are drawn
+    if (_vertexStream.getCapacity() != getVertexStreamCapacity())
+    {
+        _vertexStream.resize(getVertexStreamCapacity());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    _uploadedCount = 0;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _capacity * 6, _indices, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
+void TextureAtlas::setupVertexAttribPointers(size_t offset)
+{
+#define kQuadSize sizeof(_quads[0].bl)
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
 // TextureAtlas - Update, Insert, Move & Remove
 
 void TextureAtlas::updateQuad(V3F_C4B_T2F_Quad *quad, ssize_t index)
@@ -608,81 +631,57 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
 
     GL::bindTexture2D(_texture->getName());
 
+    // XXX: update is done in draw... perhaps it should be done in a timer
+    // Only the quads to be drawn are uploaded, and only when they are dirty or were not part of the last upload.
+    if (_dirty || start < _uploadedStart || start + numberOfQuads > _uploadedStart + _uploadedCount)
+    {
+        _uploadedOffset = _vertexStream.upload(&_quads[start], sizeof(_quads[0]) * numberOfQuads);
+        _uploadedStart = start;
+        _uploadedCount = numberOfQuads;
+        _dirty = false;
+    }
+    else
+    {
+        _vertexStream.bind();
+    }
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         //
         // Using VBO and VAO
         //
-
-        // XXX: update is done in draw... perhaps it should be done in a timer
-        if (_dirty) 
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-            // option 1: subdata
-//            glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-            // option 2: data
-//            glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-            // option 3: orphaning + glMapBuffer
-            glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * (numberOfQuads-start), nullptr, GL_DYNAMIC_DRAW);
-            void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-            memcpy(buf, _quads, sizeof(_quads[0])* (numberOfQuads-start));
-            glUnmapBuffer(GL_ARRAY_BUFFER);
-            
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            _dirty = false;
-        }
-
         GL::bindVAO(_VAOname);
 
 #if CC_REBIND_INDICES_BUFFER
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
 #endif
-
-        glDrawElements(GL_TRIANGLES, (GLsizei) numberOfQuads*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(_indices[0])) );
-
-#if CC_REBIND_INDICES_BUFFER
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-#endif
-
-//    glBindVertexArray(0);
     }
     else
     {
         //
         // Using VBO without VAO
         //
-
-#define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // XXX: update is done in draw... perhaps it should be done in a timer
-        if (_dirty) 
-        {
-            glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * numberOfQuads , &_quads[start] );
-            _dirty = false;
-        }
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO);
+    }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    // the indices start at 0 for the first quad of the upload
+    setupVertexAttribPointers(_uploadedOffset);
 
-        glDrawElements(GL_TRIANGLES, (GLsizei)numberOfQuads*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(_indices[0])));
+    glDrawElements(GL_TRIANGLES, (GLsizei) numberOfQuads*6, GL_UNSIGNED_SHORT, (GLvoid*) ((start - _uploadedStart)*6*sizeof(_indices[0])) );
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+#if CC_REBIND_INDICES_BUFFER
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
     }
+    else
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,numberOfQuads*6);
 
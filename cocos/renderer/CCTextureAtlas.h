@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "base/CCRef.h"
 #include "base/ccConfig.h"
+#include "renderer/CCStreamingVertexBuffer.h"
 
 NS_CC_BEGIN
 
@@ -228,12 +229,19 @@ private:
     void mapBuffers();
     void setupVBOandVAO();
     void setupVBO();
+    size_t getVertexStreamCapacity() const;
+    void setupVertexAttribPointers(size_t offset);
 
 protected:
     GLushort*           _indices;
     GLuint              _VAOname;
-    GLuint              _buffersVBO[2]; //0: vertex  1: indices
+    GLuint              _indicesVBO;
+    StreamingVertexBuffer _vertexStream;
     bool                _dirty; //indicates whether or not the array buffer of the VBO needs to be updated
+    /** range of quads written in the vertex stream by the last upload, and the offset where they were written */
+    ssize_t             _uploadedStart;
+    ssize_t             _uploadedCount;
+    size_t              _uploadedOffset;
     /** quantity of quads that are going to be drawn */
     ssize_t _totalQuads;
     /** quantity of quads that can be stored with the current texture atlas size */
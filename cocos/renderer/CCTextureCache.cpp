@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -59,11 +62,13 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
+: _asyncWorkerCount(std::max(1, std::min(4, static_cast<int>(std::thread::hardware_concurrency()) - 1)))
 , _needQuit(false)
-, _asyncRefCount(0)
+, _nextAsyncRequestId(0)
+, _asyncUploadBudgetBytes(0)
+, _asyncUploadBudgetSeconds(0.005f)
+, _asyncProgressiveUpload(false)
+, _transcoder(new TextureTranscoder())
 {
 }
 
@@ -73,8 +78,14 @@ TextureCache::~TextureCache()
 
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
+    for (auto texture : _uploadingTextures)
+        texture->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    for (auto thread : _loadingThreads)
+    {
+        CC_SAFE_DELETE(thread);
+    }
+    CC_SAFE_DELETE(_transcoder);
 }
 
 void TextureCache::destroyInstance()
@@ -96,6 +107,11 @@ std::string TextureCache::getDescription() const
 }
 
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, 0);
+}
+
+unsigned int TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -108,173 +124,247 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     if (texture != nullptr)
     {
         callback(texture);
-        return;
+        return 0;
     }
 
     // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
-
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-
-        _needQuit = false;
+    if (_loadingThreads.empty())
+    {
+        // create the threads to load images
+        startLoadingThreads();
     }
 
-    if (0 == _asyncRefCount)
+    if (_asyncRequests.empty() && _uploadingTextures.empty())
     {
         Director::getInstance()->getScheduler()->schedule(schedule_selector(TextureCache::addImageAsyncCallBack), this, 0, false);
     }
 
-    ++_asyncRefCount;
-
     // generate async struct
     AsyncStruct *data = new AsyncStruct(fullpath, callback);
+    if (++_nextAsyncRequestId == 0)
+        ++_nextAsyncRequestId;
+    data->id = _nextAsyncRequestId;
+    data->priority = priority;
+    _asyncRequests[data->id] = data;
 
-    // add async struct into queue
+    // add async struct into queue, after the ones of the same or higher priority
     _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
+    auto position = std::upper_bound(_asyncStructQueue.begin(), _asyncStructQueue.end(), priority, [](int p, const AsyncStruct* other) {
+        return p > other->priority;
+    });
+    _asyncStructQueue.insert(position, data);
     _asyncStructQueueMutex.unlock();
 
     _sleepCondition.notify_one();
+
+    return data->id;
+}
+
+void TextureCache::cancelImageAsync(unsigned int requestId)
+{
+    auto it = _asyncRequests.find(requestId);
+    if (it == _asyncRequests.end())
+        return;
+
+    AsyncStruct *asyncStruct = it->second;
+
+    _asyncStructQueueMutex.lock();
+    auto found = std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct);
+    bool waiting = (found != _asyncStructQueue.end());
+    if (waiting)
+    {
+        _asyncStructQueue.erase(found);
+    }
+    _asyncStructQueueMutex.unlock();
+
+    if (waiting)
+    {
+        _asyncRequests.erase(it);
+        delete asyncStruct;
+    }
+    else
+    {
+        // a loading thread has it, its image will be thrown away
+        asyncStruct->canceled = true;
+        asyncStruct->callback = nullptr;
+    }
+}
+
+void TextureCache::setAsyncWorkerCount(int count)
+{
+    CCASSERT(count > 0, "TextureCache needs a loading thread at least");
+    count = std::max(1, count);
+    if (count == _asyncWorkerCount)
+        return;
+
+    _asyncWorkerCount = count;
+    if (!_loadingThreads.empty())
+    {
+        // restart the threads, once they decoded their current images. The waiting requests stay queued
+        stopLoadingThreads();
+        startLoadingThreads();
+    }
+}
+
+void TextureCache::startLoadingThreads()
+{
+    _needQuit = false;
+    for (int i = 0; i < _asyncWorkerCount; ++i)
+    {
+        _loadingThreads.push_back(new std::thread(&TextureCache::loadImage, this));
+    }
+}
+
+void TextureCache::stopLoadingThreads()
+{
+    _asyncStructQueueMutex.lock();
+    _needQuit = true;
+    _asyncStructQueueMutex.unlock();
+    _sleepCondition.notify_all();
+    for (auto thread : _loadingThreads)
+    {
+        thread->join();
+        delete thread;
+    }
+    _loadingThreads.clear();
+}
+
+void TextureCache::setAsyncUploadBudget(size_t bytes, float seconds)
+{
+    _asyncUploadBudgetBytes = bytes;
+    _asyncUploadBudgetSeconds = seconds;
 }
 
 void TextureCache::unbindImageAsync(const std::string& filename)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    for (auto& request : _asyncRequests)
     {
-        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-        auto found = std::find_if(_imageInfoQueue->begin(), _imageInfoQueue->end(), [&fullpath](ImageInfo* ptr)->bool{ return ptr->asyncStruct->filename == fullpath; });
-        if (found != _imageInfoQueue->end())
+        if (request.second->filename == fullpath)
         {
-            (*found)->asyncStruct->callback = nullptr;
+            request.second->callback = nullptr;
         }
     }
-    _imageInfoMutex.unlock();
 }
 
 void TextureCache::unbindAllImageAsync()
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    for (auto& request : _asyncRequests)
     {
-        std::for_each(_imageInfoQueue->begin(), _imageInfoQueue->end(), [](ImageInfo* ptr) { ptr->asyncStruct->callback = nullptr; });
+        request.second->callback = nullptr;
     }
-    _imageInfoMutex.unlock();
 }
 
 void TextureCache::loadImage()
 {
-    AsyncStruct *asyncStruct = nullptr;
-
     while (true)
     {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
+        AsyncStruct *asyncStruct = nullptr;
         {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
+            std::unique_lock<std::mutex> lock(_asyncStructQueueMutex);
+            _sleepCondition.wait(lock, [this]() { return _needQuit || !_asyncStructQueue.empty(); });
+            if (_needQuit)
+            {
                 break;
             }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
-            }
+            asyncStruct = _asyncStructQueue.front();
+            _asyncStructQueue.pop_front();
         }
-        else
-        {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
 
-        Image *image = nullptr;
-        bool generateImage = false;
-
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
+        // generate image
+        const std::string& filename = asyncStruct->filename;
+        Image *image = new Image();
+        bool loaded = _transcoder->isEnabled() ? _transcoder->initImage(image, filename) : image->initWithImageFileThreadSafe(filename);
+        if (!loaded)
         {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename))
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos < infoSize)
-               generateImage = true;
+            CC_SAFE_RELEASE_NULL(image);
+            CCLOG("can not load %s", filename.c_str());
         }
 
-        if (generateImage)
-        {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
-            {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
-            }
-        }    
-
-        // generate image info
+        // generate image info, the cocos thread also releases the requests whose image failed, without calling their callback
         ImageInfo *imageInfo = new ImageInfo();
         imageInfo->asyncStruct = asyncStruct;
         imageInfo->image = image;
 
-        // put the image info into the queue
+        // put the image info into the queue, the cocos thread creates its texture
         _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
+        _imageInfoQueue.push_back(imageInfo);
         _imageInfoMutex.unlock();
     }
-    
-	if(_asyncStructQueue != nullptr)
-    {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
-    }
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
+    // the images are generated in the loading threads, create their textures within the budget of the frame
+    auto begin = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
+    auto outOfTime = [&]() {
+        return _asyncUploadBudgetSeconds > 0 &&
+            std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count() >= _asyncUploadBudgetSeconds;
+    };
 
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
+    // carry on with the textures uploaded progressively, the first ones being displayed first
+    while (!_uploadingTextures.empty())
     {
-        _imageInfoMutex.unlock();
+        Texture2D *texture = _uploadingTextures.front();
+        float seconds = _asyncUploadBudgetSeconds > 0
+            ? _asyncUploadBudgetSeconds - std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count()
+            : FLT_MAX;
+        texture->uploadProgressively(seconds);
+        if (texture->isReady())
+        {
+            texture->release();
+            _uploadingTextures.erase(_uploadingTextures.begin());
+        }
+        if (outOfTime())
+            break;
     }
-    else
+
+    // at least one texture per frame, unless the uploads used the budget
+    while (_uploadingTextures.empty() || !outOfTime())
     {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
+        _imageInfoMutex.lock();
+        if (_imageInfoQueue.empty())
+        {
+            _imageInfoMutex.unlock();
+            break;
+        }
+        ImageInfo *imageInfo = _imageInfoQueue.front();
+        _imageInfoQueue.pop_front();
         _imageInfoMutex.unlock();
 
         AsyncStruct *asyncStruct = imageInfo->asyncStruct;
         Image *image = imageInfo->image;
+        _asyncRequests.erase(asyncStruct->id);
 
         const std::string& filename = asyncStruct->filename;
 
         Texture2D *texture = nullptr;
-        if (image)
+        auto it = _textures.find(filename);
+        if (it != _textures.end())
+        {
+            // loaded meanwhile, by addImage() or another request
+            texture = it->second;
+        }
+        else if (image && !asyncStruct->canceled)
         {
             // generate texture in render thread
             texture = new Texture2D();
 
-            texture->initWithImage(image);
+            if (_asyncProgressiveUpload)
+            {
+                texture->initWithImageProgressively(image);
+                if (!texture->isReady())
+                {
+                    texture->retain();
+                    _uploadingTextures.push_back(texture);
+                }
+            }
+            else
+            {
+                texture->initWithImage(image);
+                uploadedBytes += static_cast<size_t>(image->getDataLen());
+            }
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
             // cache the texture file name
@@ -286,14 +376,9 @@ void TextureCache::addImageAsyncCallBack(float dt)
 
             texture->autorelease();
         }
-        else
-        {
-            auto it = _textures.find(asyncStruct->filename);
-            if(it != _textures.end())
-                texture = it->second;
-        }
         
-        if (asyncStruct->callback)
+        // as before the loading threads were pooled, the callback is not called when the image failed
+        if (asyncStruct->callback && texture)
         {
             asyncStruct->callback(texture);
         }
@@ -305,11 +390,15 @@ void TextureCache::addImageAsyncCallBack(float dt)
         delete asyncStruct;
         delete imageInfo;
 
-        --_asyncRefCount;
-        if (0 == _asyncRefCount)
-        {
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
-        }
+        if (_asyncUploadBudgetBytes > 0 && uploadedBytes >= _asyncUploadBudgetBytes)
+            break;
+        if (outOfTime())
+            break;
+    }
+
+    if (_asyncRequests.empty() && _uploadingTextures.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
     }
 }
 
@@ -338,7 +427,7 @@ Texture2D * TextureCache::addImage(const std::string &path)
             image = new Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = _transcoder->isEnabled() ? _transcoder->initImage(image, fullpath) : image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
 
             texture = new Texture2D();
@@ -429,7 +518,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             Image* image = new Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = _transcoder->isEnabled() ? _transcoder->initImage(image, fullpath) : image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
             
             ret = texture->initWithImage(image);
@@ -523,10 +612,28 @@ void TextureCache::reloadAllTextures()
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // notify sub threads to quit
+    stopLoadingThreads();
+
+    // drop the requests which weren't done
+    Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+    for (auto imageInfo : _imageInfoQueue)
+    {
+        CC_SAFE_RELEASE(imageInfo->image);
+        delete imageInfo;
+    }
+    _imageInfoQueue.clear();
+    _asyncStructQueue.clear();
+    for (auto& request : _asyncRequests)
+    {
+        delete request.second;
+    }
+    _asyncRequests.clear();
+    for (auto texture : _uploadingTextures)
+    {
+        texture->release();
+    }
+    _uploadingTextures.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
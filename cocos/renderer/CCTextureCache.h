@@ -32,14 +32,16 @@ THE SOFTWARE.
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include <queue>
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
+#include "renderer/CCTextureTranscoder.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "platform/CCImage.h"
@@ -114,10 +116,58 @@ public:
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+    * The callback is not called if the image can't be loaded.
     * Supported image extensions: .png, .jpg
     * @since v0.8
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
+
+    /* Like addImageAsync(filepath, callback), the images of higher priority being decoded first.
+    * Returns the id of the request, to cancel it, or 0 if the texture was already loaded and the callback called.
+    * @since v3.2
+    */
+    unsigned int addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
+    /* Cancels a request of addImageAsync: its callback won't be called, and the image isn't decoded
+    * if a loading thread hasn't started yet, or is thrown away without creating the texture otherwise.
+    * @since v3.2
+    */
+    void cancelImageAsync(unsigned int requestId);
+
+    /* Number of threads decoding the images of addImageAsync, at most 4 by default depending on the cores.
+    * If the threads are running, it waits for the images being decoded to restart them.
+    * @since v3.2
+    */
+    void setAsyncWorkerCount(int count);
+    int getAsyncWorkerCount() const { return _asyncWorkerCount; }
+
+    /* Limits the textures created per frame from the images decoded by addImageAsync, to avoid hitches.
+    * The textures are created until the bytes of their images reach "bytes", or "seconds" elapsed, and at least one per frame.
+    * 0 means no limit. By default, 5 ms per frame and no limit in bytes.
+    * @since v3.2
+    */
+    void setAsyncUploadBudget(size_t bytes, float seconds);
+    size_t getAsyncUploadBudgetBytes() const { return _asyncUploadBudgetBytes; }
+    float getAsyncUploadBudgetSeconds() const { return _asyncUploadBudgetSeconds; }
+
+    /* Creates the textures of addImageAsync with Texture2D::initWithImageProgressively(), so a big image is uploaded
+    * by strips of rows over several frames, within the time of the upload budget. The callbacks are called
+    * once the textures are created, and the sprites draw them when they are ready. Disabled by default.
+    * @since v3.2
+    */
+    void setAsyncProgressiveUpload(bool enabled) { _asyncProgressiveUpload = enabled; }
+    bool isAsyncProgressiveUpload() const { return _asyncProgressiveUpload; }
+
+    /* Number of pending requests of addImageAsync: queued, being decoded, or waiting for their texture to be created.
+    * @since v3.2
+    */
+    ssize_t getAsyncRequestCount() const { return _asyncRequests.size(); }
+
+    /* The transcoder of the images loaded by addImage and addImageAsync, which saves them in a format ready to upload
+    * on their first load. Disabled by default, see TextureTranscoder::setEnabled.
+    * @since v3.2
+    */
+    TextureTranscoder* getTranscoder() const { return _transcoder; }
     
     /* Unbind a specified bound image asynchronous callback
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
@@ -192,15 +242,21 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void startLoadingThreads();
+    void stopLoadingThreads();
 
 public:
     struct AsyncStruct
     {
     public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
+        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), id(0), priority(0), canceled(false) {}
 
         std::string filename;
         std::function<void(Texture2D*)> callback;
+        unsigned int id;
+        int priority;
+        // only used by the cocos thread, a loading thread may be decoding the image
+        bool canceled;
     };
 
 protected:
@@ -210,20 +266,31 @@ protected:
         Image        *image;
     } ImageInfo;
     
-    std::thread* _loadingThread;
+    std::vector<std::thread*> _loadingThreads;
+    int _asyncWorkerCount;
 
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
+    // requests waiting for a loading thread, by decreasing priority
+    std::deque<AsyncStruct*> _asyncStructQueue;
+    // decoded images waiting for their textures
+    std::deque<ImageInfo*> _imageInfoQueue;
 
     std::mutex _asyncStructQueueMutex;
     std::mutex _imageInfoMutex;
 
-    std::mutex _sleepMutex;
     std::condition_variable _sleepCondition;
 
     bool _needQuit;
 
-    int _asyncRefCount;
+    // the pending requests, used by the cocos thread
+    std::unordered_map<unsigned int, AsyncStruct*> _asyncRequests;
+    unsigned int _nextAsyncRequestId;
+    size_t _asyncUploadBudgetBytes;
+    float _asyncUploadBudgetSeconds;
+    bool _asyncProgressiveUpload;
+    // the textures of addImageAsync being uploaded progressively, retained
+    std::vector<Texture2D*> _uploadingTextures;
+
+    TextureTranscoder* _transcoder;
 
     std::unordered_map<std::string, Texture2D*> _textures;
 };
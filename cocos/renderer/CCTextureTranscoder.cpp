@@ -0,0 +1,374 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCTextureTranscoder.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <io.h>
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#include <unistd.h>
+#endif
+
+#include "base/ccMacros.h"
+#include "base/CCConfiguration.h"
+#include "base/etc1.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+// the header of the raw files, followed by the pixels
+struct RawHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t pixelFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+};
+
+const char RAW_MAGIC[4] = { 'C', 'C', 'T', 'X' };
+// change it when the format of the files or the transcoding change, to ignore the old files
+const uint32_t TRANSCODER_VERSION = 1;
+const uint32_t FLAG_PREMULTIPLIED_ALPHA = 1 << 0;
+const uint32_t FLAG_HAS_PREMULTIPLIED_ALPHA = 1 << 1;
+
+// FNV-1a
+uint64_t hashBytes(const unsigned char* bytes, ssize_t size, uint64_t hash = 14695981039346656037ULL)
+{
+    for (ssize_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// the transcoded files are written by the transcoder itself, so they are always mapped when the platform can
+Data readFile(const std::string& path)
+{
+    Data mapped = Data::mapFile(path);
+    if (!mapped.isNull())
+        return mapped;
+
+    Data data;
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (fp == nullptr)
+        return data;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size > 0)
+    {
+        unsigned char* buffer = static_cast<unsigned char*>(malloc(size));
+        if (buffer && fread(buffer, 1, size, fp) == static_cast<size_t>(size))
+        {
+            data.fastSet(buffer, size);
+        }
+        else
+        {
+            free(buffer);
+        }
+    }
+    fclose(fp);
+    return data;
+}
+
+// writes a temporary file renamed at the end, so the other threads never read a partial file
+bool writeFile(const std::string& path, const void* header, size_t headerSize, const unsigned char* data, size_t dataSize)
+{
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%llx.tmp", static_cast<unsigned long long>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    std::string temporaryPath = path + suffix;
+
+    FILE* fp = fopen(temporaryPath.c_str(), "wb");
+    if (fp == nullptr)
+        return false;
+
+    bool written = fwrite(header, 1, headerSize, fp) == headerSize && fwrite(data, 1, dataSize, fp) == dataSize;
+    // on the disk before the rename, so a power loss can't leave a truncated file under the final name
+    written = written && fflush(fp) == 0;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    written = written && _commit(_fileno(fp)) == 0;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    written = written && fsync(fileno(fp)) == 0;
+#endif
+    written = (fclose(fp) == 0) && written;
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool isOpaque(Image* image)
+{
+    switch (image->getRenderFormat())
+    {
+    case Texture2D::PixelFormat::RGB888:
+        return true;
+    case Texture2D::PixelFormat::RGBA8888:
+        {
+            const unsigned char* data = image->getData();
+            for (ssize_t i = 3; i < image->getDataLen(); i += 4)
+            {
+                if (data[i] != 0xFF)
+                    return false;
+            }
+            return true;
+        }
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+TextureTranscoder::TextureTranscoder()
+: _enabled(false)
+, _etc1Enabled(true)
+{
+    resetStatistics();
+}
+
+void TextureTranscoder::setEnabled(bool enabled)
+{
+    if (enabled && _cacheDirectory.empty())
+    {
+        _cacheDirectory = FileUtils::getInstance()->getWritablePath();
+    }
+    _enabled = enabled;
+}
+
+void TextureTranscoder::setCacheDirectory(const std::string& directory)
+{
+    _cacheDirectory = directory;
+    if (!_cacheDirectory.empty() && _cacheDirectory.back() != '/')
+    {
+        _cacheDirectory += '/';
+    }
+}
+
+std::string TextureTranscoder::getTranscodedPath(const Data& source, const char* extension) const
+{
+    // the files depend on the image, and on the pixel format it is converted to
+    uint32_t settings[2] = { TRANSCODER_VERSION, static_cast<uint32_t>(Texture2D::getDefaultAlphaPixelFormat()) };
+    uint64_t hash = hashBytes(source.getBytes(), source.getSize());
+    hash = hashBytes(reinterpret_cast<const unsigned char*>(settings), sizeof(settings), hash);
+
+    char name[64];
+    snprintf(name, sizeof(name), "cc_transcoded_%016llx.%s", static_cast<unsigned long long>(hash), extension);
+    return _cacheDirectory + name;
+}
+
+bool TextureTranscoder::initImage(Image* image, const std::string& fullPath)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    Data source = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
+    if (source.isNull())
+        return false;
+
+    image->_filePath = fullPath;
+
+    if (initImageWithTranscodedFile(image, getTranscodedPath(source, "pkm")) ||
+        initImageWithTranscodedFile(image, getTranscodedPath(source, "cctx")))
+    {
+        addStatistics(true, false, std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count());
+        return true;
+    }
+
+    if (!image->initWithImageData(source.getBytes(), source.getSize()))
+        return false;
+
+    // the images compressed for the GPU are uploaded as they are
+    bool transcoded = !image->isCompressed() && image->getNumberOfMipmaps() <= 1 && transcode(image, source);
+    addStatistics(false, transcoded, std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count());
+    return true;
+}
+
+bool TextureTranscoder::initImageWithTranscodedFile(Image* image, const std::string& path)
+{
+    Data data = readFile(path);
+    if (data.isNull())
+        return false;
+
+    // the files may be corrupted or truncated: the ones which don't match their header are removed, and the source is decoded again
+    if (data.getSize() >= ETC_PKM_HEADER_SIZE && etc1_pkm_is_valid(data.getBytes()))
+    {
+        etc1_uint32 width = etc1_pkm_get_width(data.getBytes());
+        etc1_uint32 height = etc1_pkm_get_height(data.getBytes());
+        if (width == 0 || height == 0 ||
+            static_cast<size_t>(data.getSize() - ETC_PKM_HEADER_SIZE) != etc1_get_encoded_data_size(width, height))
+        {
+            CCLOG("TextureTranscoder: removing the invalid file %s", path.c_str());
+            data.clear();
+            remove(path.c_str());
+            return false;
+        }
+        return image->initWithImageData(data.getBytes(), data.getSize());
+    }
+
+    RawHeader header;
+    if (data.getSize() < static_cast<ssize_t>(sizeof(header)))
+        return false;
+    memcpy(&header, data.getBytes(), sizeof(header));
+    ssize_t dataLen = data.getSize() - sizeof(header);
+    if (memcmp(header.magic, RAW_MAGIC, sizeof(RAW_MAGIC)) != 0 || header.version != TRANSCODER_VERSION)
+        return false;
+
+    const auto& formats = Texture2D::getPixelFormatInfoMap();
+    auto format = formats.find(static_cast<Texture2D::PixelFormat>(header.pixelFormat));
+    if (header.width == 0 || header.height == 0 || format == formats.end() || format->second.compressed ||
+        static_cast<uint64_t>(dataLen) * 8 != static_cast<uint64_t>(header.width) * header.height * format->second.bpp)
+    {
+        CCLOG("TextureTranscoder: removing the invalid file %s", path.c_str());
+        // unmapped first, Windows can't remove a mapped file
+        data.clear();
+        remove(path.c_str());
+        return false;
+    }
+
+    image->_data = static_cast<unsigned char*>(malloc(dataLen));
+    if (image->_data == nullptr)
+        return false;
+    memcpy(image->_data, data.getBytes() + sizeof(header), dataLen);
+    image->_dataLen = dataLen;
+    image->_width = header.width;
+    image->_height = header.height;
+    image->_renderFormat = static_cast<Texture2D::PixelFormat>(header.pixelFormat);
+    image->_fileType = Image::Format::RAW_DATA;
+    image->_preMulti = (header.flags & FLAG_PREMULTIPLIED_ALPHA) != 0;
+    image->_hasPremultipliedAlpha = (header.flags & FLAG_HAS_PREMULTIPLIED_ALPHA) != 0;
+    return true;
+}
+
+bool TextureTranscoder::transcode(Image* image, const Data& source)
+{
+    int width = image->getWidth();
+    int height = image->getHeight();
+
+    if (_etc1Enabled && Configuration::getInstance()->supportsETC() && isOpaque(image))
+    {
+        // ETC1 encodes RGB888
+        const unsigned char* pixels = image->getData();
+        unsigned char* rgb = nullptr;
+        if (image->getRenderFormat() == Texture2D::PixelFormat::RGBA8888)
+        {
+            rgb = static_cast<unsigned char*>(malloc(width * height * 3));
+            for (ssize_t i = 0, j = 0; i < image->getDataLen(); i += 4, j += 3)
+            {
+                rgb[j] = pixels[i];
+                rgb[j + 1] = pixels[i + 1];
+                rgb[j + 2] = pixels[i + 2];
+            }
+            pixels = rgb;
+        }
+
+        etc1_uint32 encodedSize = etc1_get_encoded_data_size(width, height);
+        etc1_byte* encoded = static_cast<etc1_byte*>(malloc(encodedSize));
+        etc1_byte header[ETC_PKM_HEADER_SIZE];
+        etc1_pkm_format_header(header, width, height);
+        bool written = etc1_encode_image(pixels, width, height, 3, width * 3, encoded) == 0 &&
+            writeFile(getTranscodedPath(source, "pkm"), header, sizeof(header), encoded, encodedSize);
+        free(encoded);
+        free(rgb);
+        return written;
+    }
+
+    // the raw pixels, in the format they are uploaded in
+    unsigned char* outData = nullptr;
+    ssize_t outDataLen = 0;
+    Texture2D::PixelFormat format = Texture2D::convertDataToFormat(image->getData(), image->getDataLen(), image->getRenderFormat(),
+                                                                   Texture2D::getDefaultAlphaPixelFormat(), &outData, &outDataLen, width);
+    RawHeader header;
+    memcpy(header.magic, RAW_MAGIC, sizeof(RAW_MAGIC));
+    header.version = TRANSCODER_VERSION;
+    header.pixelFormat = static_cast<uint32_t>(format);
+    header.width = width;
+    header.height = height;
+    header.flags = (image->isPremultipliedAlpha() ? FLAG_PREMULTIPLIED_ALPHA : 0) | (image->hasPremultipliedAlpha() ? FLAG_HAS_PREMULTIPLIED_ALPHA : 0);
+    bool written = writeFile(getTranscodedPath(source, "cctx"), &header, sizeof(header), outData, outDataLen);
+
+    if (outData != image->getData())
+    {
+        free(outData);
+    }
+    return written;
+}
+
+void TextureTranscoder::removeTranscodedFiles(const std::string& fullPath)
+{
+    Data source = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
+    if (source.isNull())
+        return;
+
+    remove(getTranscodedPath(source, "pkm").c_str());
+    remove(getTranscodedPath(source, "cctx").c_str());
+}
+
+void TextureTranscoder::addStatistics(bool hit, bool transcoded, float seconds)
+{
+    std::lock_guard<std::mutex> lock(_statisticsMutex);
+    if (hit)
+    {
+        ++_statistics.hits;
+        _statistics.hitSeconds += seconds;
+    }
+    else
+    {
+        ++_statistics.misses;
+        _statistics.missSeconds += seconds;
+    }
+    if (transcoded)
+    {
+        ++_statistics.transcoded;
+    }
+}
+
+TextureTranscoder::Statistics TextureTranscoder::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_statisticsMutex);
+    return _statistics;
+}
+
+void TextureTranscoder::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_statisticsMutex);
+    memset(&_statistics, 0, sizeof(_statistics));
+}
+
+NS_CC_END
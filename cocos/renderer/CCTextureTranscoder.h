@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTEXTURE_TRANSCODER_H__
+#define __CCTEXTURE_TRANSCODER_H__
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "base/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Saves the images loaded by TextureCache in a format ready to upload, so the next launches skip decoding them.
+
+ On the first load of an image, the opaque ones become ETC1 when the GPU supports it, the other ones are saved
+ as raw pixels already converted to the default pixel format of Texture2D. The files are written in the cache directory,
+ named after the hash of the content of the image, so a modified image is transcoded again.
+ The images which are already compressed for the GPU are loaded as usual.
+ @since v3.2
+ */
+class CC_DLL TextureTranscoder
+{
+public:
+    struct Statistics
+    {
+        /** loads from a transcoded file */
+        unsigned int hits;
+        /** loads which decoded the image, transcoding it or not */
+        unsigned int misses;
+        /** files written */
+        unsigned int transcoded;
+        float hitSeconds;
+        float missSeconds;
+    };
+
+    TextureTranscoder();
+
+    /** Disabled by default. Enabling it uses the writable path if no cache directory was set */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /** The existing directory of the transcoded files, ending with '/'. Set it before loading images */
+    void setCacheDirectory(const std::string& directory);
+    const std::string& getCacheDirectory() const { return _cacheDirectory; }
+
+    /** Whether the opaque images are transcoded to ETC1 when the GPU supports it. Enabled by default */
+    void setETC1Enabled(bool enabled) { _etc1Enabled = enabled; }
+    bool isETC1Enabled() const { return _etc1Enabled; }
+
+    /** Initializes the image from the transcoded file of the image at fullPath, or decodes it and writes that file.
+     It can be called by the loading threads of TextureCache.
+     */
+    bool initImage(Image* image, const std::string& fullPath);
+
+    /** Deletes the transcoded files of the image at fullPath */
+    void removeTranscodedFiles(const std::string& fullPath);
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    std::string getTranscodedPath(const Data& source, const char* extension) const;
+    bool initImageWithTranscodedFile(Image* image, const std::string& path);
+    bool transcode(Image* image, const Data& source);
+    void addStatistics(bool hit, bool transcoded, float seconds);
+
+    std::atomic<bool> _enabled;
+    bool _etc1Enabled;
+    std::string _cacheDirectory;
+
+    mutable std::mutex _statisticsMutex;
+    Statistics _statistics;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(TextureTranscoder);
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTEXTURE_TRANSCODER_H__
@@ -287,8 +287,7 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, bool
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
     
     int i = 0;      // used by _children
     int j = 0;      // used by _protectedChildren
@@ -336,7 +335,7 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, bool
     // reset for next frame
     _orderOfArrival = 0;
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 
 void ProtectedNode::onEnter()
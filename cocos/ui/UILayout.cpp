@@ -232,8 +232,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransfor
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
     //Add group command
 
     _groupCommand.init(_globalZOrder);
@@ -301,7 +300,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransfor
     
     renderer->popGroup();
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
     
 void Layout::onBeforeVisitStencil()
@@ -381,6 +381,12 @@ void Slider::setPercent(int percent)
     }
 }
     
+bool Slider::isHitTestInContentRect() const
+{
+    // The ball can stick out of the bar
+    return false;
+}
+
 bool Slider::hitTest(const cocos2d::Vec2 &pt)
 {
     Vec2 nsp = this->_slidBallNormalRenderer->convertToNodeSpace(pt);
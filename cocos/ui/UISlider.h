@@ -200,6 +200,7 @@ public:
     
     //override the widget's hitTest function to perfom its own
     virtual bool hitTest(const Vec2 &pt) override;
+    virtual bool isHitTestInContentRect() const override;
     /**
      * Returns the "class name" of widget.
      */
@@ -436,6 +436,12 @@ void TextField::setTouchAreaEnabled(bool enable)
     _useTouchArea = enable;
 }
     
+bool TextField::isHitTestInContentRect() const
+{
+    // The touch area can be enabled after the touch listener was created
+    return false;
+}
+
 bool TextField::hitTest(const Vec2 &pt)
 {
     if (_useTouchArea)
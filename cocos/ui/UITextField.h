@@ -130,6 +130,7 @@ public:
     Size getTouchSize()const;
     void setTouchAreaEnabled(bool enable);
     virtual bool hitTest(const Vec2 &pt);
+    virtual bool isHitTestInContentRect() const override;
     
     void setPlaceHolder(const std::string& value);
     const std::string& getPlaceHolder()const;
@@ -262,8 +262,7 @@ void VideoPlayer::drawDebugData()
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
 
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewMatrix(_modelViewTransform);
 
     auto size = getContentSize();
 
@@ -277,7 +276,7 @@ void VideoPlayer::drawDebugData()
 
     DrawPrimitives::drawPoly(vertices, 4, true);
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewMatrix();
 }
 #endif
 
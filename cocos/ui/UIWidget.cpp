@@ -208,6 +208,11 @@ bool Widget::init()
         setBright(true);
         ignoreContentAdaptWithSize(true);
         setAnchorPoint(Vec2(0.5f, 0.5f));
+        if (_touchListener)
+        {
+            // The constructor can't ask the subclass
+            _touchListener->setContentHitTest(isHitTestInContentRect());
+        }
         return true;
     }
     return false;
@@ -521,6 +526,7 @@ void Widget::setTouchEnabled(bool enable)
         _touchListener = EventListenerTouchOneByOne::create();
         CC_SAFE_RETAIN(_touchListener);
         _touchListener->setSwallowTouches(true);
+        _touchListener->setContentHitTest(isHitTestInContentRect());
         _touchListener->onTouchBegan = CC_CALLBACK_2(Widget::onTouchBegan, this);
         _touchListener->onTouchMoved = CC_CALLBACK_2(Widget::onTouchMoved, this);
         _touchListener->onTouchEnded = CC_CALLBACK_2(Widget::onTouchEnded, this);
@@ -799,6 +805,11 @@ void Widget::addTouchEventListener(Widget::ccWidgetTouchCallback callback)
     this->_touchEventCallback = callback;
 }
 
+bool Widget::isHitTestInContentRect() const
+{
+    return true;
+}
+
 bool Widget::hitTest(const Vec2 &pt)
 {
     Vec2 nsp = convertToNodeSpace(pt);
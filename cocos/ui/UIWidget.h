@@ -454,6 +454,13 @@ public:
      */
     virtual bool hitTest(const Vec2 &pt);
     
+    /**
+     * Checks whether hitTest only accepts points inside the content rect of the widget.
+     * The touch listener of the widget is then kept in the touch index of EventDispatcher, if it's enabled.
+     * Widgets which override hitTest with a different area have to return false.
+     */
+    virtual bool isHitTestInContentRect() const;
+    
     /*
      * Sends the touch event to widget's parent
      * @param  event  the touch event type, it could be BEGAN/MOVED/CANCELED/ENDED
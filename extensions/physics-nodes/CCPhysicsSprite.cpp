@@ -39,7 +39,10 @@ PhysicsSprite::PhysicsSprite()
 , _CPBody(nullptr)
 , _pB2Body(nullptr)
 , _PTMRatio(0.0f)
-{}
+{
+    // the transform follows the body, which the setters don't know about
+    setTransformVolatile(true);
+}
 
 PhysicsSprite* PhysicsSprite::create()
 {
@@ -40,7 +40,13 @@ static std::function<Layer*()> createFunctions[] =
     CL(NewDrawNodeTest),
     CL(NewCullingTest),
     CL(VBOFullTest),
-    CL(CaptureScreenTest)
+    CL(CaptureScreenTest),
+    CL(MaterialSortTest),
+    CL(StreamingVBOTest),
+    CL(StreamingVBOMockTest),
+    CL(HierarchicalCullingTest),
+    CL(HierarchicalCullingBoundsTest),
+    CL(ConcurrentVisitTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -628,3 +634,454 @@ void CaptureScreenTest::afterCaptured(bool succeed, const std::string& outputFil
         log("Capture screen failed.");
     }
 }
+
+// Wraps its children in a GroupCommand so they are sorted in their own render queue
+class OrderIndependentGroup : public Node
+{
+public:
+    CREATE_FUNC(OrderIndependentGroup);
+
+    virtual void visit(Renderer *renderer, const Mat4& parentTransform, bool parentTransformUpdated) override
+    {
+        _groupCommand.init(_globalZOrder);
+        renderer->addCommand(&_groupCommand);
+        renderer->pushGroup(_groupCommand.getRenderQueueID());
+        Node::visit(renderer, parentTransform, parentTransformUpdated);
+        renderer->popGroup();
+    }
+
+    void setOrderIndependent(bool orderIndependent) { _groupCommand.setOrderIndependent(orderIndependent); }
+
+protected:
+    GroupCommand _groupCommand;
+};
+
+MaterialSortTest::MaterialSortTest()
+: _orderIndependent(true)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    auto group = OrderIndependentGroup::create();
+    group->setOrderIndependent(_orderIndependent);
+    addChild(group, 0, kTagContentNode);
+
+    // interleave sprites of two different textures, so without sorting every sprite is a batch
+    for (int i = 0; i < 200; ++i)
+    {
+        auto sprite = Sprite::create((i % 2) ? "Images/grossini.png" : "Images/grossinis_sister1.png");
+        sprite->setScale(0.3f);
+        sprite->setPosition(Vec2((i % 20 + 0.5f) * s.width / 20, (i / 20 + 0.5f) * s.height / 10));
+        group->addChild(sprite);
+    }
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "toggle order independent");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(MaterialSortTest::onToggle, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(s.width / 2, s.height / 4);
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "");
+    _statsLabel->setPosition(s.width / 2, s.height / 4 - 40);
+    addChild(_statsLabel, 1);
+
+    scheduleUpdate();
+}
+
+MaterialSortTest::~MaterialSortTest()
+{
+}
+
+void MaterialSortTest::onToggle(Ref* sender)
+{
+    _orderIndependent = !_orderIndependent;
+    static_cast<OrderIndependentGroup*>(getChildByTag(kTagContentNode))->setOrderIndependent(_orderIndependent);
+}
+
+void MaterialSortTest::update(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    _statsLabel->setString(StringUtils::format("order independent: %s  draw calls: %d  saved batches: %d",
+                                               _orderIndependent ? "on" : "off",
+                                               (int)renderer->getDrawnBatches(),
+                                               (int)renderer->getSavedBatches()));
+}
+
+std::string MaterialSortTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string MaterialSortTest::subtitle() const
+{
+    return "Material sort: interleaved sprites of two textures should be drawn in a few batches";
+}
+
+StreamingVBOTest::StreamingVBOTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // every DrawNode is a custom command that interrupts the quad batch, so the quads are flushed many times per frame
+    for (int i = 0; i < 40; ++i)
+    {
+        for (int j = 0; j < 50; ++j)
+        {
+            auto sprite = Sprite::create("Images/grossini_dance_01.png");
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            addChild(sprite);
+        }
+
+        auto draw = DrawNode::create();
+        draw->drawDot(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height), 5, Color4F(1, 0, 0, 1));
+        addChild(draw);
+    }
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "toggle batch size");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(StreamingVBOTest::onToggleBatchSize, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(s.width / 2, s.height / 4);
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "", TextHAlignment::CENTER);
+    _statsLabel->setPosition(s.width / 2, s.height / 4 - 50);
+    addChild(_statsLabel, 1);
+
+    StreamingVertexBuffer::resetGlobalStats();
+    scheduleUpdate();
+}
+
+StreamingVBOTest::~StreamingVBOTest()
+{
+    Director::getInstance()->getRenderer()->setQuadBatchSize(Renderer::VBO_SIZE);
+}
+
+void StreamingVBOTest::onToggleBatchSize(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setQuadBatchSize(renderer->getQuadBatchSize() == Renderer::VBO_SIZE ? Renderer::MAX_QUAD_BATCH_SIZE : Renderer::VBO_SIZE);
+}
+
+void StreamingVBOTest::update(float dt)
+{
+    // the stats are the ones of the last frame
+    auto& stats = StreamingVertexBuffer::getGlobalStats();
+    _statsLabel->setString(StringUtils::format("batch size: %d  draw calls: %d\nglBufferData: %u  glBufferSubData: %u  glMapBufferRange: %u  wraps: %u  KB: %d",
+                                               Director::getInstance()->getRenderer()->getQuadBatchSize(),
+                                               (int)Director::getInstance()->getRenderer()->getDrawnBatches(),
+                                               stats.bufferDataCalls,
+                                               stats.bufferSubDataCalls,
+                                               stats.mapBufferRangeCalls,
+                                               stats.wraps,
+                                               (int)(stats.uploadedBytes / 1024)));
+    StreamingVertexBuffer::resetGlobalStats();
+}
+
+std::string StreamingVBOTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string StreamingVBOTest::subtitle() const
+{
+    return "Streaming VBO: quads are appended to a ring buffer, it should be orphaned rarely";
+}
+
+// a ring buffer that keeps its storage in memory instead of issuing GL calls
+class MockStreamingVertexBuffer : public StreamingVertexBuffer
+{
+public:
+    MockStreamingVertexBuffer(int* deletedBuffers)
+    : _deletedBuffers(deletedBuffers)
+    {
+    }
+
+    virtual ~MockStreamingVertexBuffer()
+    {
+        releaseBuffer();
+    }
+
+    const unsigned char* getStorage() const { return _storage.data(); }
+
+protected:
+    virtual GLuint createBuffer() override { return 1; }
+    virtual void deleteBuffer(GLuint name) override { (*_deletedBuffers)++; }
+    virtual void bindBuffer(GLuint name) override {}
+
+    virtual void allocateStorage(size_t size) override
+    {
+        _storage.assign(size, 0);
+        countBufferData();
+    }
+
+    virtual void writeStorage(size_t offset, const void* data, size_t size) override
+    {
+        memcpy(_storage.data() + offset, data, size);
+        countBufferSubData();
+    }
+
+    std::vector<unsigned char> _storage;
+    int* _deletedBuffers;
+};
+
+StreamingVBOMockTest::StreamingVBOMockTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    std::string result = runChecks();
+    log("StreamingVBOMockTest: %s", result.c_str());
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), result, TextHAlignment::CENTER);
+    label->setPosition(s.width / 2, s.height / 2);
+    addChild(label, 1);
+}
+
+StreamingVBOMockTest::~StreamingVBOMockTest()
+{
+}
+
+std::string StreamingVBOMockTest::runChecks()
+{
+    const size_t capacity = 1024;
+    const size_t chunkSize = 100;
+    const int chunks = 20;
+
+    int deletedBuffers = 0;
+    {
+        MockStreamingVertexBuffer buffer(&deletedBuffers);
+        buffer.init(capacity);
+        buffer.setMapBufferRangeEnabled(false);
+
+        for (int i = 0; i < chunks; ++i)
+        {
+            unsigned char chunk[chunkSize];
+            memset(chunk, i + 1, chunkSize);
+            size_t offset = buffer.upload(chunk, chunkSize);
+
+            if (offset % StreamingVertexBuffer::ALIGNMENT != 0 || offset + chunkSize > capacity)
+                return StringUtils::format("FAILED: chunk %d written at offset %d", i, (int)offset);
+            if (memcmp(buffer.getStorage() + offset, chunk, chunkSize) != 0)
+                return StringUtils::format("FAILED: chunk %d is not in the storage", i);
+        }
+
+        // 100 bytes chunks are written every 112 bytes: 9 of them fit in 1024 bytes
+        auto& stats = buffer.getStats();
+        if (stats.wraps != 2 || stats.bufferDataCalls != 3 || stats.bufferSubDataCalls != chunks || stats.uploadedBytes != chunks * chunkSize)
+            return StringUtils::format("FAILED: wraps: %u  glBufferData: %u  glBufferSubData: %u",
+                                       stats.wraps, stats.bufferDataCalls, stats.bufferSubDataCalls);
+    }
+
+    if (deletedBuffers != 1)
+        return StringUtils::format("FAILED: %d buffers deleted", deletedBuffers);
+
+    return "PASSED: offsets, wraps, GL call counts and buffer deletion";
+}
+
+std::string StreamingVBOMockTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string StreamingVBOMockTest::subtitle() const
+{
+    return "Streaming VBO without GL: a mock buffer checks the ring, see console";
+}
+
+HierarchicalCullingTest::HierarchicalCullingTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // a map 10x10 screens big, made of rows of tiles, scrolling back and forth
+    _map = Node::create();
+    _map->setCullingEnabled(true);
+    addChild(_map);
+
+    const int rows = 100;
+    const int columns = 100;
+    const float tileWidth = s.width / 10;
+    const float tileHeight = s.height / 10;
+    for (int row = 0; row < rows; ++row)
+    {
+        auto rowNode = Node::create();
+        rowNode->setPosition(Vec2(0, row * tileHeight));
+        _map->addChild(rowNode);
+
+        for (int column = 0; column < columns; ++column)
+        {
+            auto tile = Sprite::create("Images/grossini_dance_01.png");
+            tile->setScale(tileHeight / tile->getContentSize().height);
+            tile->setPosition(Vec2((column + 0.5f) * tileWidth, tileHeight / 2));
+            rowNode->addChild(tile);
+        }
+    }
+
+    auto scroll = MoveBy::create(10, Vec2(-tileWidth * (columns - 10), -tileHeight * (rows - 10)));
+    _map->runAction(RepeatForever::create(Sequence::create(scroll, scroll->reverse(), nullptr)));
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "toggle culling");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(HierarchicalCullingTest::onToggleCulling, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(s.width / 2, s.height / 4);
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "");
+    _statsLabel->setPosition(s.width / 2, s.height / 4 - 40);
+    addChild(_statsLabel, 1);
+
+    scheduleUpdate();
+}
+
+HierarchicalCullingTest::~HierarchicalCullingTest()
+{
+}
+
+void HierarchicalCullingTest::onToggleCulling(Ref* sender)
+{
+    _map->setCullingEnabled(!_map->isCullingEnabled());
+}
+
+void HierarchicalCullingTest::update(float dt)
+{
+    _statsLabel->setString(StringUtils::format("culling: %s  culled nodes: %d",
+                                               _map->isCullingEnabled() ? "on" : "off",
+                                               (int)Director::getInstance()->getRenderer()->getCulledNodes()));
+}
+
+std::string HierarchicalCullingTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string HierarchicalCullingTest::subtitle() const
+{
+    return "Hierarchical culling: 10000 tiles, the rows outside of the screen are not visited";
+}
+
+HierarchicalCullingBoundsTest::HierarchicalCullingBoundsTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    std::string result = runChecks();
+    log("HierarchicalCullingBoundsTest: %s", result.c_str());
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), result, TextHAlignment::CENTER);
+    label->setPosition(s.width / 2, s.height / 2);
+    addChild(label, 1);
+}
+
+HierarchicalCullingBoundsTest::~HierarchicalCullingBoundsTest()
+{
+}
+
+std::string HierarchicalCullingBoundsTest::runChecks()
+{
+    auto parent = Node::create();
+    auto child = Node::create();
+    child->setContentSize(Size(10, 10));
+    parent->addChild(child);
+
+    if (!parent->getSubtreeBoundingBox().equals(Rect(0, 0, 10, 10)))
+        return "FAILED: the subtree box of the parent doesn't contain the child";
+
+    // the parent box is computed while the child is hidden, then the child moves and shows up again
+    child->setVisible(false);
+    if (!parent->getSubtreeBoundingBox().equals(Rect::ZERO))
+        return "FAILED: the subtree box of the parent contains the hidden child";
+
+    child->setPosition(Vec2(100, 50));
+    child->setVisible(true);
+    const Rect& bounds = parent->getSubtreeBoundingBox();
+    if (!bounds.equals(Rect(100, 50, 10, 10)))
+        return StringUtils::format("FAILED: the subtree box of the parent is (%g, %g, %g, %g) after showing the child",
+                                   bounds.origin.x, bounds.origin.y, bounds.size.width, bounds.size.height);
+
+    // same with a change deeper in the hidden subtree
+    auto grandChild = Node::create();
+    grandChild->setContentSize(Size(10, 10));
+    child->addChild(grandChild);
+    child->setVisible(false);
+    parent->getSubtreeBoundingBox();
+    grandChild->setPosition(Vec2(20, 0));
+    child->setVisible(true);
+    if (!parent->getSubtreeBoundingBox().equals(Rect(100, 50, 30, 10)))
+        return "FAILED: the subtree box of the parent misses a node moved while hidden";
+
+    return "PASSED: nodes moved while hidden are in the subtree box once shown";
+}
+
+std::string HierarchicalCullingBoundsTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string HierarchicalCullingBoundsTest::subtitle() const
+{
+    return "Hierarchical culling: the subtree boxes follow the nodes moved while hidden, see console";
+}
+
+ConcurrentVisitTest::ConcurrentVisitTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // rotating layers of sprites: their transforms are updated every frame. Every layer is visited by a worker thread,
+    // and the layers overlap, so their commands must be drawn in the same order as on the main thread
+    const int layers = 8;
+    const int spritesPerLayer = 500;
+    for (int i = 0; i < layers; ++i)
+    {
+        auto layer = Node::create();
+        layer->setConcurrentVisitEnabled(true);
+        layer->setPosition(Vec2(s.width / 2, s.height / 2));
+        addChild(layer, i % 2 ? -1 : 0);
+
+        for (int j = 0; j < spritesPerLayer; ++j)
+        {
+            auto sprite = Sprite::create(i % 2 ? "Images/grossini_dance_01.png" : "Images/grossini_dance_02.png");
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2((CCRANDOM_0_1() - 0.5f) * s.width, (CCRANDOM_0_1() - 0.5f) * s.height));
+            sprite->runAction(RepeatForever::create(RotateBy::create(1 + CCRANDOM_0_1(), 360)));
+            layer->addChild(sprite, j % 3 - 1);
+        }
+
+        layer->runAction(RepeatForever::create(RotateBy::create(5 + i, i % 2 ? 30 : -30)));
+    }
+
+    auto label = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "toggle visit threads");
+    auto item = MenuItemLabel::create(label, CC_CALLBACK_1(ConcurrentVisitTest::onToggleThreads, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(s.width / 2, s.height / 4);
+    addChild(menu, 1);
+
+    _statsLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "");
+    _statsLabel->setPosition(s.width / 2, s.height / 4 - 40);
+    addChild(_statsLabel, 1);
+
+    scheduleUpdate();
+}
+
+ConcurrentVisitTest::~ConcurrentVisitTest()
+{
+    Director::getInstance()->getRenderer()->setVisitThreadCount(0);
+}
+
+void ConcurrentVisitTest::onToggleThreads(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setVisitThreadCount(renderer->getVisitThreadCount() > 0 ? 0 : 4);
+}
+
+void ConcurrentVisitTest::update(float dt)
+{
+    _statsLabel->setString(StringUtils::format("visit threads: %d  draw calls: %d",
+                                               Director::getInstance()->getRenderer()->getVisitThreadCount(),
+                                               (int)Director::getInstance()->getRenderer()->getDrawnBatches()));
+}
+
+std::string ConcurrentVisitTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string ConcurrentVisitTest::subtitle() const
+{
+    return "Concurrent visit: 8 layers of 500 sprites visited by worker threads, drawn in the same order";
+}
@@ -164,4 +164,102 @@ protected:
     std::string _filename;
 };
 
+class MaterialSortTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(MaterialSortTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    MaterialSortTest();
+    virtual ~MaterialSortTest();
+
+    void onToggle(Ref* sender);
+
+    bool _orderIndependent;
+    Label* _statsLabel;
+};
+
+class StreamingVBOTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(StreamingVBOTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    StreamingVBOTest();
+    virtual ~StreamingVBOTest();
+
+    void onToggleBatchSize(Ref* sender);
+
+    Label* _statsLabel;
+};
+
+class StreamingVBOMockTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(StreamingVBOMockTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    StreamingVBOMockTest();
+    virtual ~StreamingVBOMockTest();
+
+    std::string runChecks();
+};
+
+class HierarchicalCullingTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(HierarchicalCullingTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    HierarchicalCullingTest();
+    virtual ~HierarchicalCullingTest();
+
+    void onToggleCulling(Ref* sender);
+
+    Node* _map;
+    Label* _statsLabel;
+};
+
+class HierarchicalCullingBoundsTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(HierarchicalCullingBoundsTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    HierarchicalCullingBoundsTest();
+    virtual ~HierarchicalCullingBoundsTest();
+
+    std::string runChecks();
+};
+
+class ConcurrentVisitTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(ConcurrentVisitTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    ConcurrentVisitTest();
+    virtual ~ConcurrentVisitTest();
+
+    void onToggleThreads(Ref* sender);
+
+    Label* _statsLabel;
+};
+
 #endif //__NewRendererTest_H_
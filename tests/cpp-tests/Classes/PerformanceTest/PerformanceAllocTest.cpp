@@ -39,6 +39,7 @@ static std::function<PerformceAllocScene*()> createFunctions[] =
     CL(SpriteCreateEmptyTest),
     CL(SpriteCreateTest),
     CL(SpriteDeallocTest),
+    CL(RenderAllocTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -470,6 +471,102 @@ const char*  SpriteDeallocTest::testName()
     return "Sprite::~Sprite()";
 }
 
+////////////////////////////////////////////////////////
+//
+// RenderAllocTest
+//
+////////////////////////////////////////////////////////
+
+// Draws nothing, but creates a new render command every frame in the renderer frame arena
+class TransientCommandNode : public Node
+{
+public:
+    CREATE_FUNC(TransientCommandNode);
+
+    virtual void draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated) override
+    {
+        auto command = renderer->getFrameArena()->create<CustomCommand>();
+        command->init(_globalZOrder);
+        command->func = [](){};
+        renderer->addCommand(command);
+    }
+};
+
+void RenderAllocTest::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // increase nodes
+    for (; currentQuantityOfNodes < quantityOfNodes; currentQuantityOfNodes++)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setScale(0.2f);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        _spritesNode->addChild(sprite, 0, kTagBase + currentQuantityOfNodes);
+
+        // a custom command every 100 sprites breaks the quad batches
+        if (currentQuantityOfNodes % 100 == 0)
+        {
+            _spritesNode->addChild(TransientCommandNode::create(), 0, kTagBase + kMaxNodes + currentQuantityOfNodes);
+        }
+    }
+
+    // decrease nodes
+    for (; currentQuantityOfNodes > quantityOfNodes; currentQuantityOfNodes--)
+    {
+        _spritesNode->removeChildByTag(kTagBase + currentQuantityOfNodes - 1, true);
+        if ((currentQuantityOfNodes - 1) % 100 == 0)
+        {
+            _spritesNode->removeChildByTag(kTagBase + kMaxNodes + currentQuantityOfNodes - 1, true);
+        }
+    }
+}
+
+void RenderAllocTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _spritesNode = Node::create();
+    addChild(_spritesNode);
+
+    _allocationsLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _allocationsLabel->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(_allocationsLabel, 1);
+
+    _lastHeapAllocations = Director::getInstance()->getRenderer()->getHeapAllocations();
+
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    scheduleUpdate();
+}
+
+void RenderAllocTest::update(float dt)
+{
+    // update() runs before the scene is drawn, so these are the allocations of the last frame
+    auto renderer = Director::getInstance()->getRenderer();
+    unsigned int heapAllocations = renderer->getHeapAllocations();
+
+    _allocationsLabel->setString(StringUtils::format("renderer heap allocations in the last frame: %u (frame arena: %d KB)",
+                                                     heapAllocations - _lastHeapAllocations,
+                                                     (int)(renderer->getFrameArena()->getCapacity() / 1024)));
+    _lastHeapAllocations = heapAllocations;
+}
+
+std::string RenderAllocTest::title() const
+{
+    return "Render Alloc Perf test";
+}
+
+std::string RenderAllocTest::subtitle() const
+{
+    return "Heap allocations of the renderer per frame. Should be 0 after the first frames (use + for 5000 sprites)";
+}
+
+const char*  RenderAllocTest::testName()
+{
+    return "Renderer heap allocations";
+}
+
 ///----------------------------------------
 void runAllocPerformanceTest()
 {
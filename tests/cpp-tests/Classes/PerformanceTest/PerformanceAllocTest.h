@@ -115,6 +115,24 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class RenderAllocTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(RenderAllocTest);
+
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(float dt);
+    virtual const char* testName();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    Node* _spritesNode;
+    Label* _allocationsLabel;
+    unsigned int _lastHeapAllocations;
+};
 
 void runAllocPerformanceTest();
 
@@ -5,6 +5,8 @@
 #include "PerformanceCallbackTest.h"
 
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
@@ -38,6 +40,12 @@ static std::function<PerformanceCallbackScene*()> createFunctions[] =
     CL(SimulateNewSchedulerCallbackPerfTest),
     CL(InvokeMemberFunctionPerfTest),
     CL(InvokeStdFunctionPerfTest),
+    CL(SchedulerUpdatePerfTest),
+    CL(SchedulerConcurrentUpdatePerfTest),
+    CL(SchedulerIdleTimersPerfTest),
+    CL(ActionManagerBatchPerfTest),
+    CL(PerformFunctionInCocosThreadPerfTest),
+    CL(RefCountPerfTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -210,6 +218,607 @@ void InvokeStdFunctionPerfTest::onUpdate(float dt)
     CC_PROFILER_STOP(_profileName.c_str());
 }
 
+////////////////////////////////////////////////////////
+//
+// SchedulerUpdatePerfTest
+//
+////////////////////////////////////////////////////////
+
+class SchedulerUpdatePerfTarget : public Ref
+{
+public:
+    SchedulerUpdatePerfTarget() : _elapsed(0) {}
+    void update(float dt) { _elapsed += dt; }
+
+private:
+    float _elapsed;
+};
+
+SchedulerUpdatePerfTest::SchedulerUpdatePerfTest()
+: _scheduler(nullptr)
+, _resultLabel(nullptr)
+{
+}
+
+SchedulerUpdatePerfTest::~SchedulerUpdatePerfTest()
+{
+    CC_SAFE_RELEASE(_scheduler);
+    for (auto target : _targets)
+    {
+        target->release();
+    }
+}
+
+void SchedulerUpdatePerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerUpdate";
+
+    // a scheduler of its own, so only the updates of the test are measured
+    _scheduler = new Scheduler();
+    for (int i = 0; i < TARGET_COUNT; ++i)
+    {
+        auto target = new SchedulerUpdatePerfTarget();
+        _targets.push_back(target);
+
+        // mostly priority 0, like the nodes, and a few other priorities
+        int priority = (i % 10 == 0) ? (i % 3) - 1 : 0;
+        _scheduler->scheduleUpdate(target, priority, false);
+        if (i % 20 == 0)
+        {
+            _scheduler->pauseTarget(target);
+        }
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+std::string SchedulerUpdatePerfTest::title() const
+{
+    return "Scheduler update perf test";
+}
+
+std::string SchedulerUpdatePerfTest::subtitle() const
+{
+    return StringUtils::format("%d scheduled updates. See console", TARGET_COUNT);
+}
+
+void SchedulerUpdatePerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // unschedules and schedules again some of the targets, as nodes entering and leaving the scene do
+    for (int i = 0; i < TARGET_COUNT / 100; ++i)
+    {
+        auto target = _targets[rand() % TARGET_COUNT];
+        if (!_scheduler->isTargetPaused(target))
+        {
+            _scheduler->unscheduleUpdate(target);
+            _scheduler->scheduleUpdate(target, 0, false);
+        }
+    }
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto begin = Clock::now();
+    _scheduler->update(dt);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    _resultLabel->setString(StringUtils::format("%.1f ns per scheduled update", (double)elapsed / TARGET_COUNT));
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerConcurrentUpdatePerfTest
+//
+////////////////////////////////////////////////////////
+
+// a node seeking a point moving around a circle: only its own state is modified, so it can be updated concurrently.
+// Its siblings share its parent, whose subtree bounding box is marked dirty after the concurrent updates
+class SchedulerSteeringPerfTarget : public Node
+{
+public:
+    SchedulerSteeringPerfTarget(float phase) : _phase(phase), _time(0), _velocity(Vec2::ZERO) {}
+
+    virtual void update(float dt) override
+    {
+        Vec2 position = getPosition();
+        for (int i = 0; i < 16; ++i)
+        {
+            _time += dt / 16;
+            Vec2 goal(cosf(_time + _phase) * 100, sinf(_time + _phase) * 100);
+            Vec2 steering = goal - position - _velocity;
+            _velocity += steering * (dt / 16);
+            position += _velocity * (dt / 16);
+        }
+        setPosition(position);
+    }
+
+private:
+    float _phase;
+    float _time;
+    Vec2 _velocity;
+};
+
+SchedulerConcurrentUpdatePerfTest::SchedulerConcurrentUpdatePerfTest()
+: _scheduler(nullptr)
+, _targetsParent(nullptr)
+, _resultLabel(nullptr)
+{
+}
+
+SchedulerConcurrentUpdatePerfTest::~SchedulerConcurrentUpdatePerfTest()
+{
+    CC_SAFE_RELEASE(_scheduler);
+    CC_SAFE_RELEASE(_targetsParent);
+    for (auto target : _targets)
+    {
+        target->release();
+    }
+}
+
+void SchedulerConcurrentUpdatePerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerConcurrentUpdate";
+
+    _scheduler = new Scheduler();
+    // not part of the scene: only the updates are measured
+    _targetsParent = Node::create();
+    _targetsParent->retain();
+    for (int i = 0; i < TARGET_COUNT; ++i)
+    {
+        auto target = new SchedulerSteeringPerfTarget(i * 0.01f);
+        _targetsParent->addChild(target);
+        _targets.push_back(target);
+        _scheduler->scheduleConcurrentUpdate(target, 0, false);
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender) {
+        auto item = static_cast<MenuItemToggle*>(sender);
+        int threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+        _scheduler->setUpdateThreadCount(item->getSelectedIndex() == 0 ? 0 : threads);
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Update threads: off"), MenuItemFont::create("Update threads: on"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+std::string SchedulerConcurrentUpdatePerfTest::title() const
+{
+    return "Scheduler concurrent update perf test";
+}
+
+std::string SchedulerConcurrentUpdatePerfTest::subtitle() const
+{
+    return StringUtils::format("%d steering nodes moving themselves. See console", TARGET_COUNT);
+}
+
+void SchedulerConcurrentUpdatePerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto begin = Clock::now();
+    _scheduler->update(dt);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    _resultLabel->setString(StringUtils::format("%d worker threads: %.2f ms per tick", _scheduler->getUpdateThreadCount(), elapsed / 1000.0));
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerIdleTimersPerfTest
+//
+////////////////////////////////////////////////////////
+
+SchedulerIdleTimersPerfTest::SchedulerIdleTimersPerfTest()
+: _scheduler(nullptr)
+, _useTimerWheel(true)
+, _triggeredTimers(0)
+, _resultLabel(nullptr)
+{
+}
+
+SchedulerIdleTimersPerfTest::~SchedulerIdleTimersPerfTest()
+{
+    CC_SAFE_RELEASE(_scheduler);
+    for (auto target : _targets)
+    {
+        target->release();
+    }
+    for (auto timer : _frameTimers)
+    {
+        timer->release();
+    }
+}
+
+void SchedulerIdleTimersPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerIdleTimers";
+
+    // cooldowns and respawns: long intervals, so very few timers are due in a frame
+    _scheduler = new Scheduler();
+    auto callback = [this](float dt) { ++_triggeredTimers; };
+    for (int i = 0; i < TIMER_COUNT; ++i)
+    {
+        float interval = 5.0f + (i % 5500) * 0.01f;
+
+        auto target = new SchedulerUpdatePerfTarget();
+        _targets.push_back(target);
+        _scheduler->schedule(callback, target, interval, kRepeatForever, 0.0f, false, "cooldown");
+
+        auto timer = new TimerTargetCallback();
+        timer->initWithCallback(_scheduler, callback, target, "cooldown", interval, kRepeatForever, 0.0f);
+        _frameTimers.push_back(timer);
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender) {
+        _useTimerWheel = static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0;
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Timers: timing wheel"), MenuItemFont::create("Timers: updated every frame"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+std::string SchedulerIdleTimersPerfTest::title() const
+{
+    return "Scheduler idle timers perf test";
+}
+
+std::string SchedulerIdleTimersPerfTest::subtitle() const
+{
+    return StringUtils::format("%d timers of 5 to 60 seconds. See console", TIMER_COUNT);
+}
+
+void SchedulerIdleTimersPerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    _triggeredTimers = 0;
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto begin = Clock::now();
+    if (_useTimerWheel)
+    {
+        _scheduler->update(dt);
+    }
+    else
+    {
+        for (auto timer : _frameTimers)
+        {
+            timer->update(dt);
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    _resultLabel->setString(StringUtils::format("%s: %.2f ms per tick, %d triggered",
+                                                _useTimerWheel ? "timing wheel" : "updated every frame",
+                                                elapsed / 1000.0, _triggeredTimers));
+}
+
+////////////////////////////////////////////////////////
+//
+// ActionManagerBatchPerfTest
+//
+////////////////////////////////////////////////////////
+
+ActionManagerBatchPerfTest::ActionManagerBatchPerfTest()
+: _actionManager(nullptr)
+, _resultLabel(nullptr)
+{
+}
+
+ActionManagerBatchPerfTest::~ActionManagerBatchPerfTest()
+{
+    if (_actionManager)
+    {
+        _actionManager->removeAllActions();
+        _actionManager->release();
+    }
+    for (auto node : _nodes)
+    {
+        node->release();
+    }
+}
+
+void ActionManagerBatchPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "ActionManagerBatch";
+
+    // an action manager of its own, so only the actions of the test are measured
+    _actionManager = new ActionManager();
+    _actionManager->setBatchingEnabled(true);
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        auto node = Node::create();
+        node->retain();
+        node->setActionManager(_actionManager);
+        _nodes.push_back(node);
+    }
+    runActions();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender) {
+        _actionManager->setBatchingEnabled(static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0);
+        runActions();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Actions: batched"), MenuItemFont::create("Actions: stepped one by one"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+void ActionManagerBatchPerfTest::runActions()
+{
+    _actionManager->removeAllActions();
+
+    // the usual effects of a crowded scene, long enough to keep running during the test
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        auto node = _nodes[i];
+        float duration = 600.0f + (i % 100);
+        node->runAction(MoveBy::create(duration, Vec2(i % 320, i % 240)));
+        node->runAction(EaseSineInOut::create(ScaleTo::create(duration, 2.0f)));
+        if (i % 2 == 0)
+        {
+            node->runAction(RotateBy::create(duration, 360.0f));
+        }
+        if (i % 4 == 0)
+        {
+            node->runAction(EaseOut::create(FadeTo::create(duration, 0), 2.0f));
+        }
+    }
+}
+
+std::string ActionManagerBatchPerfTest::title() const
+{
+    return "ActionManager batch perf test";
+}
+
+std::string ActionManagerBatchPerfTest::subtitle() const
+{
+    return StringUtils::format("%d nodes moving, scaling, rotating and fading. See console", NODE_COUNT);
+}
+
+void ActionManagerBatchPerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto begin = Clock::now();
+    _actionManager->update(dt);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    _resultLabel->setString(StringUtils::format("%s: %.2f ms per tick",
+                                                _actionManager->isBatchingEnabled() ? "batched" : "stepped one by one",
+                                                elapsed / 1000.0));
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformFunctionInCocosThreadPerfTest
+//
+////////////////////////////////////////////////////////
+
+PerformFunctionInCocosThreadPerfTest::PerformFunctionInCocosThreadPerfTest()
+: _scheduler(nullptr)
+, _quitWorkers(false)
+, _resultLabel(nullptr)
+{
+}
+
+PerformFunctionInCocosThreadPerfTest::~PerformFunctionInCocosThreadPerfTest()
+{
+    CC_SAFE_RELEASE(_scheduler);
+}
+
+void PerformFunctionInCocosThreadPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "PerformFunctionInCocosThread";
+
+    // a scheduler of its own, so only the functions of the test are measured
+    _scheduler = new Scheduler();
+
+    // loaders and network threads finishing their jobs, each job costing some time in the cocos thread
+    _quitWorkers = false;
+    for (int i = 0; i < WORKER_COUNT; ++i)
+    {
+        _workers.push_back(std::thread([this]() {
+            while (!_quitWorkers)
+            {
+                for (int j = 0; j < FUNCTIONS_PER_BATCH; ++j)
+                {
+                    _scheduler->performFunctionInCocosThread([]() {
+                        auto begin = std::chrono::steady_clock::now();
+                        while (std::chrono::steady_clock::now() - begin < std::chrono::microseconds(FUNCTION_MICROSECONDS))
+                        {
+                        }
+                    });
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            }
+        }));
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender) {
+        _scheduler->setFunctionsToPerformBudget(static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0 ? 0.005f : 0);
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Budget: 5 ms per frame"), MenuItemFont::create("Budget: none"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+void PerformFunctionInCocosThreadPerfTest::onExit()
+{
+    _quitWorkers = true;
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+    _workers.clear();
+
+    PerformanceCallbackScene::onExit();
+}
+
+std::string PerformFunctionInCocosThreadPerfTest::title() const
+{
+    return "performFunctionInCocosThread perf test";
+}
+
+std::string PerformFunctionInCocosThreadPerfTest::subtitle() const
+{
+    return StringUtils::format("%d threads posting %d functions of %d us every 16 ms. See console",
+                               WORKER_COUNT, FUNCTIONS_PER_BATCH, FUNCTION_MICROSECONDS);
+}
+
+void PerformFunctionInCocosThreadPerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    CC_PROFILER_START(_profileName.c_str());
+    auto begin = Clock::now();
+    _scheduler->update(dt);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    auto& functions = _scheduler->getFunctionsToPerform();
+    _resultLabel->setString(StringUtils::format("%.2f ms per frame, %d queued, %u late",
+                                                elapsed / 1000.0,
+                                                functions.getQueuedTaskCount(),
+                                                functions.getLateTaskCount()));
+}
+
+////////////////////////////////////////////////////////
+//
+// RefCountPerfTest
+//
+////////////////////////////////////////////////////////
+
+class RefCountPerfTarget : public Ref
+{
+};
+
+RefCountPerfTest::RefCountPerfTest()
+: _plainTarget(nullptr)
+, _threadSafeTarget(nullptr)
+, _resultLabel(nullptr)
+{
+}
+
+RefCountPerfTest::~RefCountPerfTest()
+{
+    CC_SAFE_RELEASE(_plainTarget);
+    CC_SAFE_RELEASE(_threadSafeTarget);
+}
+
+void RefCountPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "RefCount";
+
+    _plainTarget = new RefCountPerfTarget();
+    _plainTarget->setReferenceCountThreadSafe(false);
+    _threadSafeTarget = new RefCountPerfTarget();
+    _threadSafeTarget->setReferenceCountThreadSafe(true);
+
+    auto s = Director::getInstance()->getWinSize();
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+}
+
+std::string RefCountPerfTest::title() const
+{
+    return "Ref reference count perf test";
+}
+
+std::string RefCountPerfTest::subtitle() const
+{
+    return StringUtils::format("%d retain/release, %d RefPtr copied or moved. See console", RETAIN_COUNT, POINTER_COUNT);
+}
+
+void RefCountPerfTest::onUpdate(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    auto measureRetainRelease = [](Ref* target) {
+        auto begin = Clock::now();
+        for (int i = 0; i < RETAIN_COUNT; ++i)
+        {
+            target->retain();
+            target->release();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count() / 1000.0;
+    };
+
+    // filling a vector, the way the containers pass the pointers around
+    auto measureRefPtr = [](Ref* target, bool move) {
+        std::vector<RefPtr<Ref>> pointers;
+        pointers.reserve(POINTER_COUNT);
+        auto begin = Clock::now();
+        for (int i = 0; i < POINTER_COUNT; ++i)
+        {
+            RefPtr<Ref> pointer(target);
+            if (move)
+                pointers.push_back(std::move(pointer));
+            else
+                pointers.push_back(pointer);
+        }
+        pointers.clear();
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count() / 1000.0;
+    };
+
+    CC_PROFILER_START(_profileName.c_str());
+    double plain = measureRetainRelease(_plainTarget);
+    double threadSafe = measureRetainRelease(_threadSafeTarget);
+    double copied = measureRefPtr(_threadSafeTarget, false);
+    double moved = measureRefPtr(_threadSafeTarget, true);
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    _resultLabel->setString(StringUtils::format("retain/release plain: %.2f ms, atomic: %.2f ms\nRefPtr atomic copied: %.2f ms, moved: %.2f ms",
+                                                plain, threadSafe, copied, moved));
+}
+
 void runCallbackPerformanceTest()
 {
     auto scene = createFunctions[g_curCase]();
@@ -6,6 +6,9 @@
 
 #include "PerformanceTest.h"
 
+#include <atomic>
+#include <thread>
+
 class CallbackBasicLayer : public PerformBasicLayer
 {
 public:
@@ -96,6 +99,155 @@ private:
     std::function<void(float)> _callback;
 };
 
+// SchedulerUpdatePerfTest
+class SchedulerUpdatePerfTarget;
+
+class SchedulerUpdatePerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerUpdatePerfTest);
+
+    SchedulerUpdatePerfTest();
+    virtual ~SchedulerUpdatePerfTest();
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int TARGET_COUNT = 20000;
+
+private:
+    Scheduler* _scheduler;
+    std::vector<SchedulerUpdatePerfTarget*> _targets;
+    Label* _resultLabel;
+};
+
+// SchedulerConcurrentUpdatePerfTest
+class SchedulerSteeringPerfTarget;
+
+class SchedulerConcurrentUpdatePerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerConcurrentUpdatePerfTest);
+
+    SchedulerConcurrentUpdatePerfTest();
+    virtual ~SchedulerConcurrentUpdatePerfTest();
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int TARGET_COUNT = 20000;
+
+private:
+    Scheduler* _scheduler;
+    Node* _targetsParent;
+    std::vector<SchedulerSteeringPerfTarget*> _targets;
+    Label* _resultLabel;
+};
+
+// SchedulerIdleTimersPerfTest
+class SchedulerIdleTimersPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerIdleTimersPerfTest);
+
+    SchedulerIdleTimersPerfTest();
+    virtual ~SchedulerIdleTimersPerfTest();
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int TIMER_COUNT = 100000;
+
+private:
+    Scheduler* _scheduler;
+    std::vector<Ref*> _targets;
+    // the same timers, updated every frame like the Scheduler used to do
+    std::vector<Timer*> _frameTimers;
+    bool _useTimerWheel;
+    int _triggeredTimers;
+    Label* _resultLabel;
+};
+
+// ActionManagerBatchPerfTest
+class ActionManagerBatchPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(ActionManagerBatchPerfTest);
+
+    ActionManagerBatchPerfTest();
+    virtual ~ActionManagerBatchPerfTest();
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int NODE_COUNT = 10000;
+
+private:
+    void runActions();
+
+    ActionManager* _actionManager;
+    std::vector<Node*> _nodes;
+    Label* _resultLabel;
+};
+
+// PerformFunctionInCocosThreadPerfTest
+class PerformFunctionInCocosThreadPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(PerformFunctionInCocosThreadPerfTest);
+
+    PerformFunctionInCocosThreadPerfTest();
+    virtual ~PerformFunctionInCocosThreadPerfTest();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int WORKER_COUNT = 4;
+    // functions posted by each worker every 16 ms, and how long each of them takes
+    static const int FUNCTIONS_PER_BATCH = 50;
+    static const int FUNCTION_MICROSECONDS = 50;
+
+private:
+    Scheduler* _scheduler;
+    std::vector<std::thread> _workers;
+    std::atomic<bool> _quitWorkers;
+    Label* _resultLabel;
+};
+
+// RefCountPerfTest
+class RefCountPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(RefCountPerfTest);
+
+    RefCountPerfTest();
+    virtual ~RefCountPerfTest();
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+
+    static const int RETAIN_COUNT = 1000000;
+    static const int POINTER_COUNT = 100000;
+
+private:
+    Ref* _plainTarget;
+    Ref* _threadSafeTarget;
+    Label* _resultLabel;
+};
+
 void runCallbackPerformanceTest();
 
 #endif /* __PERFORMANCE_CALLBACK_TEST_H__ */
@@ -4,6 +4,7 @@
 #include "PerformanceContainerTest.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
@@ -39,7 +40,8 @@ static std::function<PerformanceContainerScene*()> createFunctions[] =
     CL(TemplateMapStringKeyPerfTest),
     CL(DictionaryStringKeyPerfTest),
     CL(TemplateMapIntKeyPerfTest),
-    CL(DictionaryIntKeyPerfTest)
+    CL(DictionaryIntKeyPerfTest),
+    CL(ValueMapPlistPerfTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1359,6 +1361,153 @@ std::string DictionaryIntKeyPerfTest::subtitle() const
 
 
 ///----------------------------------------
+////////////////////////////////////////////////////////
+//
+// ValueMapPlistPerfTest
+//
+////////////////////////////////////////////////////////
+
+void ValueMapPlistPerfTest::generateTestFunctions()
+{
+    // a sprite sheet with a frame per node, like the ones written by TexturePacker
+    auto writePlist = [this](){
+        ValueMap frames;
+        for( int i=0; i<quantityOfNodes; ++i)
+        {
+            ValueMap frame;
+            frame["frame"] = Value(StringUtils::format("{{%d,%d},{32,32}}", i % 32 * 32, i / 32 * 32));
+            frame["offset"] = Value("{0,0}");
+            frame["rotated"] = Value(false);
+            frame["sourceColorRect"] = Value("{{0,0},{32,32}}");
+            frame["sourceSize"] = Value("{32,32}");
+            frames[StringUtils::format("frame_%05d.png", i)] = Value(std::move(frame));
+        }
+        
+        ValueMap metadata;
+        metadata["format"] = Value(2);
+        metadata["textureFileName"] = Value("ValueMapPlistPerfTest.png");
+        
+        ValueMap root;
+        root["frames"] = Value(std::move(frames));
+        root["metadata"] = Value(std::move(metadata));
+        
+        std::string path = FileUtils::getInstance()->getWritablePath() + "ValueMapPlistPerfTest.plist";
+        FileUtils::getInstance()->writeToFile(root, path);
+        return path;
+    };
+    
+    auto createKeys = [this](){
+        std::vector<std::string> keys;
+        keys.reserve(quantityOfNodes);
+        for( int i=0; i<quantityOfNodes; ++i)
+            keys.push_back(StringUtils::format("frame_%05d.png", i));
+        return keys;
+    };
+    
+    TestFunction testFunctions[] = {
+        { "load plist",    [=](){
+            std::string path = writePlist();
+            
+            CC_PROFILER_START(this->profilerName());
+            ValueMap root = FileUtils::getInstance()->getValueMapFromFile(path);
+            CC_PROFILER_STOP(this->profilerName());
+            
+            CCASSERT(root["frames"].asValueMap().size() == (size_t)quantityOfNodes, "frames missing");
+        } } ,
+        
+        { "copy",    [=](){
+            ValueMap root = FileUtils::getInstance()->getValueMapFromFile(writePlist());
+            
+            CC_PROFILER_START(this->profilerName());
+            ValueMap copy = root;
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        
+        { "read frames",    [=](){
+            ValueMap root = FileUtils::getInstance()->getValueMapFromFile(writePlist());
+            ValueMap& frames = root["frames"].asValueMap();
+            
+            // what SpriteFrameCache does with each frame
+            int rotated = 0;
+            CC_PROFILER_START(this->profilerName());
+            for (auto& frame : frames)
+            {
+                ValueMap& frameDict = frame.second.asValueMap();
+                Rect rect = RectFromString(frameDict["frame"].asString());
+                Vec2 offset = PointFromString(frameDict["offset"].asString());
+                if (frameDict["rotated"].asBool())
+                    ++rotated;
+                CC_UNUSED_PARAM(rect);
+                CC_UNUSED_PARAM(offset);
+            }
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        
+        { "unordered_map insert",    [=](){
+            std::vector<std::string> keys = createKeys();
+            std::unordered_map<std::string, Value> map;
+            
+            CC_PROFILER_START(this->profilerName());
+            for( int i=0; i<quantityOfNodes; ++i)
+                map[keys[i]] = Value("{{0,0},{32,32}}");
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        
+        { "FlatMap insert",    [=](){
+            std::vector<std::string> keys = createKeys();
+            FlatMap<std::string, Value> map;
+            
+            CC_PROFILER_START(this->profilerName());
+            for( int i=0; i<quantityOfNodes; ++i)
+                map[keys[i]] = Value("{{0,0},{32,32}}");
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        
+        { "unordered_map find",    [=](){
+            std::vector<std::string> keys = createKeys();
+            std::unordered_map<std::string, Value> map;
+            for( int i=0; i<quantityOfNodes; ++i)
+                map[keys[i]] = Value(i);
+            
+            int sum = 0;
+            CC_PROFILER_START(this->profilerName());
+            for( int i=0; i<quantityOfNodes; ++i)
+                sum += map.find(keys[i])->second.asInt();
+            CC_PROFILER_STOP(this->profilerName());
+            CC_UNUSED_PARAM(sum);
+        } } ,
+        
+        { "FlatMap find",    [=](){
+            std::vector<std::string> keys = createKeys();
+            FlatMap<std::string, Value> map;
+            for( int i=0; i<quantityOfNodes; ++i)
+                map[keys[i]] = Value(i);
+            
+            int sum = 0;
+            CC_PROFILER_START(this->profilerName());
+            for( int i=0; i<quantityOfNodes; ++i)
+                sum += map.find(keys[i])->second.asInt();
+            CC_PROFILER_STOP(this->profilerName());
+            CC_UNUSED_PARAM(sum);
+        } } ,
+    };
+    
+    for (const auto& func : testFunctions)
+    {
+        _testFunctions.push_back(func);
+    }
+}
+
+std::string ValueMapPlistPerfTest::title() const
+{
+    return "ValueMap plist Perf test";
+}
+
+std::string ValueMapPlistPerfTest::subtitle() const
+{
+    return "Sprite sheet plist with a frame per node, See console";
+}
+
 void runContainerPerformanceTest()
 {
     auto scene = createFunctions[g_curCase]();
@@ -126,6 +126,17 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ValueMapPlistPerfTest : public PerformanceContainerScene
+{
+public:
+    CREATE_FUNC(ValueMapPlistPerfTest);
+    
+    virtual void generateTestFunctions() override;
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 void runContainerPerformanceTest();
 
 #endif // __PERFORMANCE_CONTAINER_TEST_H__
@@ -698,9 +698,12 @@ void CustomEventDispatchingPerfTest::onEnter()
     
     for (int i = 0; i < 2000; i++)
     {
-        auto listener = EventListenerCustom::create(StringUtils::format("custom_event_%d", i), [](EventCustom* event){});
+        auto eventName = StringUtils::format("custom_event_%d", i);
+        auto listener = EventListenerCustom::create(eventName, [](EventCustom* event){});
         _eventDispatcher->addEventListenerWithFixedPriority(listener, i + 1);
         _customListeners.push_back(listener);
+        _customEventNames.push_back(eventName);
+        _customEventIDs.push_back(EventDispatcher::getCustomEventID(eventName));
     }
 }
 
@@ -710,6 +713,9 @@ void CustomEventDispatchingPerfTest::onExit()
     {
         _eventDispatcher->removeEventListener(l);
     }
+    _customListeners.clear();
+    _customEventNames.clear();
+    _customEventIDs.clear();
     PerformanceEventDispatcherScene::onExit();
 }
 
@@ -763,6 +769,29 @@ void CustomEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&event);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
+        // Dispatches as many events per frame as the listener count, cycling through the event names registered in onEnter
+        { "custom-throughput-name",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            _lastRenderedCount = _quantityOfNodes;
+            
+            CC_PROFILER_START(this->profilerName());
+            for (int i = 0; i < this->_quantityOfNodes; ++i)
+            {
+                dispatcher->dispatchCustomEvent(_customEventNames[i % _customEventNames.size()]);
+            }
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        { "custom-throughput-id",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            _lastRenderedCount = _quantityOfNodes;
+            
+            CC_PROFILER_START(this->profilerName());
+            for (int i = 0; i < this->_quantityOfNodes; ++i)
+            {
+                dispatcher->dispatchCustomEvent(_customEventIDs[i % _customEventIDs.size()]);
+            }
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
     };
     
     for (const auto& func : testFunctions)
@@ -98,6 +98,8 @@ public:
     
 private:
     std::vector<EventListener*> _customListeners;
+    std::vector<std::string> _customEventNames;
+    std::vector<int> _customEventIDs;
 };
 
 void runEventDispatcherPerformanceTest();
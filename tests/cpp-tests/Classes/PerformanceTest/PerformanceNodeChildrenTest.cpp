@@ -44,8 +44,11 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(RemoveSpriteSheet),
     CL(ReorderSpriteSheet),
     CL(SortAllChildrenSpriteSheet),
+    CL(ReorderNodesPerFrame),
 
     CL(VisitSceneGraph),
+    CL(VisitDeepSceneGraph),
+    CL(WorldTransformSceneGraph),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -903,6 +906,85 @@ const char*  SortAllChildrenSpriteSheet::testName()
 }
 
 
+////////////////////////////////////////////////////////
+//
+// ReorderNodesPerFrame
+//
+////////////////////////////////////////////////////////
+static const int kReorderedNodesPerFrame = 50;
+
+ReorderNodesPerFrame::ReorderNodesPerFrame()
+: _container(nullptr)
+{
+}
+
+void ReorderNodesPerFrame::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void ReorderNodesPerFrame::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            _container->addChild(node, CCRANDOM_0_1() * 1000, 1000 + currentQuantityOfNodes + i);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChildByTag(1000 + currentQuantityOfNodes - i -1 );
+        }
+    }
+
+    _container->sortAllChildren();
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void ReorderNodesPerFrame::update(float dt)
+{
+    auto& children = _container->getChildren();
+    if (children.empty())
+        return;
+
+    // like depth sorting, only a few nodes change their z order every frame
+    for (int i = 0; i < kReorderedNodesPerFrame; i++)
+    {
+        auto node = children.at(rand() % children.size());
+        node->setLocalZOrder(CCRANDOM_0_1() * 1000);
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    _container->sortAllChildren();
+    CC_PROFILER_STOP( this->profilerName() );
+}
+
+std::string ReorderNodesPerFrame::title() const
+{
+    return "Node::sortAllChildren()";
+}
+
+std::string ReorderNodesPerFrame::subtitle() const
+{
+    return "Reorders 50 nodes per frame. See console";
+}
+
+const char*  ReorderNodesPerFrame::testName()
+{
+    return "sortAllChildren() 50 per frame";
+}
+
 ////////////////////////////////////////////////////////
 //
 // VisitSceneGraph
@@ -968,6 +1050,207 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// VisitDeepSceneGraph
+//
+////////////////////////////////////////////////////////
+static const int kVisitDepth = 32;
+
+void VisitDeepSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    VisitSceneGraph::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        Director::getInstance()->setLazyMatrixStackEnabled(static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Lazy matrix stack: on"), MenuItemFont::create("Lazy matrix stack: off"), NULL);
+    toggle->setSelectedIndex(Director::getInstance()->isLazyMatrixStackEnabled() ? 0 : 1);
+
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+}
+
+void VisitDeepSceneGraph::onExit()
+{
+    Director::getInstance()->setLazyMatrixStackEnabled(CC_ENABLE_LAZY_MATRIX_STACK);
+    VisitSceneGraph::onExit();
+}
+
+void VisitDeepSceneGraph::updateQuantityOfNodes()
+{
+    int chains = quantityOfNodes / kVisitDepth;
+
+    // increase nodes: chains of kVisitDepth nodes
+    while ((int)_chainRoots.size() < chains)
+    {
+        Node* parent = this;
+        for (int depth = 0; depth < kVisitDepth; depth++)
+        {
+            auto node = Node::create();
+            node->setPosition(Vec2(-1000,-1000));
+            parent->addChild(node);
+            parent = node;
+
+            if (depth == 0)
+                _chainRoots.push_back(node);
+        }
+    }
+
+    // decrease nodes
+    while ((int)_chainRoots.size() > chains)
+    {
+        this->removeChild(_chainRoots.back());
+        _chainRoots.pop_back();
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+std::string VisitDeepSceneGraph::title() const
+{
+    return "Performance of visiting deep hierarchies";
+}
+
+std::string VisitDeepSceneGraph::subtitle() const
+{
+    return "calls visit() on chains of 32 nodes. See console";
+}
+
+const char*  VisitDeepSceneGraph::testName()
+{
+    return Director::getInstance()->isLazyMatrixStackEnabled() ? "visit() deep, lazy matrix stack" : "visit() deep, matrix stack";
+}
+
+////////////////////////////////////////////////////////
+//
+// WorldTransformSceneGraph
+//
+////////////////////////////////////////////////////////
+static const int kWorldTransformDepth = 16;
+static const int kWorldTransformMovedChains = 8;
+
+WorldTransformSceneGraph::WorldTransformSceneGraph()
+: _transformSystemEnabled(true)
+, _angle(0)
+, _frame(0)
+, _checksum(0)
+{
+}
+
+void WorldTransformSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        _transformSystemEnabled = static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0;
+        Director::getInstance()->setTransformSystemEnabled(_transformSystemEnabled);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Transform system: on"), MenuItemFont::create("Transform system: off"), NULL);
+
+    auto menu = Menu::create(toggle, NULL);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void WorldTransformSceneGraph::onEnter()
+{
+    NodeChildrenMainScene::onEnter();
+    Director::getInstance()->setTransformSystemEnabled(_transformSystemEnabled);
+}
+
+void WorldTransformSceneGraph::onExit()
+{
+    Director::getInstance()->setTransformSystemEnabled(false);
+    NodeChildrenMainScene::onExit();
+}
+
+void WorldTransformSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    int chains = quantityOfNodes / kWorldTransformDepth;
+    int currentChains = (int)_chainNodes.size() / kWorldTransformDepth;
+
+    // increase nodes: chains of kWorldTransformDepth nodes
+    for (int i = currentChains; i < chains; i++)
+    {
+        Node* parent = this;
+        for (int depth = 0; depth < kWorldTransformDepth; depth++)
+        {
+            auto node = Node::create();
+            node->setPosition(depth == 0 ? Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height) : Vec2(4, 0));
+            node->setRotation(5);
+            parent->addChild(node, 0, depth == 0 ? 1000 + i : 0);
+            _chainNodes.push_back(node);
+            parent = node;
+        }
+    }
+
+    // decrease nodes
+    for (int i = currentChains - 1; i >= chains; i--)
+    {
+        this->removeChildByTag(1000 + i);
+        _chainNodes.resize(i * kWorldTransformDepth);
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void WorldTransformSceneGraph::update(float dt)
+{
+    _angle += dt * 30;
+    _frame++;
+
+    CC_PROFILER_START( this->profilerName() );
+
+    // a few chains move every frame
+    for (size_t i = (_frame % kWorldTransformMovedChains) * kWorldTransformDepth; i < _chainNodes.size(); i += kWorldTransformMovedChains * kWorldTransformDepth)
+    {
+        _chainNodes[i]->setRotation(_angle);
+    }
+
+    // the Director updates the transforms before visiting the scene. Here it is done before querying the nodes
+    auto transformSystem = Director::getInstance()->getTransformSystem();
+    if (transformSystem && transformSystem->getRoot() == this)
+    {
+        transformSystem->update();
+    }
+
+    for (const auto& node : _chainNodes)
+    {
+        _checksum += node->convertToWorldSpace(Vec2::ZERO).x;
+    }
+
+    CC_PROFILER_STOP( this->profilerName() );
+}
+
+std::string WorldTransformSceneGraph::title() const
+{
+    return "Performance of world transforms";
+}
+
+std::string WorldTransformSceneGraph::subtitle() const
+{
+    return "convertToWorldSpace() on deep chains. See console";
+}
+
+const char*  WorldTransformSceneGraph::testName()
+{
+    return _transformSystemEnabled ? "convertToWorldSpace() flat" : "convertToWorldSpace() walk";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
@@ -212,6 +212,24 @@ public:
     virtual const char* testName();
 };
 
+class ReorderNodesPerFrame : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ReorderNodesPerFrame);
+
+    ReorderNodesPerFrame();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _container;
+};
+
 class VisitSceneGraph : public NodeChildrenMainScene
 {
 public:
@@ -226,6 +244,47 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitDeepSceneGraph : public VisitSceneGraph
+{
+public:
+    CREATE_FUNC(VisitDeepSceneGraph);
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void onExit() override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    std::vector<Node*> _chainRoots;
+};
+
+class WorldTransformSceneGraph : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(WorldTransformSceneGraph);
+
+    WorldTransformSceneGraph();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    std::vector<Node*> _chainNodes;
+    bool _transformSystemEnabled;
+    float _angle;
+    int _frame;
+    float _checksum;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -10,6 +10,15 @@
 #include "PerformanceTextureTest.h"
 #include "../testResource.h"
 
+#include <chrono>
+#include <thread>
+
+enum {
+    kQuadTransformDefaultQuads = 10000,
+    kQuadTransformQuadsIncrease = 5000,
+    kQuadTransformMaxQuads = 60000,
+};
+
 RenderTestLayer::RenderTestLayer()
 : PerformBasicLayer(true, 1, 1)
 {
@@ -52,4 +61,169 @@ void runRendererTest()
 {
     auto scene = RenderTestLayer::scene();
     Director::getInstance()->replaceScene(scene);
-}
\ No newline at end of file
+}
+////////////////////////////////////////////////////////
+//
+// RendererQuadTransformPerfTest
+//
+////////////////////////////////////////////////////////
+RendererQuadTransformPerfTest::RendererQuadTransformPerfTest()
+: PerformBasicLayer(false)
+, _pool(nullptr)
+, _quantityLabel(nullptr)
+, _resultLabel(nullptr)
+{
+    int threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    _pool = new ThreadPool(threads);
+}
+
+RendererQuadTransformPerfTest::~RendererQuadTransformPerfTest()
+{
+    CC_SAFE_DELETE(_pool);
+}
+
+Scene* RendererQuadTransformPerfTest::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new RendererQuadTransformPerfTest();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void RendererQuadTransformPerfTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto title = Label::createWithTTF("Renderer quad transform", "fonts/arial.ttf", 32);
+    title->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(title);
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [this](Ref* sender) {
+        if (_srcQuads.size() > kQuadTransformQuadsIncrease)
+        {
+            _srcQuads.resize(_srcQuads.size() - kQuadTransformQuadsIncrease);
+            showCurrentTest();
+        }
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [this](Ref* sender) {
+        if (_srcQuads.size() < kQuadTransformMaxQuads)
+        {
+            _srcQuads.resize(_srcQuads.size() + kQuadTransformQuadsIncrease);
+            showCurrentTest();
+        }
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, nullptr);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+15));
+    addChild(menu, 1);
+
+    _quantityLabel = Label::createWithTTF("", "fonts/arial.ttf", 30);
+    _quantityLabel->setColor(Color3B(0,200,20));
+    _quantityLabel->setPosition(Vec2(s.width/2, s.height/2-15));
+    addChild(_quantityLabel);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2-80));
+    addChild(_resultLabel);
+
+    _srcQuads.resize(kQuadTransformDefaultQuads);
+    showCurrentTest();
+
+    scheduleUpdate();
+}
+
+void RendererQuadTransformPerfTest::showCurrentTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    srand(0);
+    _modelViews.resize(_srcQuads.size() / QUADS_PER_COMMAND);
+    for (auto& mv : _modelViews)
+    {
+        Mat4::createTranslation(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height, 0, &mv);
+        mv.rotateZ(CCRANDOM_0_1() * M_PI);
+    }
+
+    for (auto& quad : _srcQuads)
+    {
+        quad.bl.vertices = Vec3(0, 0, 0);
+        quad.br.vertices = Vec3(32, 0, 0);
+        quad.tl.vertices = Vec3(0, 32, 0);
+        quad.tr.vertices = Vec3(32, 32, 0);
+    }
+    _dstQuads.resize(_srcQuads.size());
+
+    updateQuantityLabel();
+}
+
+void RendererQuadTransformPerfTest::updateQuantityLabel()
+{
+    _quantityLabel->setString(StringUtils::format("%d quads", (int)_srcQuads.size()));
+}
+
+void RendererQuadTransformPerfTest::update(float dt)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    const size_t commands = _modelViews.size();
+    const auto src = _srcQuads.data();
+    const auto dst = _dstQuads.data();
+    const auto modelViews = _modelViews.data();
+
+    auto measure = [&](const std::function<void()>& func) {
+        auto begin = Clock::now();
+        func();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+        return _srcQuads.size() * 1000.0 / std::max((long long)elapsed, 1LL);
+    };
+
+    // what Renderer used to do: four Mat4::transformPoint per quad
+    double scalar = measure([&]() {
+        for (size_t i = 0; i < commands; ++i)
+        {
+            auto quads = dst + i * QUADS_PER_COMMAND;
+            memcpy(quads, src + i * QUADS_PER_COMMAND, sizeof(V3F_C4B_T2F_Quad) * QUADS_PER_COMMAND);
+            for (int q = 0; q < QUADS_PER_COMMAND; ++q)
+            {
+                modelViews[i].transformPoint(&quads[q].bl.vertices);
+                modelViews[i].transformPoint(&quads[q].br.vertices);
+                modelViews[i].transformPoint(&quads[q].tr.vertices);
+                modelViews[i].transformPoint(&quads[q].tl.vertices);
+            }
+        }
+    });
+
+    auto batchedRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto quads = dst + i * QUADS_PER_COMMAND;
+            memcpy(quads, src + i * QUADS_PER_COMMAND, sizeof(V3F_C4B_T2F_Quad) * QUADS_PER_COMMAND);
+            modelViews[i].transformPoints(&quads->bl.vertices, QUADS_PER_COMMAND * 4, sizeof(V3F_C4B_T2F));
+        }
+    };
+
+    double batched = measure([&]() {
+        batchedRange(0, commands);
+    });
+
+    double parallel = measure([&]() {
+        _pool->parallelFor(commands, commands / (_pool->getThreadCount() * 4) + 1, batchedRange);
+    });
+
+    _resultLabel->setString(StringUtils::format("quads/ms  scalar: %.0f  batched: %.0f  batched + %d threads: %.0f",
+                                                scalar, batched, _pool->getThreadCount(), parallel));
+}
+
+void runRendererQuadTransformTest()
+{
+    auto scene = RendererQuadTransformPerfTest::scene();
+    Director::getInstance()->replaceScene(scene);
+}
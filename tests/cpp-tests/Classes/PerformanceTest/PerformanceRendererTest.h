@@ -24,5 +24,33 @@ public:
     static Scene* scene();
 };
 
+// Measures how many quads per millisecond can be moved into world coordinates,
+// using the same per-command copy + transform that Renderer does before uploading a batch
+class RendererQuadTransformPerfTest : public PerformBasicLayer
+{
+public:
+    static const int QUADS_PER_COMMAND = 1;
+
+    RendererQuadTransformPerfTest();
+    virtual ~RendererQuadTransformPerfTest();
+
+    virtual void onEnter() override;
+    virtual void showCurrentTest() override;
+    virtual void update(float dt) override;
+
+    static Scene* scene();
+
+protected:
+    void updateQuantityLabel();
+
+    std::vector<V3F_C4B_T2F_Quad> _srcQuads;
+    std::vector<V3F_C4B_T2F_Quad> _dstQuads;
+    std::vector<Mat4> _modelViews;
+    ThreadPool* _pool;
+    Label* _quantityLabel;
+    Label* _resultLabel;
+};
+
 void runRendererTest();
+void runRendererQuadTransformTest();
 #endif
@@ -1,8 +1,16 @@
 #include "PerformanceTextureTest.h"
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontAtlasCache.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#include <unistd.h>
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+#include <mach/mach.h>
+#endif
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 6,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +40,21 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         scene = TextureTest::scene();
         break;
+    case 1:
+        scene = TextureAsyncPreloadTest::scene();
+        break;
+    case 2:
+        scene = TextureProgressiveUploadTest::scene();
+        break;
+    case 3:
+        scene = TexturePixelConversionTest::scene();
+        break;
+    case 4:
+        scene = TextureTranscodeTest::scene();
+        break;
+    case 5:
+        scene = TextureFileMappingTest::scene();
+        break;
     }
     s_nTexCurCase = _curCase;
 
@@ -355,6 +378,570 @@ Scene* TextureTest::scene()
     return scene;
 }
 
+////////////////////////////////////////////////////////
+//
+// TextureAsyncPreloadTest
+//
+////////////////////////////////////////////////////////
+void TextureAsyncPreloadTest::onEnter()
+{
+    for (int i = 1; i <= 14; ++i)
+    {
+        _files.push_back(StringUtils::format("Images/grossini_dance_%02d.png", i));
+    }
+    const char* images[] = {
+        "Images/HelloWorld.png", "Images/grossini.png", "Images/grossinis_sister1.png", "Images/grossinis_sister2.png",
+        "Images/background1.png", "Images/background2.png", "Images/background3.png", "Images/blocks.png",
+        "Images/texture512x512.png", "Images/texture1024x1024.png", "Images/texture2048x2048.png", "Images/atlastest.png",
+    };
+    for (auto image : images)
+    {
+        _files.push_back(image);
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    auto cache = Director::getInstance()->getTextureCache();
+    int defaultWorkerCount = cache->getAsyncWorkerCount();
+    MenuItemFont::setFontSize(24);
+    auto workers = MenuItemToggle::createWithCallback([=](Ref* sender) {
+        cache->setAsyncWorkerCount(static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0 ? defaultWorkerCount : 1);
+        performTests();
+    }, MenuItemFont::create(StringUtils::format("Decoding threads: %d", defaultWorkerCount)), MenuItemFont::create("Decoding threads: 1"), nullptr);
+    auto budget = MenuItemToggle::createWithCallback([=](Ref* sender) {
+        cache->setAsyncUploadBudget(0, static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0 ? 0.005f : 0);
+        performTests();
+    }, MenuItemFont::create("Upload budget: 5 ms per frame"), MenuItemFont::create("Upload budget: none"), nullptr);
+    auto menu = Menu::create(workers, budget, nullptr);
+    menu->alignItemsVertically();
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    TextureMenuLayer::onEnter();
+    scheduleUpdate();
+}
+
+void TextureAsyncPreloadTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (auto request : _requests)
+    {
+        cache->cancelImageAsync(request);
+    }
+    _requests.clear();
+    TextureMenuLayer::onExit();
+}
+
+void TextureAsyncPreloadTest::performTests()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (auto request : _requests)
+    {
+        cache->cancelImageAsync(request);
+    }
+    _requests.clear();
+    for (const auto& file : _files)
+    {
+        cache->removeTextureForKey(file);
+    }
+
+    _loading = true;
+    _loadedCount = 0;
+    _worstFrame = 0;
+    _resultLabel->setString("loading...");
+    gettimeofday(&_start, NULL);
+    for (const auto& file : _files)
+    {
+        _requests.push_back(cache->addImageAsync(file, CC_CALLBACK_1(TextureAsyncPreloadTest::loadingCallBack, this), 0));
+    }
+}
+
+void TextureAsyncPreloadTest::loadingCallBack(Texture2D* texture)
+{
+    ++_loadedCount;
+}
+
+void TextureAsyncPreloadTest::update(float dt)
+{
+    if (!_loading)
+        return;
+
+    _worstFrame = std::max(_worstFrame, dt);
+
+    // the callback isn't called for the images which failed, so the requests still pending are counted instead
+    if (Director::getInstance()->getTextureCache()->getAsyncRequestCount() > 0)
+        return;
+
+    _loading = false;
+    float total = calculateDeltaTime(&_start);
+    log("preloaded %d of %d textures in %f ms, worst frame %f ms", _loadedCount, (int)_files.size(), total * 1000, _worstFrame * 1000);
+    _resultLabel->setString(StringUtils::format("%d of %d textures: %.1f ms, worst frame: %.1f ms",
+                                                _loadedCount, (int)_files.size(), total * 1000, _worstFrame * 1000));
+}
+
+std::string TextureAsyncPreloadTest::title() const
+{
+    return "Texture Async Preload Test";
+}
+
+std::string TextureAsyncPreloadTest::subtitle() const
+{
+    return "Total time and worst frame while preloading. See console";
+}
+
+Scene* TextureAsyncPreloadTest::scene()
+{
+    auto scene = Scene::create();
+    TextureAsyncPreloadTest *layer = new TextureAsyncPreloadTest(false, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureProgressiveUploadTest
+//
+////////////////////////////////////////////////////////
+static const float kUploadSliceSeconds = 0.002f;
+
+void TextureProgressiveUploadTest::onEnter()
+{
+    _image = new Image();
+    _image->initWithImageFile("Images/texture2048x2048.png");
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 24);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    MenuItemFont::setFontSize(24);
+    auto mode = MenuItemToggle::createWithCallback([=](Ref* sender) {
+        _progressive = static_cast<MenuItemToggle*>(sender)->getSelectedIndex() == 0;
+        performTests();
+    }, MenuItemFont::create("Upload: 2 ms per frame"), MenuItemFont::create("Upload: at once"), nullptr);
+    auto menu = Menu::create(mode, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(menu, 1);
+
+    TextureMenuLayer::onEnter();
+    scheduleUpdate();
+}
+
+void TextureProgressiveUploadTest::onExit()
+{
+    CC_SAFE_RELEASE_NULL(_texture);
+    CC_SAFE_RELEASE_NULL(_image);
+    TextureMenuLayer::onExit();
+}
+
+void TextureProgressiveUploadTest::performTests()
+{
+    CC_SAFE_RELEASE_NULL(_texture);
+    _frames = 0;
+    _strips = 0;
+    _maxStrips = 0;
+    _maxStall = 0;
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    _texture = new Texture2D();
+    if (_progressive)
+    {
+        _texture->initWithImageProgressively(_image);
+        _maxStall = calculateDeltaTime(&now);
+        _resultLabel->setString("uploading...");
+    }
+    else
+    {
+        _texture->initWithImage(_image);
+        _maxStall = calculateDeltaTime(&now);
+        showResult();
+    }
+}
+
+void TextureProgressiveUploadTest::update(float dt)
+{
+    if (_texture == nullptr || _texture->isReady())
+        return;
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int strips = _texture->uploadProgressively(kUploadSliceSeconds);
+    _maxStall = std::max(_maxStall, calculateDeltaTime(&now));
+    _strips += strips;
+    _maxStrips = std::max(_maxStrips, strips);
+    ++_frames;
+
+    if (_texture->isReady())
+    {
+        showResult();
+    }
+}
+
+void TextureProgressiveUploadTest::showResult()
+{
+    if (_progressive)
+    {
+        log("uploaded 2048x2048 progressively in %d frames, %.1f strips per frame (max %d), max stall %f ms",
+            _frames, (float)_strips / std::max(1, _frames), _maxStrips, _maxStall * 1000);
+        _resultLabel->setString(StringUtils::format("%d frames, %.1f strips per frame (max %d), max stall: %.2f ms",
+            _frames, (float)_strips / std::max(1, _frames), _maxStrips, _maxStall * 1000));
+    }
+    else
+    {
+        log("uploaded 2048x2048 at once, stall %f ms", _maxStall * 1000);
+        _resultLabel->setString(StringUtils::format("1 frame, stall: %.2f ms", _maxStall * 1000));
+    }
+}
+
+std::string TextureProgressiveUploadTest::title() const
+{
+    return "Texture Progressive Upload Test";
+}
+
+std::string TextureProgressiveUploadTest::subtitle() const
+{
+    return "Strips per frame and max stall uploading 2048x2048. See console";
+}
+
+Scene* TextureProgressiveUploadTest::scene()
+{
+    auto scene = Scene::create();
+    TextureProgressiveUploadTest *layer = new TextureProgressiveUploadTest(false, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TexturePixelConversionTest
+//
+////////////////////////////////////////////////////////
+void TexturePixelConversionTest::performTests()
+{
+    const int width = 1024;
+    const int height = 1024;
+    const ssize_t dataLen = width * height * 4;
+    std::vector<unsigned char> pixels(dataLen);
+    for (auto& byte : pixels)
+    {
+        byte = static_cast<unsigned char>(rand());
+    }
+    std::vector<unsigned char> outData(dataLen / 2);
+
+    struct Conversion
+    {
+        const char* name;
+        std::function<void()> run;
+    };
+    std::vector<Conversion> conversions = {
+        { "RGBA4444", [&]() { PixelConversion::convertRGBA8888ToRGBA4444(pixels.data(), dataLen, outData.data(), width); } },
+        { "RGB565", [&]() { PixelConversion::convertRGBA8888ToRGB565(pixels.data(), dataLen, outData.data(), width); } },
+        { "RGB5A1", [&]() { PixelConversion::convertRGBA8888ToRGB5A1(pixels.data(), dataLen, outData.data(), width); } },
+        { "AI88", [&]() { PixelConversion::convertRGBA8888ToAI88(pixels.data(), dataLen, outData.data()); } },
+        { "premultiply", [&]() { PixelConversion::premultiplyAlpha(pixels.data(), dataLen); } },
+    };
+    const PixelConversion::Implementation implementations[] = {
+        PixelConversion::Implementation::SCALAR, PixelConversion::Implementation::SSE2, PixelConversion::Implementation::NEON,
+    };
+
+    auto defaultImplementation = PixelConversion::getImplementation();
+    bool defaultDithering = PixelConversion::isDitheringEnabled();
+
+    // megapixels per second, for each conversion from RGBA8888, by implementation
+    std::string table = "from RGBA8888, MP/s";
+    for (auto implementation : implementations)
+    {
+        if (PixelConversion::isImplementationSupported(implementation))
+        {
+            table += StringUtils::format("  %10s", PixelConversion::getImplementationName(implementation));
+        }
+    }
+    for (int dithering = 0; dithering < 2; ++dithering)
+    {
+        PixelConversion::setDitheringEnabled(dithering != 0);
+        for (const auto& conversion : conversions)
+        {
+            if (dithering && (conversion.name == std::string("AI88") || conversion.name == std::string("premultiply")))
+                continue;
+
+            table += StringUtils::format("\n%-11s%s", conversion.name, dithering ? " dithered" : "         ");
+            for (auto implementation : implementations)
+            {
+                if (!PixelConversion::isImplementationSupported(implementation))
+                    continue;
+
+                PixelConversion::setImplementation(implementation);
+                const int loops = 10;
+                struct timeval start;
+                gettimeofday(&start, NULL);
+                for (int i = 0; i < loops; ++i)
+                {
+                    conversion.run();
+                }
+                float seconds = calculateDeltaTime(&start);
+                table += StringUtils::format("  %10.1f", width * height * loops / 1000000.0f / std::max(seconds, 0.000001f));
+            }
+        }
+    }
+
+    PixelConversion::setImplementation(defaultImplementation);
+    PixelConversion::setDitheringEnabled(defaultDithering);
+
+    log("%s", table.c_str());
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithSystemFont(table, "Courier", 14);
+    label->setPosition(Vec2(s.width/2, s.height/2 - 20));
+    addChild(label, 1);
+}
+
+std::string TexturePixelConversionTest::title() const
+{
+    return "Texture Pixel Conversion Test";
+}
+
+std::string TexturePixelConversionTest::subtitle() const
+{
+    return "Megapixels per second of a 1024x1024 image. See console";
+}
+
+Scene* TexturePixelConversionTest::scene()
+{
+    auto scene = Scene::create();
+    TexturePixelConversionTest *layer = new TexturePixelConversionTest(false, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureTranscodeTest
+//
+////////////////////////////////////////////////////////
+float TextureTranscodeTest::loadTextures(const std::vector<std::string>& files)
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    for (const auto& file : files)
+    {
+        cache->removeTextureForKey(file);
+    }
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (const auto& file : files)
+    {
+        cache->addImage(file);
+    }
+    return calculateDeltaTime(&start);
+}
+
+void TextureTranscodeTest::performTests()
+{
+    const std::vector<std::string> files = {
+        "Images/background1.png", "Images/background2.png", "Images/background3.png", "Images/blocks.png",
+        "Images/texture512x512.png", "Images/texture1024x1024.png", "Images/texture2048x2048.png", "Images/atlastest.png",
+    };
+
+    auto transcoder = Director::getInstance()->getTextureCache()->getTranscoder();
+    bool enabled = transcoder->isEnabled();
+
+    // decoding the images every time
+    transcoder->setEnabled(false);
+    float decoded = loadTextures(files);
+
+    // first launch: decoding and transcoding them
+    transcoder->setEnabled(true);
+    for (const auto& file : files)
+    {
+        transcoder->removeTranscodedFiles(FileUtils::getInstance()->fullPathForFilename(file));
+    }
+    transcoder->resetStatistics();
+    float cold = loadTextures(files);
+    auto coldStatistics = transcoder->getStatistics();
+
+    // next launches: loading the transcoded files
+    transcoder->resetStatistics();
+    float warm = loadTextures(files);
+    auto warmStatistics = transcoder->getStatistics();
+
+    transcoder->setEnabled(enabled);
+
+    std::string result = StringUtils::format("%d images\ndecoded: %.1f ms\ncold start: %.1f ms, %u transcoded\nwarm start: %.1f ms, %u from the cache",
+        (int)files.size(), decoded * 1000, cold * 1000, coldStatistics.transcoded, warm * 1000, warmStatistics.hits);
+    log("%s", result.c_str());
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(result, "fonts/arial.ttf", 24);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label, 1);
+}
+
+std::string TextureTranscodeTest::title() const
+{
+    return "Texture Transcode Test";
+}
+
+std::string TextureTranscodeTest::subtitle() const
+{
+    return "Cold and warm start loading, with transcoded files. See console";
+}
+
+Scene* TextureTranscodeTest::scene()
+{
+    auto scene = Scene::create();
+    TextureTranscodeTest *layer = new TextureTranscodeTest(false, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureFileMappingTest
+//
+////////////////////////////////////////////////////////
+
+// resident set size of the process in bytes, or -1 when the platform doesn't report it
+static long getResidentSize()
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    long pages = 0;
+    long resident = 0;
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp == nullptr)
+        return -1;
+    int count = fscanf(fp, "%ld %ld", &pages, &resident);
+    fclose(fp);
+    return count == 2 ? resident * sysconf(_SC_PAGESIZE) : -1;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return -1;
+    return (long)info.resident_size;
+#else
+    return -1;
+#endif
+}
+
+static const std::vector<std::string> s_levelSpriteSheets = {
+    "animations/grossini.plist", "animations/grossini_gray.plist", "animations/grossini_blue.plist",
+    "animations/grossini_family.plist", "animations/ghosts.plist",
+};
+
+static const std::vector<std::string> s_levelFonts = {
+    "fonts/tahoma.ttf", "fonts/Courier New.ttf", "fonts/Thonburi.ttf", "fonts/ThonburiBold.ttf", "fonts/Marker Felt.ttf",
+};
+
+float TextureFileMappingTest::loadLevel(bool mapped, long* peakGrowth)
+{
+    FileUtils::getInstance()->setFileMappingEnabled(mapped);
+
+    long base = getResidentSize();
+    long peak = base;
+    std::u16string text;
+    StringUtils::UTF8ToUTF16("Level 1 - Score: 0123456789 Lives: 3", text);
+    std::vector<FontAtlas*> atlases;
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (const auto& plist : s_levelSpriteSheets)
+    {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(plist);
+        peak = std::max(peak, getResidentSize());
+    }
+    for (const auto& font : s_levelFonts)
+    {
+        auto atlas = FontAtlasCache::getFontAtlasTTF(TTFConfig(font.c_str(), 32));
+        if (atlas)
+        {
+            atlas->prepareLetterDefinitions(text);
+            atlases.push_back(atlas);
+        }
+        peak = std::max(peak, getResidentSize());
+    }
+    float seconds = calculateDeltaTime(&start);
+
+    *peakGrowth = base < 0 ? -1 : peak - base;
+
+    // unload the level, so the next load reads the files again
+    for (auto atlas : atlases)
+    {
+        FontAtlasCache::releaseFontAtlas(atlas);
+    }
+    for (const auto& plist : s_levelSpriteSheets)
+    {
+        SpriteFrameCache::getInstance()->removeSpriteFramesFromFile(plist);
+    }
+    Director::getInstance()->getTextureCache()->removeUnusedTextures();
+
+    return seconds;
+}
+
+void TextureFileMappingTest::performTests()
+{
+    bool enabled = FileUtils::getInstance()->isFileMappingEnabled();
+
+    // the mapped load runs first, so the copying load can't be charged for heap the mapped one left behind
+    long mappedGrowth = 0;
+    float mapped = loadLevel(true, &mappedGrowth);
+    long readGrowth = 0;
+    float read = loadLevel(false, &readGrowth);
+
+    FileUtils::getInstance()->setFileMappingEnabled(enabled);
+
+    std::string result;
+    if (mappedGrowth < 0 || readGrowth < 0)
+    {
+        result = StringUtils::format("%d sprite sheets, %d fonts\nmapped: %.1f ms\nread: %.1f ms\npeak RSS: n/a on this platform",
+            (int)s_levelSpriteSheets.size(), (int)s_levelFonts.size(), mapped * 1000, read * 1000);
+    }
+    else
+    {
+        result = StringUtils::format("%d sprite sheets, %d fonts\nmapped: %.1f ms, peak RSS +%ld KB\nread: %.1f ms, peak RSS +%ld KB",
+            (int)s_levelSpriteSheets.size(), (int)s_levelFonts.size(), mapped * 1000, mappedGrowth / 1024, read * 1000, readGrowth / 1024);
+    }
+    log("%s", result.c_str());
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(result, "fonts/arial.ttf", 24);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label, 1);
+}
+
+std::string TextureFileMappingTest::title() const
+{
+    return "Texture File Mapping Test";
+}
+
+std::string TextureFileMappingTest::subtitle() const
+{
+    return "Level load time and peak RSS, mapped vs read files. See console";
+}
+
+Scene* TextureFileMappingTest::scene()
+{
+    auto scene = Scene::create();
+    TextureFileMappingTest *layer = new TextureFileMappingTest(false, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
 void runTextureTest()
 {
     s_nTexCurCase = 0;
@@ -35,6 +35,128 @@ public:
     static Scene* scene();
 };
 
+class TextureAsyncPreloadTest : public TextureMenuLayer
+{
+public:
+    TextureAsyncPreloadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+        , _loading(false)
+        , _loadedCount(0)
+        , _worstFrame(0)
+        , _resultLabel(nullptr)
+    {
+    }
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+    static Scene* scene();
+
+private:
+    void loadingCallBack(Texture2D* texture);
+
+    std::vector<std::string> _files;
+    std::vector<unsigned int> _requests;
+    bool _loading;
+    int _loadedCount;
+    float _worstFrame;
+    struct timeval _start;
+    Label* _resultLabel;
+};
+
+class TextureProgressiveUploadTest : public TextureMenuLayer
+{
+public:
+    TextureProgressiveUploadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+        , _image(nullptr)
+        , _texture(nullptr)
+        , _progressive(true)
+        , _frames(0)
+        , _strips(0)
+        , _maxStrips(0)
+        , _maxStall(0)
+        , _resultLabel(nullptr)
+    {
+    }
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+    static Scene* scene();
+
+private:
+    void showResult();
+
+    Image* _image;
+    Texture2D* _texture;
+    bool _progressive;
+    int _frames;
+    int _strips;
+    int _maxStrips;
+    float _maxStall;
+    Label* _resultLabel;
+};
+
+class TexturePixelConversionTest : public TextureMenuLayer
+{
+public:
+    TexturePixelConversionTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+};
+
+class TextureTranscodeTest : public TextureMenuLayer
+{
+public:
+    TextureTranscodeTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+
+private:
+    float loadTextures(const std::vector<std::string>& files);
+};
+
+class TextureFileMappingTest : public TextureMenuLayer
+{
+public:
+    TextureFileMappingTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+
+private:
+    float loadLevel(bool mapped, long* peakGrowth);
+};
+
 void runTextureTest();
 
 #endif
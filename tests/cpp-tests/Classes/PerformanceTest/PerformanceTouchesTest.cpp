@@ -1,5 +1,7 @@
 #include "PerformanceTouchesTest.h"
 
+#include <chrono>
+
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
@@ -29,43 +31,51 @@
 
 enum
 {
-    TEST_COUNT = 3,
+    TEST_COUNT = 4,
 };
 
 static int s_nTouchCurCase = 0;
 
-////////////////////////////////////////////////////////
-//
-// TouchesMainScene
-//
-////////////////////////////////////////////////////////
-void TouchesMainScene::showCurrentTest()
+static void showTouchesTest(int curCase)
 {
     Layer* layer = NULL;
-    switch (_curCase)
+    switch (curCase)
     {
-    case 0:
-        layer = new TouchesPerformTest1(true, TEST_COUNT, _curCase);
-        break;
-    case 1:
-        layer = new TouchesPerformTest2(true, TEST_COUNT, _curCase);
-        break;
-    case 2:
-        layer = new TouchesPerformTest3(true, TEST_COUNT, _curCase);
-        break;
+        case 0:
+            layer = new TouchesPerformTest1(true, TEST_COUNT, curCase);
+            break;
+        case 1:
+            layer = new TouchesPerformTest2(true, TEST_COUNT, curCase);
+            break;
+        case 2:
+            layer = new TouchesPerformTest3(true, TEST_COUNT, curCase);
+            break;
+        case 3:
+            layer = new TouchesPerformTest4(true, TEST_COUNT, curCase);
+            break;
     }
-    s_nTouchCurCase = _curCase;
-
+    s_nTouchCurCase = curCase;
+    
     if (layer)
     {
         auto scene = Scene::create();
         scene->addChild(layer);
         layer->release();
-
+        
         Director::getInstance()->replaceScene(scene);
     }
 }
 
+////////////////////////////////////////////////////////
+//
+// TouchesMainScene
+//
+////////////////////////////////////////////////////////
+void TouchesMainScene::showCurrentTest()
+{
+    showTouchesTest(_curCase);
+}
+
 void TouchesMainScene::onEnter()
 {
     PerformBasicLayer::onEnter();
@@ -294,29 +304,121 @@ std::string TouchesPerformTest3::title() const
 
 void TouchesPerformTest3::showCurrentTest()
 {
-    Layer* layer = NULL;
-    switch (_curCase)
-    {
-        case 0:
-            layer = new TouchesPerformTest1(true, TEST_COUNT, _curCase);
-            break;
-        case 1:
-            layer = new TouchesPerformTest2(true, TEST_COUNT, _curCase);
-            break;
-        case 2:
-            layer = new TouchesPerformTest3(true, TEST_COUNT, _curCase);
-            break;
-    }
-    s_nTouchCurCase = _curCase;
+    showTouchesTest(_curCase);
+}
+
+////////////////////////////////////////////////////////
+//
+// TouchesPerformTest4
+//
+////////////////////////////////////////////////////////
+
+#define INDEXED_TOUCH_PROFILER_NAME  "IndexedTouchProfileName"
+#define INDEXED_TOUCHABLE_NODE_NUM 2000
+
+void TouchesPerformTest4::onEnter()
+{
+    PerformBasicLayer::onEnter();
     
-    if (layer)
+    auto s = Director::getInstance()->getWinSize();
+    
+    // add title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+    
+    // A grid of small touchable nodes, like the buttons of a big UI screen.
+    // Like ui::Widget, each listener tests the touch against the content rect of its node.
+    int columns = 50;
+    int rows = INDEXED_TOUCHABLE_NODE_NUM / columns;
+    Size nodeSize(s.width / columns, s.height / rows);
+    
+    for (int i = 0; i < INDEXED_TOUCHABLE_NODE_NUM; ++i)
     {
-        auto scene = Scene::create();
-        scene->addChild(layer);
-        layer->release();
+        auto node = Node::create();
+        node->setContentSize(nodeSize);
+        node->setPosition(Vec2((i % columns) * nodeSize.width, (i / columns) * nodeSize.height));
         
-        Director::getInstance()->replaceScene(scene);
+        auto listener = EventListenerTouchOneByOne::create();
+        listener->setContentHitTest(true);
+        listener->onTouchBegan = [node](Touch* touch, Event* event){
+            Rect rect(0, 0, node->getContentSize().width, node->getContentSize().height);
+            return rect.containsPoint(node->convertToNodeSpace(touch->getLocation()));
+        };
+        _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, node);
+        
+        addChild(node, rand() % INDEXED_TOUCHABLE_NODE_NUM);
     }
+    
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2-100));
+    addChild(_resultLabel, 1);
+    
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([this](Ref* sender){
+        auto toggle = static_cast<MenuItemToggle*>(sender);
+        _eventDispatcher->setTouchIndexEnabled(toggle->getSelectedIndex() == 1);
+        _resultLabel->setString("");
+    }, MenuItemFont::create("Touch index: off"), MenuItemFont::create("Touch index: on"), NULL);
+    toggle->setPosition(Vec2(0, 20));
+    
+    auto emitEventlabel = Label::createWithSystemFont("Emit Touch Event", "", 24);
+    auto menuItem = MenuItemLabel::create(emitEventlabel, [this](Ref* sender){
+        
+        CC_PROFILER_PURGE_ALL();
+        
+        auto s = Director::getInstance()->getWinSize();
+        Touch* touch = new Touch();
+        std::vector<Touch*> touches;
+        touches.push_back(touch);
+        
+        EventTouch event;
+        event.setTouches(touches);
+        
+        const int count = 100;
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            touch->setTouchInfo(0, CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height);
+            
+            CC_PROFILER_START(INDEXED_TOUCH_PROFILER_NAME);
+            
+            event.setEventCode(EventTouch::EventCode::BEGAN);
+            _eventDispatcher->dispatchEvent(&event);
+            event.setEventCode(EventTouch::EventCode::ENDED);
+            _eventDispatcher->dispatchEvent(&event);
+            
+            CC_PROFILER_STOP(INDEXED_TOUCH_PROFILER_NAME);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        CC_PROFILER_DISPLAY_TIMERS();
+        
+        touch->release();
+        
+        float usPerTouch = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / (float)count;
+        _resultLabel->setString(StringUtils::format("%d listeners: %.1f us per touch", INDEXED_TOUCHABLE_NODE_NUM, usPerTouch));
+    });
+    menuItem->setPosition(Vec2(0, -20));
+    
+    auto menu = Menu::create(toggle, menuItem, NULL);
+    addChild(menu, 1);
+}
+
+void TouchesPerformTest4::onExit()
+{
+    _eventDispatcher->setTouchIndexEnabled(false);
+    PerformBasicLayer::onExit();
+}
+
+std::string TouchesPerformTest4::title() const
+{
+    return "Indexed Touch Perf Test";
+}
+
+void TouchesPerformTest4::showCurrentTest()
+{
+    showTouchesTest(_curCase);
 }
 
 void runTouchesTest()
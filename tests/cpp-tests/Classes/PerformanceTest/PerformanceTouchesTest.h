@@ -73,6 +73,23 @@ public:
     virtual void showCurrentTest() override;
 };
 
+class TouchesPerformTest4 : public PerformBasicLayer
+{
+public:
+    TouchesPerformTest4(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+    : PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual void showCurrentTest() override;
+    
+protected:
+    Label* _resultLabel;
+};
+
 void runTouchesTest();
 
 #endif
@@ -1,4 +1,5 @@
 #include "ReleasePoolTest.h"
+#include <chrono>
 
 using namespace cocos2d;
 
@@ -22,6 +23,29 @@ private:
     std::string _name;
 };
 
+class FrameTestObject : public TestObject
+{
+public:
+    CC_FRAME_ALLOCATED
+};
+
+template <typename T>
+float ReleasePoolTestScene::measureClear(int count)
+{
+    AutoreleasePool pool;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        T *tmpObj = new (std::nothrow) T();
+        tmpObj->autorelease();
+    }
+    pool.clear();
+    // as the frame pool does: the other pools don't make the blocks of the arena available again
+    RefArena::getInstance()->collect();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+}
+
 void ReleasePoolTestScene::runThisTest()
 {
     // title
@@ -76,5 +100,43 @@ void ReleasePoolTestScene::runThisTest()
     
     // object in pool2 should be released
     
+    // statistics of the last clear
+    {
+        AutoreleasePool pool3;
+        pool3.setTypeStatisticsEnabled(true);
+        for (int i = 0; i < 10; ++i)
+        {
+            TestObject *tmpObj = new TestObject();
+            tmpObj->autorelease();
+        }
+        obj->retain();
+        obj->autorelease();
+        pool3.clear();
+        
+        const AutoreleasePool::Statistics& statistics = pool3.getStatistics();
+        assert(statistics.autoreleasedObjects == 11);
+        assert(statistics.destroyedObjects == 10);
+        assert(statistics.types.size() == 1);
+        CC_UNUSED_PARAM(statistics);
+    }
+    
+    // clearing 20k objects, allocated by malloc or in the arena of the frame. They fit in the 2 MB of free blocks
+    // the arena keeps, so the measured run reuses the blocks of the first one
+    const int count = 20000;
+    auto arena = RefArena::getInstance();
+    bool arenaEnabled = arena->isEnabled();
+    arena->setEnabled(true);
+    measureClear<FrameTestObject>(count);
+    float mallocTime = measureClear<TestObject>(count);
+    float arenaTime = measureClear<FrameTestObject>(count);
+    arena->setEnabled(arenaEnabled);
+    CCLOG("AutoreleasePool: %d objects, malloc: %.2f ms, arena: %.2f ms", count, mallocTime, arenaTime);
+    
+    char result[100];
+    snprintf(result, sizeof(result), "%d objects\nmalloc: %.2f ms\narena: %.2f ms", count, mallocTime, arenaTime);
+    auto resultLabel = Label::createWithTTF(result, "fonts/arial.ttf", 24);
+    addChild(resultLabel, 9999);
+    resultLabel->setPosition(VisibleRect::center());
+    
     Director::getInstance()->replaceScene(this);
 }
@@ -12,7 +12,9 @@ public:
     virtual void runThisTest();
     
 private:
-    
+    // milliseconds spent creating, autoreleasing and clearing objects
+    template <typename T>
+    float measureClear(int count);
 };
 
 #endif // __RELEASE_POOL_TEST_H__